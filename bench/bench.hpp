@@ -0,0 +1,59 @@
+/// shared helpers for the benchmarks
+/** \file
+ * Contains a tiny timing helper used by all benchmark executables.
+ * The benchmarks don't use a framework on purpose, they are plain executables printing a table.
+ */
+#ifndef __BENCH_HPP_INCLUDED__
+#define __BENCH_HPP_INCLUDED__
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+
+/**
+ * Runs the given function `repetitions` times and returns the fastest run in milliseconds.
+ * The fastest run is used (instead of the mean) to filter out noise caused by the scheduler.
+ * @param repetitions how often the function is invoked
+ * @param fn the function to measure
+ * @return duration of the fastest run in ms
+ */
+template <typename F>
+double measureMs(int repetitions, F fn) {
+    double best = -1;
+    for (int i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+        if (best < 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/**
+ * Prints one line of the result table.
+ * @param name name of the measured operation
+ * @param size description of the board size
+ * @param ms measured duration in ms
+ */
+inline void report(const std::string& name, const std::string& size, double ms) {
+    std::cout << std::left << std::setw(40) << name
+              << std::setw(14) << size
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3) << ms << " ms" << std::endl;
+}
+
+/**
+ * Prevents the compiler from optimizing away a computed value.
+ * The empty asm statement claims to read the value (and all memory), so it has to be computed.
+ * @param value the value to keep alive
+ */
+template <typename T>
+void keepAlive(const T& value) {
+    asm volatile("" : : "g"(value) : "memory");
+}
+
+#endif // __BENCH_HPP_INCLUDED__
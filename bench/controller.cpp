@@ -0,0 +1,25 @@
+/// Controller benchmark
+/** \file
+ * Measures the cost of querying the minefield through the controller.
+ */
+#include "bench.hpp"
+
+#include "controller.hpp"
+
+#include <string>
+
+int main() {
+    for (int size : {100, 1000, 3000}) {
+        Controller controller(size, size, (size * size) / 10, 0);
+        int repetitions = 100;
+
+        report("100x getMinefield().getOpenCount()", std::to_string(size) + "x" + std::to_string(size), measureMs(3, [&]() {
+            int cnt = 0;
+            for (int i = 0; i < repetitions; i++) {
+                cnt += controller.getMinefield().getOpenCount();
+            }
+            keepAlive(cnt);
+        }));
+    }
+    return 0;
+}
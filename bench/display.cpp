@@ -0,0 +1,49 @@
+/// Display benchmark
+/** \file
+ * Measures the time to render one frame after the game has ended, for growing boards.
+ * The time for a frame is the difference between two runs w/ different amounts of keypresses,
+ * so the setup of the display is not included.
+ */
+#include "bench.hpp"
+
+#include "display.hpp"
+#include "iodevice_simulation.hpp"
+
+#include <memory>
+#include <string>
+
+/**
+ * Starts a display, loses the game and presses the given amount of movement keys afterwards.
+ * Every keypress renders one frame.
+ * @param size width and height of the board
+ * @param frames amount of frames to render after the game has been lost
+ */
+void playLostGame(int size, int frames) {
+    IODeviceSimulation io;
+    io.setDim(2 * size + 10, size + 10);
+
+    // board almost full of mines: first click is always safe, the field to the right is (almost certainly) a mine
+    io.addChars(" l ");
+    for (int i = 0; i < frames; i++) {
+        io.addChars(i % 2 ? "h" : "l");
+    }
+    io.addChars("q");
+
+    std::shared_ptr<IODevice> io_ptr = std::make_shared<IODeviceSimulation>(io);
+    Display display(io_ptr, size, size, size * size - 2, 0, false);
+    if (! display.getController().getMinefield().isGameLost()) {
+        throw std::runtime_error("game should have been lost");
+    }
+}
+
+int main() {
+    int frames = 20;
+    for (int size : {10, 20, 40, 80, 160}) {
+        double few = measureMs(3, [&]() { playLostGame(size, frames); });
+        double many = measureMs(3, [&]() { playLostGame(size, 2 * frames); });
+        double frame = (many - few) / frames;
+        report("frame after game end", std::to_string(size) + "x" + std::to_string(size), frame);
+        report("frame after game end, per 1000 fields", std::to_string(size) + "x" + std::to_string(size), frame * 1000 / (size * size));
+    }
+    return 0;
+}
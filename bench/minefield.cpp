@@ -0,0 +1,457 @@
+/// Minefield storage benchmark
+/** \file
+ * Measures construction and cell queries on large boards.
+ */
+#include "bench.hpp"
+
+#include "minefield.hpp"
+#include "neighbour_count.hpp"
+
+#include <string>
+#include <vector>
+#include <exception>
+#include <tuple>
+
+void benchSize(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = (width * height * 16) / 100;
+
+    report("construct (16% mines)", size, measureMs(3, [&]() {
+        Minefield mfield(width, height, mine_count, 0);
+        keepAlive(mfield.getMineCount());
+    }));
+
+    Minefield mfield(width, height, mine_count, 0);
+
+    report("isOpen + isFlagged, row by row", size, measureMs(5, [&]() {
+        int cnt = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                cnt += mfield.isOpen(x, y) + mfield.isFlagged(x, y);
+            }
+        }
+        keepAlive(cnt);
+    }));
+
+    report("isOpen + isFlagged, column by column", size, measureMs(5, [&]() {
+        int cnt = 0;
+        for (int x = 0; x < width; x++) {
+            for (int y = 0; y < height; y++) {
+                cnt += mfield.isOpen(x, y) + mfield.isFlagged(x, y);
+            }
+        }
+        keepAlive(cnt);
+    }));
+
+    report("flag + unflag every cell", size, measureMs(3, [&]() {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                mfield.flag(x, y);
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                mfield.unflag(x, y);
+            }
+        }
+    }));
+
+    // open two cells: first one can never be a mine, keep opening until a mine is hit
+    // -> game lost, isMine() can be used on every cell
+    for (int i = 0; mfield.isGameRunning(); i++) {
+        mfield.open(i % width, i / width, false);
+    }
+
+    report("isMine after game end", size, measureMs(5, [&]() {
+        int cnt = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                cnt += mfield.isMine(x, y);
+            }
+        }
+        keepAlive(cnt);
+    }));
+
+    report("getSorroundingMineCount after game end", size, measureMs(5, [&]() {
+        int cnt = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                cnt += mfield.getSorroundingMineCount(x, y);
+            }
+        }
+        keepAlive(cnt);
+    }));
+}
+
+void benchFloodFill(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+
+    for (auto engine : {Minefield::ExpansionEngine::scanline, Minefield::ExpansionEngine::bitwise}) {
+        std::string name = (Minefield::ExpansionEngine::scanline == engine) ? "scanline" : "bitwise";
+
+        report("open empty field, " + name, size, measureMs(3, [&]() {
+            Minefield mfield(width, height, 0, 0);
+            mfield.setExpansionEngine(engine);
+            mfield.open(0, 0);
+            keepAlive(mfield.getOpenCount());
+        }));
+
+        report("open 1% density field, " + name, size, measureMs(3, [&]() {
+            Minefield mfield(width, height, (width * height) / 100, 0);
+            mfield.setExpansionEngine(engine);
+            mfield.open(width / 2, height / 2);
+            keepAlive(mfield.getOpenCount());
+        }));
+
+        // many small regions: the engine runs once per region
+        report("open 15% density field, " + name, size, measureMs(3, [&]() {
+            Minefield mfield(width, height, (width * height * 15) / 100, 0);
+            mfield.setExpansionEngine(engine);
+            for (int i = 0; mfield.isGameRunning() && i < width * height; i += 7) {
+                if (! mfield.isOpen(i % width, i / width)) {
+                    mfield.open(i % width, i / width);
+                }
+            }
+            keepAlive(mfield.getOpenCount());
+        }));
+    }
+}
+
+void benchDensity(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+
+    for (int percent : {1, 10, 25, 50, 75, 90}) {
+        int mine_count = static_cast<int>((static_cast<long long>(width) * height * percent) / 100);
+        report("generate (" + std::to_string(percent) + "% mines)", size, measureMs(3, [&]() {
+            Minefield mfield(width, height, mine_count, 0, Minefield::StorageMode::dense);
+            keepAlive(mfield.getMineCount());
+        }));
+    }
+}
+
+void benchTiled(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = static_cast<int>((static_cast<long long>(width) * height * 16) / 100);
+
+    report("generate dense (16% mines)", size, measureMs(3, [&]() {
+        Minefield mfield(width, height, mine_count, 0, Minefield::StorageMode::dense);
+        keepAlive(mfield.getMineCount());
+    }));
+
+    // same board for every amount of threads, 0 is one thread per core
+    for (int thread_count : {1, 2, 4, 8, 0}) {
+        report("generate tiled, " + std::to_string(thread_count) + " threads", size, measureMs(3, [&]() {
+            Minefield mfield = Minefield::createTiled(width, height, mine_count, 0, thread_count);
+            keepAlive(mfield.getMineCount());
+        }));
+    }
+}
+
+void benchNeighbourCount(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = static_cast<int>((static_cast<long long>(width) * height * 16) / 100);
+
+    // lose the game, so every field can be queried
+    Minefield mfield(width, height, mine_count, 0, Minefield::StorageMode::dense);
+    for (int i = 0; mfield.isGameRunning(); i++) {
+        mfield.open(i % width, i / width, false);
+    }
+
+    report("per-field getSorroundingMineCount()", size, measureMs(3, [&]() {
+        long long sum = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                sum += mfield.getSorroundingMineCount(x, y);
+            }
+        }
+        keepAlive(sum);
+    }));
+
+    // random mask (like the mine plane), packed
+    int words_per_row = (width + 63) / 64;
+    std::vector<std::uint64_t> mask(static_cast<std::size_t>(words_per_row) * height);
+    std::uint64_t state = 1;
+    for (auto& word : mask) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        word = state & (state >> 7);
+    }
+    std::vector<std::uint64_t> counts(mask.size() * 4);
+
+    report("neighbour count kernel, scalar", size, measureMs(3, [&]() {
+        countNeighbourPlanes(mask.data(), 1, counts.data(), 4, width, height, NeighbourKernel::scalar);
+        keepAlive(counts[0]);
+    }));
+
+    if (isNeighbourKernelAvailable(NeighbourKernel::avx2)) {
+        report("neighbour count kernel, avx2", size, measureMs(3, [&]() {
+            countNeighbourPlanes(mask.data(), 1, counts.data(), 4, width, height, NeighbourKernel::avx2);
+            keepAlive(counts[0]);
+        }));
+    }
+}
+
+void benchCopy(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    Minefield mfield(width, height, (width * height) / 10, 0, Minefield::StorageMode::dense);
+    mfield.open(width / 2, height / 2);
+
+    report("copy (shared until changed)", size, measureMs(3, [&]() {
+        Minefield copy = mfield;
+        keepAlive(copy.getOpenCount());
+    }));
+
+    report("copy and flag (detaches)", size, measureMs(3, [&]() {
+        Minefield copy = mfield;
+        copy.flag(0, 0);
+        keepAlive(copy.getFlagCount());
+    }));
+}
+
+void benchLateMoves(int moves) {
+    std::string size = std::to_string(moves) + " moves";
+
+    // a lost game: every move is rejected
+    Minefield mfield(30, 16, 99, 0);
+    for (int i = 0; mfield.isGameRunning(); i++) {
+        mfield.open(i % 30, i / 30, false);
+    }
+
+    report("late moves, throwing", size, measureMs(3, [&]() {
+        int rejected = 0;
+        for (int i = 0; i < moves; i++) {
+            try {
+                mfield.open(i % 30, (i / 30) % 16);
+            } catch (std::exception& e) {
+                rejected++;
+            }
+        }
+        keepAlive(rejected);
+    }));
+
+    report("late moves, tryOpen()", size, measureMs(3, [&]() {
+        int rejected = 0;
+        for (int i = 0; i < moves; i++) {
+            if (Minefield::MoveResult::game_over == mfield.tryOpen(i % 30, (i / 30) % 16)) {
+                rejected++;
+            }
+        }
+        keepAlive(rejected);
+    }));
+}
+
+void benchChord(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = (width * height * 15) / 100;
+
+    // flag every mine, so every chord passes the flag check
+    Minefield mfield(width, height, mine_count, 0);
+    mfield.setExpansionEngine(Minefield::ExpansionEngine::scanline);
+    mfield.open(width / 2, height / 2);
+    Minefield revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % width, i / width, false);
+    }
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            if (revealed.isMine(x, y)) {
+                mfield.flag(x, y);
+            }
+        }
+    }
+
+    // chords spread the open area over the whole board
+    report("chord every field", size, measureMs(3, [&]() {
+        Minefield played = mfield;
+        for (int pass = 0; pass < 4; pass++) {
+            for (int x = 0; x < width; x++) {
+                for (int y = 0; y < height; y++) {
+                    played.tryChord(x, y);
+                }
+            }
+        }
+        keepAlive(played.getOpenCount());
+    }));
+}
+
+void benchUndo(int width, int height) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = (width * height * 15) / 100;
+
+    // flags on the mines and opens on the other fields, all over the board (a lost copy tells where the mines are)
+    Minefield mfield(width, height, mine_count, 0);
+    mfield.open(width / 2, height / 2);
+    Minefield revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % width, i / width, false);
+    }
+    mfield.setUndoEnabled(true);
+    mfield.setChangeTrackingEnabled(true);
+    int moves = 0;
+    for (int i = 0; moves < 20000 && mfield.isGameRunning(); i++) {
+        int pos = static_cast<int>((static_cast<std::int64_t>(i) * 7919) % (static_cast<std::int64_t>(width) * height));
+        if (revealed.isMine(pos % width, pos / width)) {
+            mfield.tryFlag(pos % width, pos / width);
+        } else {
+            mfield.tryOpen(pos % width, pos / width);
+        }
+        moves++;
+    }
+
+    std::vector<std::tuple<int, int>> changed;
+    std::string journal = std::to_string(mfield.getUndoMemory() / 1024) + " KiB";
+    report("undo + redo " + std::to_string(moves) + " moves, " + journal, size, measureMs(3, [&]() {
+        while (mfield.undo()) {
+        }
+        while (mfield.redo()) {
+        }
+        mfield.drainChangedCells(changed);
+        keepAlive(mfield.getOpenCount());
+    }));
+}
+
+void benchBatch(int width, int height, int games) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    int mine_count = (width * height * 15) / 100;
+
+    // flag and open every field in a scrambled order, so many moves are rejected
+    std::vector<Minefield::Move> moves;
+    for (int i = 0; i < width * height; i++) {
+        int pos = (i * 7919) % (width * height);
+        moves.push_back({(0 == i % 3) ? Minefield::MoveType::flag : Minefield::MoveType::open, pos % width, pos / width});
+        moves.push_back({Minefield::MoveType::chord, pos % width, pos / width});
+    }
+
+    report("moves one by one (" + std::to_string(games) + " games)", size, measureMs(3, [&]() {
+        long long opened = 0;
+        for (int seed = 0; seed < games; seed++) {
+            Minefield mfield(width, height, mine_count, seed);
+            mfield.setChangeTrackingEnabled(true);
+            std::vector<std::tuple<int, int>> changed;
+            for (auto& move : moves) {
+                switch (move.type) {
+                    case Minefield::MoveType::open: mfield.tryOpen(move.x, move.y); break;
+                    case Minefield::MoveType::flag: mfield.tryFlag(move.x, move.y); break;
+                    case Minefield::MoveType::unflag: mfield.tryUnflag(move.x, move.y); break;
+                    case Minefield::MoveType::chord: mfield.tryChord(move.x, move.y); break;
+                }
+                mfield.drainChangedCells(changed);
+            }
+            opened += mfield.getOpenCount();
+        }
+        keepAlive(opened);
+    }));
+
+    report("moves batched (" + std::to_string(games) + " games)", size, measureMs(3, [&]() {
+        long long opened = 0;
+        std::vector<Minefield::MoveResult> results(moves.size());
+        std::vector<std::tuple<int, int>> changed;
+        for (int seed = 0; seed < games; seed++) {
+            Minefield mfield(width, height, mine_count, seed);
+            mfield.applyMoves(moves.data(), moves.size(), results.data(), changed);
+            opened += mfield.getOpenCount();
+        }
+        keepAlive(opened);
+    }));
+}
+
+/**
+ * Plays the given amount of games w/ a trivial bot: open the center, then open fields in a fixed scrambled order until the game ends.
+ * @param width width of the board
+ * @param height height of the board
+ * @param mine_count amount of mines
+ * @param games amount of games to play
+ * @param storage_mode storage of the minefields
+ * @return amount of opened fields, summed over all games
+ */
+int playBatch(int width, int height, int mine_count, int games, Minefield::StorageMode storage_mode) {
+    int opened = 0;
+    for (int seed = 0; seed < games; seed++) {
+        Minefield mfield(width, height, mine_count, seed, storage_mode);
+        mfield.open(width / 2, height / 2);
+        for (int i = 0; mfield.isGameRunning(); i++) {
+            int pos = (i * 7919) % (width * height);
+            if (! mfield.isOpen(pos % width, pos / width)) {
+                mfield.open(pos % width, pos / width);
+            }
+        }
+        opened += mfield.getOpenCount();
+    }
+    return opened;
+}
+
+void benchClassic(int width, int height, int mine_count, int games) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height) + "/" + std::to_string(mine_count);
+
+    report("bot batch, generic (" + std::to_string(games) + " games)", size, measureMs(3, [&]() {
+        keepAlive(playBatch(width, height, mine_count, games, Minefield::StorageMode::dense));
+    }));
+
+    report("bot batch, fixed (" + std::to_string(games) + " games)", size, measureMs(3, [&]() {
+        keepAlive(playBatch(width, height, mine_count, games, Minefield::StorageMode::fixed));
+    }));
+}
+
+void benchUnbounded(int steps) {
+    std::string size = std::to_string(steps) + " steps";
+
+    // walk to the right, opening every field (recursively) and flagging the one below
+    // until a mine is hit: restart on a new seed, the evicted chunks stay on disk
+    report("unbounded walk, chunk limit 256", size, measureMs(3, [&]() {
+        Minefield mfield = Minefield::createUnbounded(16, 0);
+        mfield.setChunkLimit(256);
+        int seed = 0;
+        int x = 0;
+        for (int i = 0; i < steps; i++, x++) {
+            if (! mfield.isGameRunning()) {
+                mfield = Minefield::createUnbounded(16, ++seed);
+                mfield.setChunkLimit(256);
+                x = 0;
+            }
+            if (! mfield.isOpen(x, 0)) {
+                mfield.open(x, 0);
+            }
+            if (mfield.isGameRunning() && ! mfield.isOpen(x, 1)) {
+                mfield.flag(x, 1);
+            }
+        }
+        keepAlive(mfield.getOpenCount());
+    }));
+}
+
+int main() {
+    benchSize(1000, 1000);
+    benchSize(5000, 5000);
+
+    benchFloodFill(16, 16);
+    benchFloodFill(32, 32);
+    benchFloodFill(64, 64);
+    benchFloodFill(100, 100);
+    benchFloodFill(200, 200);
+    benchFloodFill(1000, 1000);
+    benchFloodFill(3163, 3163);
+
+    benchDensity(1000, 1000);
+    benchDensity(4000, 4000);
+
+    // 50 million fields
+    benchTiled(7072, 7072);
+
+    benchNeighbourCount(1000, 1000);
+    benchNeighbourCount(5000, 5000);
+
+    benchCopy(1000, 1000);
+    benchCopy(5000, 5000);
+
+    benchLateMoves(100000);
+    benchChord(1000, 1000);
+    benchUndo(1000, 1000);
+    benchBatch(30, 16, 2000);
+    benchBatch(200, 200, 20);
+
+    benchClassic(9, 9, 10, 20000);
+    benchClassic(16, 16, 40, 20000);
+    benchClassic(30, 16, 99, 20000);
+
+    benchUnbounded(100000);
+    return 0;
+}
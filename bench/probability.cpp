@@ -0,0 +1,118 @@
+/// Probability engine benchmark
+/** \file
+ * Measures the exact probability engine on boards where the solver is stuck, w/ one thread and w/ one thread per core.
+ * Prints the time spent on the largest components, as they dominate the total.
+ * Also measures the monte carlo estimator w/ a few time budgets, and its mean error compared to the exact probabilities.
+ */
+#include "bench.hpp"
+
+#include "monte_carlo.hpp"
+#include "probability.hpp"
+#include "solver.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Opens fields until the solver is stuck: everything the solver finds, and a few known safe fields to get past guesses.
+ * @param width width of the board
+ * @param height height of the board
+ * @param density mine density in percent
+ * @param guesses amount of known safe fields opened when the solver is stuck
+ * @return minefield w/ a running game
+ */
+static Minefield playUntilStuck(int width, int height, int density, int guesses) {
+    Minefield mfield(width, height, (static_cast<std::int64_t>(width) * height * density) / 100, 0);
+    mfield.setChangeTrackingEnabled(true);
+    mfield.open(width / 2, height / 2);
+
+    // guesses are made w/ a lost copy
+    Minefield revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % width, i / width, false);
+    }
+
+    Solver solver;
+    std::vector<std::tuple<int, int>> changed, safe_fields;
+    mfield.drainChangedCells(changed);
+    solver.update(mfield, changed);
+    for (int guess = 0; mfield.isGameRunning(); ) {
+        solver.getSafeFields(safe_fields);
+        if (safe_fields.empty()) {
+            if (guesses <= guess) {
+                break;
+            }
+            int x, y;
+            do {
+                guess++;
+                std::int64_t pos = (static_cast<std::int64_t>(guess) * 7919) % (static_cast<std::int64_t>(width) * height);
+                x = static_cast<int>(pos % width);
+                y = static_cast<int>(pos / width);
+            } while (mfield.isOpen(x, y) || revealed.isMine(x, y));
+            mfield.open(x, y);
+        } else {
+            mfield.open(std::get<0>(safe_fields.front()), std::get<1>(safe_fields.front()));
+        }
+        mfield.drainChangedCells(changed);
+        solver.update(mfield, changed);
+    }
+    return mfield;
+}
+
+/**
+ * Measures the engine on a board where the solver is stuck.
+ * @param width width of the board
+ * @param height height of the board
+ * @param density mine density in percent
+ * @param guesses amount of known safe fields opened when the solver is stuck
+ */
+void benchProbabilities(int width, int height, int density, int guesses) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height) + "/" + std::to_string(density) + "%";
+    Minefield mfield = playUntilStuck(width, height, density, guesses);
+
+    ProbabilityEngine engine;
+    engine.setThreadCount(1);
+    double ms = measureMs(3, [&]() {
+        engine.calculate(mfield);
+        keepAlive(engine.getInteriorProbability());
+    });
+    auto stats = engine.getComponentStats();
+    report("calculate (1 thread, " + std::to_string(stats.size()) + " components)", size, ms);
+    for (std::size_t i = 0; i < stats.size() && i < 3; i++) {
+        report("  component " + std::to_string(i) + " (" + std::to_string(stats[i].field_count) + " fields)", size, stats[i].ms);
+    }
+
+    engine.setThreadCount(0);
+    report("calculate (1 thread per core)", size, measureMs(3, [&]() {
+        engine.calculate(mfield);
+        keepAlive(engine.getInteriorProbability());
+    }));
+
+    std::vector<std::tuple<int, int>> fields;
+    engine.getFrontier(fields);
+    for (double budget : {10.0, 100.0}) {
+        MonteCarloEstimator estimator;
+        estimator.setTimeBudget(budget);
+        double ms = measureMs(1, [&]() {
+            estimator.estimate(mfield);
+        });
+
+        double error = 0;
+        for (auto& field : fields) {
+            error += std::abs(estimator.getEstimate(std::get<0>(field), std::get<1>(field)).probability - engine.getProbability(std::get<0>(field), std::get<1>(field)));
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "estimate (%lld samples, err %.4f)", static_cast<long long>(estimator.getSampleCount()), error / fields.size());
+        report(name, size, ms);
+    }
+}
+
+int main() {
+    benchProbabilities(30, 16, 20, 3);
+    benchProbabilities(100, 100, 18, 40);
+    benchProbabilities(300, 300, 18, 400);
+    return 0;
+}
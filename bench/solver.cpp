@@ -0,0 +1,75 @@
+/// Solver benchmark
+/** \file
+ * Measures the cost of the solver: once for the entire board, and incrementally per move.
+ */
+#include "bench.hpp"
+
+#include "solver.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Plays a game by opening the safe fields found by the solver, one per move.
+ * @param width width of the board
+ * @param height height of the board
+ * @param density mine density in percent
+ */
+void benchSolve(int width, int height, int density) {
+    std::string size = std::to_string(width) + "x" + std::to_string(height) + "/" + std::to_string(density) + "%";
+    Minefield start(width, height, (static_cast<std::int64_t>(width) * height * density) / 100, 0);
+    start.open(width / 2, height / 2);
+
+    report("reset (whole board)", size, measureMs(3, [&]() {
+        Solver solver;
+        solver.reset(start);
+        std::vector<std::tuple<int, int>> safe_fields;
+        solver.getSafeFields(safe_fields);
+        keepAlive(safe_fields.size());
+    }));
+
+    // guesses are made w/ a lost copy, so the game goes on when the solver is stuck
+    // (moves are not part of the measurement, only the solver)
+    Minefield revealed = start;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % width, i / width, false);
+    }
+
+    int moves = 0;
+    double total_ms = 0;
+    Minefield mfield = start;
+    mfield.setChangeTrackingEnabled(true);
+    Solver solver;
+    std::vector<std::tuple<int, int>> changed, safe_fields;
+    solver.reset(mfield);
+    mfield.drainChangedCells(changed);
+    solver.getSafeFields(safe_fields);
+    for (int guess = 0; mfield.isGameRunning() && moves < 20000; moves++) {
+        if (safe_fields.empty()) {
+            int x, y;
+            do {
+                guess++;
+                std::int64_t pos = (static_cast<std::int64_t>(guess) * 7919) % (static_cast<std::int64_t>(width) * height);
+                x = static_cast<int>(pos % width);
+                y = static_cast<int>(pos / width);
+            } while (mfield.isOpen(x, y) || revealed.isMine(x, y));
+            mfield.open(x, y);
+        } else {
+            mfield.open(std::get<0>(safe_fields.front()), std::get<1>(safe_fields.front()));
+        }
+
+        mfield.drainChangedCells(changed);
+        total_ms += measureMs(1, [&]() {
+            solver.update(mfield, changed);
+            solver.getSafeFields(safe_fields);
+        });
+    }
+    report("update per move (" + std::to_string(moves) + " moves)", size, total_ms / std::max(moves, 1));
+}
+
+int main() {
+    benchSolve(30, 16, 20);
+    benchSolve(1000, 1000, 15);
+    return 0;
+}
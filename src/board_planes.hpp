@@ -0,0 +1,147 @@
+/// bit plane layout of the minefield cells
+/** \file
+ * Contains the layout of the bit planes used to store the state of the minefield cells,
+ * and helpers to read and write single cells.
+ *
+ * The cells are stored in groups of 64 horizontally adjacent cells.
+ * For every group PLANE_COUNT words are stored next to each other, one per plane.
+ * Each cell has one bit per plane, bit (x % 64) of the word belongs to the cell at x.
+ */
+#ifndef __BOARD_PLANES_HPP_INCLUDED__
+#define __BOARD_PLANES_HPP_INCLUDED__
+
+#include <cstdint>
+
+/// bit planes stored per group of 64 cells
+/**
+ * Every cell has one bit in each plane.
+ */
+enum Plane {
+    /// set if there is a mine
+    MINE_PLANE = 0,
+    /// set if a flag is placed
+    FLAG_PLANE,
+    /// set if the cell has been opened
+    OPEN_PLANE,
+    /// set on fields w/o sorrounding mines after their sorroundings have been opened
+    EXPANDED_PLANE,
+    /// set if the field has been reported as changed, but not been drained yet
+    DIRTY_PLANE,
+    /// lowest bit of the amount of sorrounding flags
+    FLAG_COUNT_PLANE_0,
+    /// second bit of the amount of sorrounding flags
+    FLAG_COUNT_PLANE_1,
+    /// third bit of the amount of sorrounding flags
+    FLAG_COUNT_PLANE_2,
+    /// highest bit of the amount of sorrounding flags
+    FLAG_COUNT_PLANE_3,
+    /// lowest bit of the amount of sorrounding mines
+    COUNT_PLANE_0,
+    /// second bit of the amount of sorrounding mines
+    COUNT_PLANE_1,
+    /// third bit of the amount of sorrounding mines
+    COUNT_PLANE_2,
+    /// highest bit of the amount of sorrounding mines
+    COUNT_PLANE_3,
+    /// amount of planes, not a plane itself
+    PLANE_COUNT
+};
+
+/**
+ * Reads the bit of a cell from a group.
+ * @param group the words of the group containing the cell
+ * @param plane the plane to read from
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @return the bit of the cell
+ */
+inline bool getGroupBit(const std::uint64_t* group, Plane plane, int x) {
+    return (group[plane] >> (x & 63)) & 1;
+}
+
+/**
+ * Sets the bit of a cell in a group.
+ * @param group the words of the group containing the cell
+ * @param plane the plane to write to
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @param value the new value of the bit
+ */
+inline void setGroupBit(std::uint64_t* group, Plane plane, int x, bool value) {
+    std::uint64_t mask = std::uint64_t(1) << (x & 63);
+    if (value) {
+        group[plane] |= mask;
+    } else {
+        group[plane] &= ~mask;
+    }
+}
+
+/**
+ * Reads the amount of sorrounding mines of a cell, stored bit-sliced in the count planes.
+ * @param group the words of the group containing the cell
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @return the amount of sorrounding mines
+ */
+inline int getGroupCount(const std::uint64_t* group, int x) {
+    int bit = x & 63;
+    return ((group[COUNT_PLANE_0] >> bit) & 1)
+        | (((group[COUNT_PLANE_1] >> bit) & 1) << 1)
+        | (((group[COUNT_PLANE_2] >> bit) & 1) << 2)
+        | (((group[COUNT_PLANE_3] >> bit) & 1) << 3);
+}
+
+/**
+ * Writes the amount of sorrounding mines of a cell into the count planes.
+ * @param group the words of the group containing the cell
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @param count the amount of sorrounding mines, 0..8
+ */
+inline void setGroupCount(std::uint64_t* group, int x, int count) {
+    setGroupBit(group, COUNT_PLANE_0, x, count & 1);
+    setGroupBit(group, COUNT_PLANE_1, x, count & 2);
+    setGroupBit(group, COUNT_PLANE_2, x, count & 4);
+    setGroupBit(group, COUNT_PLANE_3, x, count & 8);
+}
+
+/**
+ * Reads the amount of sorrounding flags of a cell, stored bit-sliced in the flag count planes.
+ * @param group the words of the group containing the cell
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @return the amount of sorrounding flags
+ */
+inline int getGroupFlagCount(const std::uint64_t* group, int x) {
+    int bit = x & 63;
+    return ((group[FLAG_COUNT_PLANE_0] >> bit) & 1)
+        | (((group[FLAG_COUNT_PLANE_1] >> bit) & 1) << 1)
+        | (((group[FLAG_COUNT_PLANE_2] >> bit) & 1) << 2)
+        | (((group[FLAG_COUNT_PLANE_3] >> bit) & 1) << 3);
+}
+
+/**
+ * Writes the amount of sorrounding flags of a cell into the flag count planes.
+ * @param group the words of the group containing the cell
+ * @param x x coordinate of the cell (only x % 64 is used)
+ * @param count the amount of sorrounding flags, 0..8
+ */
+inline void setGroupFlagCount(std::uint64_t* group, int x, int count) {
+    setGroupBit(group, FLAG_COUNT_PLANE_0, x, count & 1);
+    setGroupBit(group, FLAG_COUNT_PLANE_1, x, count & 2);
+    setGroupBit(group, FLAG_COUNT_PLANE_2, x, count & 4);
+    setGroupBit(group, FLAG_COUNT_PLANE_3, x, count & 8);
+}
+
+/**
+ * Adds 1 to or subtracts 1 from the amount of sorrounding flags of all cells of a group in the mask, at once.
+ * The bit-sliced counts are incremented (decremented) like binary numbers, w/ the carry (borrow) rippling through the planes.
+ * @param group the words of the group
+ * @param mask cells to change
+ * @param delta 1 or -1
+ */
+inline void addToGroupFlagCounts(std::uint64_t* group, std::uint64_t mask, int delta) {
+    std::uint64_t carry = mask;
+    for (int plane = FLAG_COUNT_PLANE_0; plane <= FLAG_COUNT_PLANE_3; plane++) {
+        std::uint64_t next = (0 < delta) ? (group[plane] & carry) : (~group[plane] & carry);
+        group[plane] ^= carry;
+        carry = next;
+    }
+}
+
+#endif // __BOARD_PLANES_HPP_INCLUDED__
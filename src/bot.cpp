@@ -0,0 +1,179 @@
+/// bot method bodies
+/** \file
+ * Contains the bots playing w/o a player, and the factory creating them.
+ */
+#include "bot.hpp"
+
+#include "monte_carlo.hpp"
+#include "probability.hpp"
+#include "solver.hpp"
+
+#include <random>
+#include <stdexcept>
+
+/// opens closed fields at random, the baseline for the other bots
+class RandomBot : public Bot {
+    public:
+        void startGame(const Minefield& mfield, std::int64_t seed) {
+            (void) mfield;
+            randomizer.seed(static_cast<std::uint64_t>(seed));
+        }
+
+        void nextMoves(const Minefield& mfield, const std::vector<std::tuple<int, int>>& changed, std::vector<Move>& into) {
+            (void) changed;
+            into.push_back(guess(mfield));
+        }
+
+    protected:
+        /// source of the guesses, seeded w/ the seed of the game
+        std::mt19937_64 randomizer;
+
+        /**
+         * Returns true if the given closed field is known to be a mine, and must not be guessed.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return true if the field is a known mine
+         */
+        virtual bool isKnownMine(int x, int y) const {
+            (void) x;
+            (void) y;
+            return false;
+        }
+
+        /**
+         * Picks a closed field that is not known to be a mine, all w/ the same probability.
+         * @param mfield minefield w/ a running game
+         * @return the guess
+         */
+        Move guess(const Minefield& mfield) {
+            std::int64_t candidate_count = 0;
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                for (int x = 0; x < mfield.getXDimension(); x++) {
+                    candidate_count += (mfield.isOpen(x, y) || isKnownMine(x, y)) ? 0 : 1;
+                }
+            }
+
+            std::int64_t pick = std::uniform_int_distribution<std::int64_t>(0, candidate_count - 1)(randomizer);
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                for (int x = 0; x < mfield.getXDimension(); x++) {
+                    if (! mfield.isOpen(x, y) && ! isKnownMine(x, y) && 0 == pick--) {
+                        return Move{x, y, true};
+                    }
+                }
+            }
+            throw std::runtime_error("No closed field left to guess.");
+        }
+};
+
+/// opens the fields the Solver proves safe, guesses at random if there are none
+class SolverBot : public RandomBot {
+    public:
+        void startGame(const Minefield& mfield, std::int64_t seed) {
+            RandomBot::startGame(mfield, seed);
+            solver = Solver();
+        }
+
+        void nextMoves(const Minefield& mfield, const std::vector<std::tuple<int, int>>& changed, std::vector<Move>& into) {
+            solver.update(mfield, changed);
+            solver.getSafeFields(safe_fields);
+            for (auto& field : safe_fields) {
+                into.push_back(Move{std::get<0>(field), std::get<1>(field), false});
+            }
+            if (into.empty()) {
+                into.push_back(chooseGuess(mfield));
+            }
+        }
+
+    protected:
+        /// deductions of the current game, updated incrementally
+        Solver solver;
+
+        /// safe fields, reused between moves
+        std::vector<std::tuple<int, int>> safe_fields;
+
+        bool isKnownMine(int x, int y) const {
+            return solver.isMine(x, y);
+        }
+
+        /**
+         * Chooses a field to open when nothing is provably safe.
+         * @param mfield minefield w/ a running game
+         * @return the guess
+         */
+        virtual Move chooseGuess(const Minefield& mfield) {
+            return guess(mfield);
+        }
+};
+
+/// like the SolverBot, but guesses the field least likely to be a mine
+class ProbabilityBot : public SolverBot {
+    public:
+        ProbabilityBot() {
+            // games already run in parallel
+            engine.setThreadCount(1);
+            engine.setStateLimit(STATE_LIMIT);
+            estimator.setThreadCount(1);
+            estimator.setTimeBudget(0);
+            estimator.setSampleLimit(SAMPLE_LIMIT);
+        }
+
+        void startGame(const Minefield& mfield, std::int64_t seed) {
+            SolverBot::startGame(mfield, seed);
+            estimator.setSeed(seed);
+        }
+
+    protected:
+        /// state limit of the engine, larger frontiers are sampled
+        static const std::size_t STATE_LIMIT = 100000;
+
+        /// samples drawn if the state limit is exceeded (a sample limit instead of a time budget keeps the games deterministic)
+        static const std::int64_t SAMPLE_LIMIT = 2000;
+
+        /// exact probabilities
+        ProbabilityEngine engine;
+
+        /// estimated probabilities, if the engine exceeds its state limit
+        MonteCarloEstimator estimator;
+
+        Move chooseGuess(const Minefield& mfield) {
+            bool exact = engine.calculate(mfield);
+            if (! exact) {
+                estimator.estimate(mfield);
+            }
+
+            // first field (in rows) of the least likely ones, not a guess if the probabilities prove it safe
+            Move best{0, 0, true};
+            double best_probability = 2;
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                for (int x = 0; x < mfield.getXDimension(); x++) {
+                    if (mfield.isOpen(x, y)) {
+                        continue;
+                    }
+                    double probability = exact ? engine.getProbability(x, y) : estimator.getEstimate(x, y).probability;
+                    if (probability < best_probability) {
+                        best = Move{x, y, 0 < probability};
+                        best_probability = probability;
+                    }
+                }
+            }
+            return best;
+        }
+};
+
+const std::size_t ProbabilityBot::STATE_LIMIT;
+const std::int64_t ProbabilityBot::SAMPLE_LIMIT;
+
+std::unique_ptr<Bot> Bot::create(const std::string& name) {
+    if ("random" == name) {
+        return std::unique_ptr<Bot>(new RandomBot());
+    } else if ("solver" == name) {
+        return std::unique_ptr<Bot>(new SolverBot());
+    } else if ("probability" == name) {
+        return std::unique_ptr<Bot>(new ProbabilityBot());
+    }
+    throw std::runtime_error("Unknown bot: " + name);
+}
+
+std::vector<std::string> Bot::getNames() {
+    return {"random", "solver", "probability"};
+}
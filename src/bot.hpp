@@ -0,0 +1,69 @@
+/// bot class definition
+/** \file
+ * Contains the interface of the bots playing w/o a player, and the factory creating them by name.
+ */
+#ifndef __BOT_HPP_INCLUDED__
+#define __BOT_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/// Plays minesweeper w/o a player
+/**
+ * A bot only looks at what the player sees: open fields and their amount of sorrounding mines.
+ * Every game starts w/ opening the center field (see Simulation::playGame()), afterwards the bot is asked for moves until the game ends.
+ * Bots are deterministic: the same game and seed always lead to the same moves.
+ *
+ * New bots are derived from this class and added to create() and getNames().
+ */
+class Bot {
+    public:
+        /// a field to open
+        struct Move {
+            /// x coordinate
+            int x;
+            /// y coordinate
+            int y;
+            /// true if the bot doesn't know the field is safe
+            bool guess;
+        };
+
+        virtual ~Bot() {}
+
+        /**
+         * Forgets the previous game.
+         * @param mfield minefield of the new game, nothing is open yet
+         * @param seed seed of the game, for bots guessing at random
+         */
+        virtual void startGame(const Minefield& mfield, std::int64_t seed) = 0;
+
+        /**
+         * Chooses the next fields to open, called while the game is running.
+         * All moves are made in order before the next call, fields opened in the meantime (e.g. by opening a field w/o sorrounding mines) are skipped.
+         * @param mfield minefield of the game
+         * @param changed fields changed since the last call (see Minefield::drainChangedCells())
+         * @param into receives at least one move
+         */
+        virtual void nextMoves(const Minefield& mfield, const std::vector<std::tuple<int, int>>& changed, std::vector<Move>& into) = 0;
+
+        /**
+         * Creates a bot by its name.
+         * @param name one of getNames()
+         * @return the new bot
+         * @throws std::runtime_error if there is no bot w/ the given name
+         */
+        static std::unique_ptr<Bot> create(const std::string& name);
+
+        /**
+         * Returns the names of all bots create() knows.
+         * @return names of the bots
+         */
+        static std::vector<std::string> getNames();
+};
+
+#endif // __BOT_HPP_INCLUDED__
@@ -0,0 +1,314 @@
+/// chunked storage method bodies
+/** \file
+ * Contains the method bodies for the chunked cell storage.
+ */
+#include "chunked_storage.hpp"
+#include "neighbour_count.hpp"
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Mixes the bits of the given value (splitmix64 finalizer).
+ * @param value value to mix
+ * @return well distributed hash of the value
+ */
+static std::uint64_t mix(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+const int ChunkedStorage::CHUNK_SIZE;
+const int ChunkedStorage::STORED_PLANE_COUNT;
+
+std::size_t ChunkedStorage::KeyHash::operator()(std::uint64_t key) const {
+    return static_cast<std::size_t>(mix(key));
+}
+
+ChunkedStorage::ChunkedStorage() : ChunkedStorage(1, 1, 0, 0) {
+}
+
+ChunkedStorage::ChunkedStorage(int width, int height, std::int64_t mine_count, std::int64_t seed) {
+    this->width = width;
+    this->height = height;
+    this->mine_count = mine_count;
+    this->seed = seed;
+    unbounded = false;
+    mines_per_chunk = 0;
+    chunk_limit = 0;
+
+    cached_key = 0;
+    cached_chunk = nullptr;
+}
+
+ChunkedStorage::ChunkedStorage(int mines_per_chunk, std::int64_t seed) : ChunkedStorage(1, 1, 0, seed) {
+    if (mines_per_chunk < 0 || mines_per_chunk > CHUNK_SIZE * CHUNK_SIZE) {
+        throw std::range_error("Given mine count doesn't fit into a chunk.");
+    }
+
+    unbounded = true;
+    this->mines_per_chunk = mines_per_chunk;
+}
+
+ChunkedStorage::ChunkedStorage(const ChunkedStorage& other) {
+    *this = other;
+}
+
+ChunkedStorage& ChunkedStorage::operator=(const ChunkedStorage& other) {
+    if (this == &other) {
+        return *this;
+    }
+
+    chunks = other.chunks;
+    width = other.width;
+    height = other.height;
+    mine_count = other.mine_count;
+    seed = other.seed;
+    unbounded = other.unbounded;
+    mines_per_chunk = other.mines_per_chunk;
+
+    // the temporary file is not shared: load the chunks the other storage has evicted
+    cache_slots.clear();
+    for (auto& slot : other.cache_slots) {
+        if (chunks.end() == chunks.find(slot.first)) {
+            readChunk(other.cache_file.get(), slot.second, chunks[slot.first]);
+        }
+    }
+    cache_file.reset();
+    chunk_limit = 0;
+    setChunkLimit(other.chunk_limit);
+
+    // the cache would point into the other storage
+    cached_key = 0;
+    cached_chunk = nullptr;
+    return *this;
+}
+
+void ChunkedStorage::forEachChunk(const std::function<void(int chunk_x, int chunk_y, std::uint64_t* words)>& fn) {
+    for (auto& entry : chunks) {
+        if (entry.second.counted) {
+            int chunk_x = static_cast<std::int32_t>(entry.first >> 32);
+            int chunk_y = static_cast<std::int32_t>(entry.first & 0xFFFFFFFF);
+            fn(chunk_x, chunk_y, entry.second.words);
+        }
+    }
+}
+
+bool ChunkedStorage::isUnbounded() const {
+    return unbounded;
+}
+
+void ChunkedStorage::setChunkLimit(std::size_t max_chunks) {
+    if (0 != max_chunks && ! cache_file) {
+        cache_file = std::shared_ptr<std::FILE>(std::tmpfile(), std::fclose);
+        if (! cache_file) {
+            throw std::runtime_error("Can't create temporary file for evicted chunks.");
+        }
+    }
+    chunk_limit = max_chunks;
+}
+
+void ChunkedStorage::evictFarChunks(int x, int y) {
+    if (0 == chunk_limit || chunks.size() <= chunk_limit) {
+        return;
+    }
+
+    // sort by distance (in chunks) to the center, farthest first
+    int center_x = getChunkCoordinate(x);
+    int center_y = getChunkCoordinate(y);
+    std::vector<std::pair<std::int64_t, std::uint64_t>> by_distance;
+    by_distance.reserve(chunks.size());
+    for (auto& entry : chunks) {
+        std::int64_t dx = std::abs(static_cast<std::int64_t>(static_cast<std::int32_t>(entry.first >> 32)) - center_x);
+        std::int64_t dy = std::abs(static_cast<std::int64_t>(static_cast<std::int32_t>(entry.first & 0xFFFFFFFF)) - center_y);
+        by_distance.push_back(std::make_pair(std::max(dx, dy), entry.first));
+    }
+
+    std::size_t evict_count = chunks.size() - (chunk_limit * 3) / 4;
+    std::nth_element(by_distance.begin(), by_distance.begin() + (evict_count - 1), by_distance.end(),
+        [](const std::pair<std::int64_t, std::uint64_t>& a, const std::pair<std::int64_t, std::uint64_t>& b) {
+            return a.first > b.first;
+        });
+
+    for (std::size_t i = 0; i < evict_count; i++) {
+        auto found = chunks.find(by_distance[i].second);
+        // chunks w/o counts have never been accessed -> unchanged since generation (or since loading)
+        if (found->second.counted) {
+            writeChunk(found->first, found->second);
+        }
+        chunks.erase(found);
+    }
+
+    cached_key = 0;
+    cached_chunk = nullptr;
+}
+
+std::size_t ChunkedStorage::getEvictedChunkCount() const {
+    return cache_slots.size();
+}
+
+void ChunkedStorage::writeChunk(std::uint64_t key, const Chunk& chunk) {
+    const long record_size = CHUNK_SIZE * STORED_PLANE_COUNT * sizeof(std::uint64_t);
+
+    auto slot = cache_slots.find(key);
+    if (cache_slots.end() == slot) {
+        slot = cache_slots.insert(std::make_pair(key, static_cast<long>(cache_slots.size()) * record_size)).first;
+    }
+
+    std::uint64_t record[CHUNK_SIZE * STORED_PLANE_COUNT];
+    for (int row = 0; row < CHUNK_SIZE; row++) {
+        std::memcpy(&record[row * STORED_PLANE_COUNT], &chunk.words[row * PLANE_COUNT], STORED_PLANE_COUNT * sizeof(std::uint64_t));
+    }
+
+    if (0 != std::fseek(cache_file.get(), slot->second, SEEK_SET) || 1 != std::fwrite(record, sizeof(record), 1, cache_file.get())) {
+        throw std::runtime_error("Can't write evicted chunk to temporary file.");
+    }
+}
+
+void ChunkedStorage::readChunk(std::FILE* file, long slot, Chunk& chunk) {
+    std::uint64_t record[CHUNK_SIZE * STORED_PLANE_COUNT];
+    if (0 != std::fseek(file, slot, SEEK_SET) || 1 != std::fread(record, sizeof(record), 1, file)) {
+        throw std::runtime_error("Can't read evicted chunk from temporary file.");
+    }
+
+    std::memset(chunk.words, 0, sizeof(chunk.words));
+    for (int row = 0; row < CHUNK_SIZE; row++) {
+        std::memcpy(&chunk.words[row * PLANE_COUNT], &record[row * STORED_PLANE_COUNT], STORED_PLANE_COUNT * sizeof(std::uint64_t));
+    }
+    chunk.counted = false;
+}
+
+std::size_t ChunkedStorage::getChunkCount() const {
+    return chunks.size();
+}
+
+std::size_t ChunkedStorage::getMemory() const {
+    return chunks.size() * sizeof(Chunk);
+}
+
+std::int64_t ChunkedStorage::getChunkMineCount(int chunk_x, int chunk_y) const {
+    if (unbounded) {
+        return mines_per_chunk;
+    }
+
+    // every chunk receives mines proportional to the amount of cells before and inside of it (in row-major chunk order)
+    // -> shares add up to exactly mine_count
+    std::int64_t chunk_width = getChunkWidth(chunk_x);
+    std::int64_t chunk_height = getChunkHeight(chunk_y);
+
+    std::int64_t total_cells = static_cast<std::int64_t>(width) * height;
+    std::int64_t cells_before = static_cast<std::int64_t>(chunk_y) * CHUNK_SIZE * width + chunk_x * CHUNK_SIZE * chunk_height;
+    std::int64_t cells_inside = chunk_width * chunk_height;
+
+    unsigned __int128 mines_until_end = static_cast<unsigned __int128>(mine_count) * (cells_before + cells_inside) / total_cells;
+    unsigned __int128 mines_before = static_cast<unsigned __int128>(mine_count) * cells_before / total_cells;
+    return static_cast<std::int64_t>(mines_until_end - mines_before);
+}
+
+int ChunkedStorage::getChunkWidth(int chunk_x) const {
+    return unbounded ? CHUNK_SIZE : std::min(CHUNK_SIZE, width - chunk_x * CHUNK_SIZE);
+}
+
+int ChunkedStorage::getChunkHeight(int chunk_y) const {
+    return unbounded ? CHUNK_SIZE : std::min(CHUNK_SIZE, height - chunk_y * CHUNK_SIZE);
+}
+
+ChunkedStorage::Chunk& ChunkedStorage::getChunk(int chunk_x, int chunk_y, bool counted) const {
+    std::uint64_t key = getKey(chunk_x, chunk_y);
+    auto found = chunks.find(key);
+    if (chunks.end() == found) {
+        Chunk& chunk = chunks[key];
+        auto slot = cache_slots.find(key);
+        if (cache_slots.end() != slot) {
+            // evicted before: the mines may have been moved, so they can't be generated again
+            readChunk(cache_file.get(), slot->second, chunk);
+        } else {
+            std::memset(chunk.words, 0, sizeof(chunk.words));
+            chunk.counted = false;
+            generateMines(chunk_x, chunk_y, chunk);
+        }
+        found = chunks.find(key);
+    }
+
+    Chunk& chunk = found->second;
+    if (counted && ! chunk.counted) {
+        countMines(chunk_x, chunk_y, chunk);
+        chunk.counted = true;
+    }
+    return chunk;
+}
+
+void ChunkedStorage::generateMines(int chunk_x, int chunk_y, Chunk& chunk) const {
+    int chunk_mines = static_cast<int>(getChunkMineCount(chunk_x, chunk_y));
+    placeChunkMines(seed, chunk_x, chunk_y, getChunkWidth(chunk_x), getChunkHeight(chunk_y), chunk_mines, chunk.words, PLANE_COUNT);
+}
+
+void ChunkedStorage::placeChunkMines(std::int64_t seed, int chunk_x, int chunk_y, int chunk_width, int chunk_height, int chunk_mines, std::uint64_t* words, std::size_t row_stride) {
+    int cell_count = chunk_width * chunk_height;
+
+    // counter based rng: the i-th random number of a chunk is a hash of (seed, chunk, i)
+    std::uint64_t key = mix(mix(mix(static_cast<std::uint64_t>(seed)) + static_cast<std::uint32_t>(chunk_x)) + static_cast<std::uint32_t>(chunk_y));
+
+    // Floyd's algorithm: picks chunk_mines distinct cells uniformly w/o a list of all cells
+    for (int j = cell_count - chunk_mines; j < cell_count; j++) {
+        std::uint64_t random = mix(key + static_cast<std::uint64_t>(j));
+        int chosen = static_cast<int>((static_cast<unsigned __int128>(random) * (j + 1)) >> 64);
+
+        if (getGroupBit(&words[(chosen / chunk_width) * row_stride], MINE_PLANE, chosen % chunk_width)) {
+            chosen = j;
+        }
+        setGroupBit(&words[(chosen / chunk_width) * row_stride], MINE_PLANE, chosen % chunk_width, true);
+    }
+}
+
+const std::uint64_t* ChunkedStorage::getMineWords(int chunk_x, int chunk_y) const {
+    if (! unbounded && (chunk_x < 0 || chunk_y < 0 || chunk_x * CHUNK_SIZE >= width || chunk_y * CHUNK_SIZE >= height)) {
+        return nullptr;
+    }
+    return getChunk(chunk_x, chunk_y, false).words;
+}
+
+void ChunkedStorage::countMines(int chunk_x, int chunk_y, Chunk& chunk) const {
+    // words of the 3x3 chunks around (and including) this one, nullptr outside of the board
+    const std::uint64_t* neighbours[3][3];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            neighbours[dy + 1][dx + 1] = getMineWords(chunk_x + dx, chunk_y + dy);
+        }
+    }
+
+    for (int row = 0; row < CHUNK_SIZE; row++) {
+        std::uint64_t rows[3][3];
+        for (int dy = -1; dy <= 1; dy++) {
+            // row above/below may lie in the chunk above/below
+            int chunk_row = 1;
+            int current_row = row + dy;
+            if (current_row < 0) {
+                chunk_row = 0;
+                current_row += CHUNK_SIZE;
+            } else if (current_row >= CHUNK_SIZE) {
+                chunk_row = 2;
+                current_row -= CHUNK_SIZE;
+            }
+
+            for (int dx = 0; dx < 3; dx++) {
+                const std::uint64_t* words = neighbours[chunk_row][dx];
+                rows[dy + 1][dx] = (nullptr == words) ? 0 : words[current_row * PLANE_COUNT + MINE_PLANE];
+            }
+        }
+
+        std::uint64_t counts[4];
+        countNeighbourWords(rows[0], rows[1], rows[2], counts);
+
+        std::uint64_t* current_group = &chunk.words[row * PLANE_COUNT];
+        current_group[COUNT_PLANE_0] = counts[0];
+        current_group[COUNT_PLANE_1] = counts[1];
+        current_group[COUNT_PLANE_2] = counts[2];
+        current_group[COUNT_PLANE_3] = counts[3];
+    }
+}
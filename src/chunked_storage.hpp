@@ -0,0 +1,343 @@
+/// chunked storage class definition
+/** \file
+ * Contains the class definition for the chunked cell storage, used for very large minefields.
+ */
+#ifndef __CHUNKED_STORAGE_HPP_INCLUDED__
+#define __CHUNKED_STORAGE_HPP_INCLUDED__
+
+#include "board_planes.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+/// Stores the cells of a minefield in lazily allocated chunks
+/**
+ * The board is split into chunks of 64x64 cells.
+ * A chunk is only allocated once a cell inside of it is accessed,
+ * so memory is proportional to the explored area, not the board area.
+ *
+ * Every chunk stores one group of cells per row (see board_planes.hpp), so accessing cells works exactly like on the dense storage.
+ *
+ * The mines of a chunk are derived from the seed and the chunk position only:
+ * Every chunk receives its share of the total mine count proportional to its amount of cells (so the total is exact),
+ * the positions inside of the chunk are drawn w/ a counter based random number generator keyed by seed and chunk position.
+ * Therefore chunks can be generated in any order.
+ *
+ * Chunks are allocated in two stages:
+ * First only the mines are generated (needed by neighbouring chunks to calculate their counts),
+ * on first access of a cell the sorrounding mine counts are calculated as well.
+ *
+ * An unbounded storage has no borders: every int is a valid coordinate (incl. negative ones),
+ * and every chunk receives the same amount of mines.
+ *
+ * If a chunk limit is set, chunks far away from the last move are evicted to a temporary file once the limit is exceeded.
+ * Only the mine, state and flag count planes are written (the mine counts are calculated again when the chunk is loaded back).
+ * Chunks that have only been generated, but never accessed, are simply dropped and generated again on demand.
+ */
+class ChunkedStorage {
+    public:
+        /// width and height of a chunk
+        static const int CHUNK_SIZE = 64;
+
+        /**
+         * Creates an empty storage, only to be assigned to later.
+         */
+        ChunkedStorage();
+
+        /**
+         * Creates a new storage. No chunks are allocated yet.
+         * @param width amount of columns
+         * @param height amount of rows
+         * @param mine_count total amount of mines
+         * @param seed seed used to place the mines
+         */
+        ChunkedStorage(int width, int height, std::int64_t mine_count, std::int64_t seed);
+
+        /**
+         * Creates a new unbounded storage. No chunks are allocated yet.
+         * @param mines_per_chunk amount of mines placed in every chunk, 0..CHUNK_SIZE*CHUNK_SIZE
+         * @param seed seed used to place the mines
+         */
+        ChunkedStorage(int mines_per_chunk, std::int64_t seed);
+
+        /**
+         * Copies all chunks of the given storage.
+         * Evicted chunks are loaded into the memory of the copy, the copy evicts to its own temporary file.
+         * @param other storage to copy
+         */
+        ChunkedStorage(const ChunkedStorage& other);
+
+        /**
+         * Copies all chunks of the given storage.
+         * Evicted chunks are loaded into the memory of the copy, the copy evicts to its own temporary file.
+         * @param other storage to copy
+         * @return this storage
+         */
+        ChunkedStorage& operator=(const ChunkedStorage& other);
+
+        /**
+         * Returns the group containing the given cell, allocates the chunk if required.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return pointer to the PLANE_COUNT words of the group
+         */
+        std::uint64_t* group(int x, int y);
+
+        /**
+         * Returns the group containing the given cell, allocates the chunk if required.
+         * (Allocating a chunk doesn't change the state of the board, so this is allowed on const storages.)
+         * Changes the chunks and the chunk cache, so const access isn't thread-safe either.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return pointer to the PLANE_COUNT words of the group
+         */
+        const std::uint64_t* group(int x, int y) const;
+
+        /**
+         * Calls the given function for every chunk whose cells have been accessed.
+         * The function receives the chunk coordinates (cell coordinates divided by CHUNK_SIZE)
+         * and the words of the chunk: CHUNK_SIZE groups, one per row.
+         * @param fn function to call
+         */
+        void forEachChunk(const std::function<void(int chunk_x, int chunk_y, std::uint64_t* words)>& fn);
+
+        /**
+         * Returns true if the storage has no borders.
+         * @return true if every coordinate is valid
+         */
+        bool isUnbounded() const;
+
+        /**
+         * Sets the maximum amount of chunks kept in memory, 0 (default) for no limit.
+         * Opens the temporary file evicted chunks are written to.
+         * @param max_chunks amount of chunks above which evictFarChunks() writes chunks to disk
+         * @throws std::exception if the temporary file can't be created
+         */
+        void setChunkLimit(std::size_t max_chunks);
+
+        /**
+         * Evicts the chunks farthest away from the given cell, if more than the chunk limit are in memory.
+         * Afterwards, at most 3/4 of the limit are in memory (so the eviction doesn't run on every call).
+         * Invalidates all pointers returned by group(), so must not be called while those are used.
+         * @param x x coordinate of the center cell
+         * @param y y coordinate of the center cell
+         * @throws std::exception if writing to the temporary file fails
+         */
+        void evictFarChunks(int x, int y);
+
+        /**
+         * Returns the amount of chunks written to disk.
+         * @return amount of chunks in the temporary file
+         */
+        std::size_t getEvictedChunkCount() const;
+
+        /**
+         * Returns the chunk coordinate of the given cell coordinate (rounded down, also for negative coordinates).
+         * @param cell x or y coordinate of a cell
+         * @return x or y coordinate of the chunk containing the cell
+         */
+        static int getChunkCoordinate(int cell);
+
+        /**
+         * Returns the amount of allocated chunks.
+         * @return amount of chunks in memory
+         */
+        std::size_t getChunkCount() const;
+
+        /**
+         * Returns the amount of memory used by the allocated chunks.
+         * @return size of all chunks in bytes
+         */
+        std::size_t getMemory() const;
+
+        /**
+         * Returns the amount of mines placed in the given chunk on generation.
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @return amount of mines in the chunk
+         */
+        std::int64_t getChunkMineCount(int chunk_x, int chunk_y) const;
+
+        /**
+         * Places the mines of a chunk, drawn w/ a counter based random number generator keyed by seed and chunk position.
+         * Only depends on the arguments, so chunks can be generated in any order (and on any thread).
+         * Also used to generate the dense storage tile by tile, which results in the same board as the chunked storage.
+         * @param seed seed of the board
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @param chunk_width amount of columns of the chunk inside of the board
+         * @param chunk_height amount of rows of the chunk inside of the board
+         * @param chunk_mines amount of mines to place, see getChunkMineCount()
+         * @param words first group of the chunk, mine plane has to be empty
+         * @param row_stride distance between the groups of two rows, in words
+         */
+        static void placeChunkMines(std::int64_t seed, int chunk_x, int chunk_y, int chunk_width, int chunk_height, int chunk_mines, std::uint64_t* words, std::size_t row_stride);
+
+    private:
+        /// a chunk of CHUNK_SIZE x CHUNK_SIZE cells
+        struct Chunk {
+            /// one group per row
+            std::uint64_t words[CHUNK_SIZE * PLANE_COUNT];
+
+            /// true if the count planes have been calculated
+            bool counted;
+        };
+
+        /// amount of planes written when a chunk is evicted (all but the count planes)
+        static const int STORED_PLANE_COUNT = COUNT_PLANE_0;
+
+        /// hash for packed chunk coordinates
+        struct KeyHash {
+            std::size_t operator()(std::uint64_t key) const;
+        };
+
+        /// allocated chunks, by packed coordinates
+        /**
+         * Mutable, as chunks are allocated on read access as well.
+         * References to elements of an unordered_map stay valid when other elements are inserted.
+         */
+        mutable std::unordered_map<std::uint64_t, Chunk, KeyHash> chunks;
+
+        /// key of the last accessed chunk
+        mutable std::uint64_t cached_key;
+
+        /// last accessed chunk, nullptr if none
+        /**
+         * Most accesses hit the same chunk as the previous one, this saves the hash lookup.
+         */
+        mutable Chunk* cached_chunk;
+
+        /// amount of columns of the board
+        int width;
+
+        /// amount of rows of the board
+        int height;
+
+        /// total amount of mines on the board
+        std::int64_t mine_count;
+
+        /// seed used to place the mines
+        std::int64_t seed;
+
+        /// true if the board has no borders
+        bool unbounded;
+
+        /// amount of mines in every chunk of an unbounded storage
+        int mines_per_chunk;
+
+        /// maximum amount of chunks in memory, 0 for no limit
+        std::size_t chunk_limit;
+
+        /// temporary file holding the evicted chunks, nullptr until a chunk limit is set
+        std::shared_ptr<std::FILE> cache_file;
+
+        /// position of every chunk in cache_file, by packed coordinates
+        /**
+         * Every chunk has a fixed slot, so evicting a chunk again overwrites its old record.
+         * Chunks stay listed after being loaded back into memory.
+         */
+        std::unordered_map<std::uint64_t, long, KeyHash> cache_slots;
+
+        /**
+         * Packs chunk coordinates into a single key.
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @return key for the chunk map
+         */
+        static std::uint64_t getKey(int chunk_x, int chunk_y);
+
+        /**
+         * Returns the given chunk, allocates and generates its mines if required.
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @param counted if set, the sorrounding mine counts are calculated as well
+         * @return the chunk
+         */
+        Chunk& getChunk(int chunk_x, int chunk_y, bool counted) const;
+
+        /**
+         * Returns the amount of columns of the given chunk inside of the board.
+         * @param chunk_x x coordinate of the chunk
+         * @return width of the chunk, CHUNK_SIZE except for the rightmost chunk
+         */
+        int getChunkWidth(int chunk_x) const;
+
+        /**
+         * Returns the amount of rows of the given chunk inside of the board.
+         * @param chunk_y y coordinate of the chunk
+         * @return height of the chunk, CHUNK_SIZE except for the bottom chunk
+         */
+        int getChunkHeight(int chunk_y) const;
+
+        /**
+         * Writes the mine and state planes of a chunk to its slot in cache_file.
+         * @param key packed coordinates of the chunk
+         * @param chunk chunk to write
+         * @throws std::exception if writing fails
+         */
+        void writeChunk(std::uint64_t key, const Chunk& chunk);
+
+        /**
+         * Reads the mine and state planes of a chunk from its slot in the given file.
+         * The count planes are left empty, chunk.counted is reset.
+         * @param file file to read from
+         * @param slot position of the chunk in the file
+         * @param chunk chunk to read into
+         * @throws std::exception if reading fails
+         */
+        static void readChunk(std::FILE* file, long slot, Chunk& chunk);
+
+        /**
+         * Places the mines of the given chunk, see placeChunkMines().
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @param chunk chunk to write the mine plane to
+         */
+        void generateMines(int chunk_x, int chunk_y, Chunk& chunk) const;
+
+        /**
+         * Calculates the count planes of the given chunk, generating the mines of neighbouring chunks as required.
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @param chunk chunk to write the count planes to
+         */
+        void countMines(int chunk_x, int chunk_y, Chunk& chunk) const;
+
+        /**
+         * Returns the words of the given chunk w/ at least the mines generated, nullptr for chunks outside of the board.
+         * @param chunk_x x coordinate of the chunk
+         * @param chunk_y y coordinate of the chunk
+         * @return the words of the chunk
+         */
+        const std::uint64_t* getMineWords(int chunk_x, int chunk_y) const;
+};
+
+inline int ChunkedStorage::getChunkCoordinate(int cell) {
+    return (cell < 0) ? (cell + 1) / CHUNK_SIZE - 1 : cell / CHUNK_SIZE;
+}
+
+inline const std::uint64_t* ChunkedStorage::group(int x, int y) const {
+    int chunk_x = getChunkCoordinate(x);
+    int chunk_y = getChunkCoordinate(y);
+    std::uint64_t key = getKey(chunk_x, chunk_y);
+    if (nullptr == cached_chunk || key != cached_key) {
+        cached_chunk = &getChunk(chunk_x, chunk_y, true);
+        cached_key = key;
+    }
+    return &cached_chunk->words[(y - chunk_y * CHUNK_SIZE) * PLANE_COUNT];
+}
+
+inline std::uint64_t* ChunkedStorage::group(int x, int y) {
+    return const_cast<std::uint64_t*>(static_cast<const ChunkedStorage*>(this)->group(x, y));
+}
+
+inline std::uint64_t ChunkedStorage::getKey(int chunk_x, int chunk_y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunk_x)) << 32) | static_cast<std::uint32_t>(chunk_y);
+}
+
+#endif // __CHUNKED_STORAGE_HPP_INCLUDED__
@@ -4,33 +4,46 @@
  */
 #include "controller.hpp"
 
+#include <algorithm>
 #include <tuple>
 
-Controller::Controller(int width, int height, int mine_count, int seed, bool only_autodiscover) {
+Controller::Controller(int width, int height, std::int64_t mine_count, std::int64_t seed, bool only_autodiscover) {
     x = 0;
     y = 0;
 
     mfield = Minefield(width, height, mine_count, seed);
+    mfield.setUndoEnabled(true);
+    mfield.setChangeTrackingEnabled(true);
     autodiscover_only = only_autodiscover;
 }
 
-int Controller::getX() {
+Controller::Controller(const Minefield& minefield, bool only_autodiscover) {
+    x = 0;
+    y = 0;
+
+    mfield = minefield;
+    mfield.setUndoEnabled(true);
+    mfield.setChangeTrackingEnabled(true);
+    autodiscover_only = only_autodiscover;
+}
+
+int Controller::getX() const {
     return x;
 }
 
-int Controller::getY() {
+int Controller::getY() const {
     return y;
 }
 
-int Controller::getWidth() {
+int Controller::getWidth() const {
     return mfield.getXDimension();
 }
 
-int Controller::getHeight() {
+int Controller::getHeight() const {
     return mfield.getYDimension();
 }
 
-bool Controller::isAutodiscoverOnly() {
+bool Controller::isAutodiscoverOnly() const {
     return autodiscover_only;
 }
 
@@ -62,53 +75,17 @@ void Controller::click() {
 }
 
 void Controller::click(int given_x, int given_y, bool autodiscover) {
-    class InternalClicker{
-        public:
-            static void clicker(int given_x, int given_y, bool autodiscover, Minefield& mfield, bool only_autodiscover, bool called_during_autodiscover = false) {
-                // check pos
-                if (mfield.isPosValid(given_x, given_y)) {
-                    // only do stuff while game is still running
-                    if (mfield.isGameRunning()) {
-                        // only click on fields w/o flags
-                        if(! mfield.isFlagged(given_x, given_y)) {
-                            if (autodiscover && mfield.isOpen(given_x, given_y)) {
-                                // already open -> autodiscover
-                                // if all sorrounding mines are flagged -> open all other sorrounding fields
-                                int flag_count = 0;
-                                for (int dx : {-1, 0, 1}) {
-                                    for (int dy: {-1, 0, 1}) {
-                                        if (mfield.isPosValid(given_x + dx, given_y + dy)) {
-                                            if (mfield.isFlagged(given_x + dx, given_y + dy)) {
-                                                flag_count++;
-                                            }
-                                        }
-                                    }
-                                }
-
-                                // don't treat 0 sorrounding mines, because handled by open function
-                                if (0 != flag_count && mfield.getSorroundingMineCount(given_x, given_y) == flag_count) {
-                                    for (int dx : {-1, 0, 1}) {
-                                        for (int dy: {-1, 0, 1}) {
-                                            clicker(given_x + dx, given_y + dy, false, mfield, only_autodiscover, true);
-                                        }
-                                    }
-                                }
-                            } else {
-                                // no autodiscover -> open regularly
-                                // unless autodiscover only enable
-                                // unless called from autodiscover or no field opened yet
-                                if (called_during_autodiscover || 0 == mfield.getOpenCount() || !only_autodiscover) {
-                                    mfield.open(given_x, given_y);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-    };
+    // open field: autodiscover (if all sorrounding mines are flagged -> open all other sorrounding fields)
+    // invalid positions, flags and ended games are reported by the minefield, so nothing else to do
+    if (autodiscover && Minefield::MoveResult::not_open != mfield.tryChord(given_x, given_y)) {
+        return;
+    }
 
-    // delegate to hide the called from autodiscover param from outside
-    InternalClicker::clicker(given_x, given_y, autodiscover, mfield, autodiscover_only);
+    // no autodiscover -> open regularly
+    // unless autodiscover only enabled and a field has been opened already
+    if (0 == mfield.getOpenCount() || ! autodiscover_only) {
+        mfield.tryOpen(given_x, given_y);
+    }
 }
 
 void Controller::tooggleFlag() {
@@ -116,24 +93,61 @@ void Controller::tooggleFlag() {
 }
 
 void Controller::tooggleFlag(int given_x, int given_y) {
-    // check pos
-    if (mfield.isPosValid(given_x, given_y)) {
-        // only do stuff while game is running
-        if (mfield.isGameRunning()) {
-            // don't do anything on already open fields
-            if (! mfield.isOpen(given_x, given_y)) {
-                // no choose: flag or unflag
-                if (mfield.isFlagged(given_x, given_y)) {
-                    mfield.unflag(given_x, given_y);
-                } else {
-                    mfield.flag(given_x, given_y);
-                }
+    // invalid positions, open fields and ended games are reported (not thrown) by the minefield
+    if (Minefield::MoveResult::flagged == mfield.tryFlag(given_x, given_y)) {
+        mfield.tryUnflag(given_x, given_y);
+    }
+}
+
+bool Controller::undo() {
+    return mfield.undo();
+}
+
+bool Controller::redo() {
+    return mfield.redo();
+}
+
+void Controller::drainChangedCells(std::vector<std::tuple<int, int>>& into) {
+    mfield.drainChangedCells(into);
+}
+
+void Controller::applyMoves(const std::vector<Minefield::Move>& moves, std::vector<Minefield::MoveResult>& results, std::vector<std::tuple<int, int>>& changed) {
+    results.resize(moves.size());
+    if (! autodiscover_only) {
+        mfield.applyMoves(moves.data(), moves.size(), results.data(), changed);
+        return;
+    }
+
+    // opens are only allowed as first move of the game: apply everything up to each open, then decide on the open
+    changed.clear();
+    std::vector<std::tuple<int, int>> part_changed;
+    auto apply = [&](std::size_t begin, std::size_t end) {
+        if (begin < end) {
+            mfield.applyMoves(moves.data() + begin, end - begin, results.data() + begin, part_changed);
+            changed.insert(changed.end(), part_changed.begin(), part_changed.end());
+        }
+    };
+
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < moves.size(); i++) {
+        if (Minefield::MoveType::open == moves[i].type) {
+            apply(begin, i);
+            if (0 == mfield.getOpenCount()) {
+                apply(i, i + 1);
+            } else {
+                results[i] = Minefield::MoveResult::not_allowed;
             }
+            begin = i + 1;
         }
     }
+    apply(begin, moves.size());
+
+    // every part drains the changes: a field changed in several parts would be reported once per part
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
 }
 
-Minefield Controller::getMinefield() {
+const Minefield& Controller::getMinefield() const {
     return mfield;
 }
 
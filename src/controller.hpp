@@ -7,6 +7,9 @@
 
 #include "minefield.hpp"
 
+#include <tuple>
+#include <vector>
+
 /**
  * The controller class servers as a driver for the minefield class.
  * The main functionality is delegated to the minefield class, the controller mainly implements the cursor object.
@@ -52,39 +55,48 @@ class Controller {
          * @param seed seed for the RNG
          * @param only_autodiscover if set: will not allow to open field directly, only via autodiscover (see below)
          */
-        Controller(int width = 8, int height = 8, int mine_count = 10, int seed = 0, bool only_autodiscover = false);
+        Controller(int width = 8, int height = 8, std::int64_t mine_count = 10, std::int64_t seed = 0, bool only_autodiscover = false);
+
+        /**
+         * Initializes a new Controller on the given minefield.
+         * Used for minefields that can't be described by width, height and mine count (e.g. unbounded ones).
+         * The cursor is placed at (0, 0).
+         * @param minefield the minefield to control
+         * @param only_autodiscover if set: will not allow to open field directly, only via autodiscover
+         */
+        Controller(const Minefield& minefield, bool only_autodiscover = false);
 
         /**
          * Returns the current X position of the cursor.
          * @return current x position, >=0, < width
          */
-        int getX();
+        int getX() const;
 
         /**
          * Returns the current Y position of the cursor.
          * @return current y position, >=0, < height
          */
-        int getY();
+        int getY() const;
 
         /**
          * Returns width of minefield.
          * Note that indexing starts at zero, so the field w/ index of the return value doesn't exist.
          * @return width of the minefield.
          */
-        int getWidth();
+        int getWidth() const;
 
         /**
          * Returns height of minefield.
          * Note that indexing starts at zero, so the field w/ index of the return value doesn't exist.
          * @return height of the minefield.
          */
-        int getHeight();
+        int getHeight() const;
 
         /**
          * Wether autodiscover only has been enabled in the constructor.
          * @returns true if autodiscover only has been passed in the constructor
          */
-        bool isAutodiscoverOnly();
+        bool isAutodiscoverOnly() const;
 
         /**
          * Moves the cursor to the right.
@@ -155,11 +167,49 @@ class Controller {
          */
         void tooggleFlag(int given_x, int given_y);
 
+        /**
+         * Reverts the last move that changed the minefield (a click, incl. its autodiscover, or a flag).
+         * Also works after the game is over, the game continues after undoing the losing move.
+         * Doesn't move the cursor.
+         * @return false if there is nothing to undo
+         * @see Minefield::undo()
+         */
+        bool undo();
+
+        /**
+         * Repeats the last undone move, until a new move is made.
+         * Doesn't move the cursor.
+         * @return false if there is nothing to redo
+         * @see Minefield::redo()
+         */
+        bool redo();
+
+        /**
+         * Retrieves the fields changed by click() and tooggleFlag() since the last call.
+         * Delegates to the minefield, so the same rules apply.
+         * Change tracking is enabled for the minefield of the controller, so this has to be called regularly.
+         * @param into receives the (x, y) coordinates of the changed fields
+         * @see Minefield::drainChangedCells()
+         */
+        void drainChangedCells(std::vector<std::tuple<int, int>>& into);
+
+        /**
+         * Applies the given moves to the minefield in one call, see Minefield::applyMoves().
+         * Doesn't move the cursor.
+         * With autodiscover only, open moves are not_allowed once the first field has been opened.
+         * @param moves moves to apply, in order
+         * @param results receives one result per move
+         * @param changed receives the fields changed since the last drain (incl. the whole batch), every field once
+         */
+        void applyMoves(const std::vector<Minefield::Move>& moves, std::vector<Minefield::MoveResult>& results, std::vector<std::tuple<int, int>>& changed);
+
         /**
          * Returns the current mine field.
+         * Only a read-only reference is returned, so querying the minefield doesn't copy the board.
+         * The reference stays valid as long as the controller exists.
          * @return the used minefield
          */
-        Minefield getMinefield();
+        const Minefield& getMinefield() const;
 };
 
 #endif //__CONTROLLER_H_INCLUDED__
@@ -9,75 +9,145 @@
 #include <algorithm>
 #include <exception>
 #include <cmath>
+#include <cstdlib>
 #include <limits>
 
 // mention here for linker
 const struct msgs_struct Display::msgs;
 
+void Display::renderField(int x, int y) {
+    if (state[x][y] != last_state[x][y]) {
+        int color;
+        char to_print;
+        std::tie(color, to_print) = state[x][y];
+
+        io->setColor(color);
+
+        int x_to_print, y_to_print;
+        std::tie(x_to_print, y_to_print) = getConsolePosition(x, y);
+        io->putString(x_to_print, y_to_print, to_print);
+
+        last_state[x][y] = state[x][y];
+    }
+}
+
 void Display::renderBoard() {
-    auto mfield = controller.getMinefield();
-    for (int x = 0; x < mfield.getXDimension(); x++) {
-        for (int y = 0; y < mfield.getYDimension(); y++) {
-            if (state[x][y] != last_state[x][y]) {
-                int color;
-                char to_print;
-                std::tie(color, to_print) = state[x][y];
+    for (auto& cell : changed_cells) {
+        int x = std::get<0>(cell) - view_x;
+        int y = std::get<1>(cell) - view_y;
+        if (0 <= x && x < view_width && 0 <= y && y < view_height) {
+            renderField(x, y);
+        }
+    }
+}
 
-                io->setColor(color);
+void Display::renderEntireBoard() {
+    for (int y = 0; y < view_height; y++) {
+        for (int x = 0; x < view_width; x++) {
+            renderField(x, y);
+        }
+    }
+}
 
-                int x_to_print, y_to_print;
-                std::tie(x_to_print, y_to_print) = getConsolePosition(x, y);
-                io->putString(x_to_print, y_to_print, to_print);
+std::tuple<int, char> Display::calculateState(int x, int y) {
+    const Minefield& mfield = controller.getMinefield();
+
+    char to_print;
+    int color;
+    if (mfield.isOpen(x, y)) {
+        auto sourrounding_mine_count = mfield.getSorroundingMineCount(x, y);
+        color = sourrounding_mine_count;
+        to_print = std::to_string(sourrounding_mine_count).c_str()[0];
+        if ('0' == to_print) {
+            to_print = ' ';
+        }
 
-                last_state[x][y] = state[x][y];
-            }
+        if (mfield.isMine(x, y)) {
+            color = 11;
+            to_print = 'X';
+        }
+    } else if (mfield.isGameLost() && mfield.isMine(x, y) && !mfield.isFlagged(x, y)) {
+        // mark only unflagged mines
+        color = 11;
+        to_print = 'X';
+    } else if (mfield.isFlagged(x, y)) {
+        color = 0;
+        to_print = '?';
+        if (mfield.isGameEnded() && !mfield.isMine(x, y)) {
+            // incorrect mine -> make red
+            color = 11;
         }
+    } else {
+        color = 10;
+        to_print = '*';
     }
+
+    return std::make_tuple(color, to_print);
 }
 
 void Display::calculateStates() {
-    auto mfield = controller.getMinefield();
-    
-    for (int x = 0; x < mfield.getXDimension(); x++) {
-        for (int y = 0; y < mfield.getYDimension(); y++) {
-            char to_print;
-            int color;
-            if (mfield.isOpen(x, y)) {
-                auto sourrounding_mine_count = mfield.getSorroundingMineCount(x, y);
-                color = sourrounding_mine_count;
-                to_print = std::to_string(sourrounding_mine_count).c_str()[0];
-                if ('0' == to_print) {
-                    to_print = ' ';
-                }
-
-                if (mfield.isMine(x, y)) {
-                    color = 11;
-                    to_print = 'X';
-                }
-            } else if (mfield.isGameLost() && mfield.isMine(x, y) && !mfield.isFlagged(x, y)) {
-                // mark only unflagged mines
-                color = 11;
-                to_print = 'X';
-            } else if (mfield.isFlagged(x, y)) {
-                color = 0;
-                to_print = '?';
-                if (mfield.isGameEnded() && !mfield.isMine(x, y)) {
-                    // incorrect mine -> make red
-                    color = 11;
-                }
-            } else {
-                color = 10;
-                to_print = '*';
-            }
+    // only fields changed since the last frame have to be recalculated
+    controller.drainChangedCells(changed_cells);
+    solver_changed_cells.insert(solver_changed_cells.end(), changed_cells.begin(), changed_cells.end());
+    if (std::max<std::size_t>(2 * solver_unique_cells, 1024) < solver_changed_cells.size()) {
+        std::sort(solver_changed_cells.begin(), solver_changed_cells.end());
+        solver_changed_cells.erase(std::unique(solver_changed_cells.begin(), solver_changed_cells.end()), solver_changed_cells.end());
+        solver_unique_cells = solver_changed_cells.size();
+    }
 
-            auto tuple_to_print = std::make_tuple(color, to_print);
-            if (state[x][y] != tuple_to_print) {
-                state[x][y] = tuple_to_print;
-            }
+    for (auto& cell : changed_cells) {
+        int x = std::get<0>(cell) - view_x;
+        int y = std::get<1>(cell) - view_y;
+        if (0 <= x && x < view_width && 0 <= y && y < view_height) {
+            state[x][y] = calculateState(view_x + x, view_y + y);
         }
     }
 }
 
+void Display::resizeViewport() {
+    if (controller.getMinefield().isUnbounded()) {
+        // fill the window, except for the status lines (every field is two columns wide)
+        view_width = io->getWidth() / 2;
+        view_height = io->getHeight() - 3;
+        view_x = controller.getX() - view_width / 2;
+        view_y = controller.getY() - view_height / 2;
+    } else {
+        view_x = 0;
+        view_y = 0;
+        view_width = controller.getWidth();
+        view_height = controller.getHeight();
+    }
+
+    // last state is set to an invalid color & char, so everything is drawn on the next frame
+    state.assign(view_width, std::vector<std::tuple<int, char>>(view_height));
+    last_state.assign(view_width, std::vector<std::tuple<int, char>>(view_height, std::make_tuple(-1, ';')));
+    for (int x = 0; x < view_width; x++) {
+        for (int y = 0; y < view_height; y++) {
+            state[x][y] = calculateState(view_x + x, view_y + y);
+        }
+    }
+}
+
+void Display::followCursor() {
+    int cursor_x = controller.getX() - view_x;
+    int cursor_y = controller.getY() - view_y;
+    if (0 <= cursor_x && cursor_x < view_width && 0 <= cursor_y && cursor_y < view_height) {
+        return;
+    }
+
+    // only happens on unbounded boards
+    view_x = controller.getX() - view_width / 2;
+    view_y = controller.getY() - view_height / 2;
+    for (int x = 0; x < view_width; x++) {
+        for (int y = 0; y < view_height; y++) {
+            state[x][y] = calculateState(view_x + x, view_y + y);
+        }
+    }
+
+    // only fields that look different are printed
+    renderEntireBoard();
+}
+
 std::tuple<int, int> Display::getConsolePosition(int x, int y) {
     return std::make_tuple(1 + x * 2, y);
 }
@@ -90,7 +160,7 @@ bool replace(std::string& str, const std::string& from, const std::string& to) {
     return true;
 }
 
-int Display::getMaxTextWidth(int mine_count) {
+int Display::getMaxTextWidth(std::int64_t mine_count) {
     if (mine_count < 0) {
         throw std::runtime_error("can't display mine counts < 0");
     }
@@ -105,6 +175,11 @@ int Display::getMaxTextWidth(int mine_count) {
 
     all_lengths.push_back(max_remaining_mines.length());
 
+    auto max_placed_flags = msgs.placed_flags;
+    replace(max_placed_flags, "%flag_count%", std::to_string(mine_count));
+
+    all_lengths.push_back(max_placed_flags.length());
+
     auto result = std::max_element(all_lengths.begin(), all_lengths.end());
     auto max_index = std::distance(all_lengths.begin(), result);
     
@@ -118,15 +193,22 @@ void Display::renderStatusline() {
 
     std::string remaining_mines_number_only;
 
-    auto mfield = controller.getMinefield();
-    if (mfield.isGameWon() || mfield.getFlagCount() > mfield.getMineCount()) {
-        remaining_mines_number_only = "0";
+    const Minefield& mfield = controller.getMinefield();
+    // unbounded boards have infinitely many mines -> show the placed flags instead
+    int max_text_width = getMaxTextWidth(mfield.isUnbounded() ? std::numeric_limits<int>::max() : mfield.getMineCount());
+    if (mfield.isUnbounded()) {
+        remaining_mines = msgs.placed_flags;
+        replace(remaining_mines, "%flag_count%", std::to_string(mfield.getFlagCount()));
     } else {
-        remaining_mines_number_only = std::to_string(mfield.getMineCount() - mfield.getFlagCount());
-    }
+        if (mfield.isGameWon() || mfield.getFlagCount() > mfield.getMineCount()) {
+            remaining_mines_number_only = "0";
+        } else {
+            remaining_mines_number_only = std::to_string(mfield.getMineCount() - mfield.getFlagCount());
+        }
 
-    remaining_mines = msgs.remaining_mines;
-    replace(remaining_mines, "%mine_count%", remaining_mines_number_only);
+        remaining_mines = msgs.remaining_mines;
+        replace(remaining_mines, "%mine_count%", remaining_mines_number_only);
+    }
 
     if (mfield.isGameRunning()) {
         color_to_use = 12;
@@ -142,26 +224,82 @@ void Display::renderStatusline() {
     }
 
     int x, y;
-    std::tie(x, y) = getConsolePosition(0, mfield.getYDimension() + 1);
+    std::tie(x, y) = getConsolePosition(0, view_height + 1);
 
     io->setColor(0);
-    io->putString(x, y, std::string(getMaxTextWidth(mfield.getMineCount()), ' '));
+    io->putString(x, y, std::string(max_text_width, ' '));
 
     io->setColor(color_to_use);
     io->putString(x, y, game_state);
 
-    std::tie(x, y) = getConsolePosition(0, mfield.getYDimension() + 2);
+    std::tie(x, y) = getConsolePosition(0, view_height + 2);
     io->setColor(0);
-    io->putString(x, y, std::string(getMaxTextWidth(mfield.getMineCount()), ' '));
+    io->putString(x, y, std::string(max_text_width, ' '));
     io->setColor(12);
     io->putString(x, y, remaining_mines);
 }
 
+void Display::showHint() {
+    const Minefield& mfield = controller.getMinefield();
+    if (! mfield.isGameRunning()) {
+        return;
+    }
+
+    solver.update(mfield, solver_changed_cells);
+    solver_changed_cells.clear();
+    solver_unique_cells = 0;
+
+    std::vector<std::tuple<int, int>> candidates;
+    solver.getSafeFields(candidates);
+    if (candidates.empty()) {
+        std::vector<std::tuple<int, int>> mines;
+        solver.getMines(mines);
+        for (auto& mine : mines) {
+            if (! mfield.isFlagged(std::get<0>(mine), std::get<1>(mine))) {
+                candidates.push_back(mine);
+            }
+        }
+    }
+
+    // closest to the cursor (in moves)
+    bool found = false;
+    int best_x = 0, best_y = 0;
+    std::int64_t best_distance = 0;
+    for (auto& candidate : candidates) {
+        std::int64_t distance = std::abs(static_cast<std::int64_t>(std::get<0>(candidate)) - controller.getX()) + std::abs(static_cast<std::int64_t>(std::get<1>(candidate)) - controller.getY());
+        if (! found || distance < best_distance) {
+            std::tie(best_x, best_y) = candidate;
+            best_distance = distance;
+            found = true;
+        }
+    }
+    if (found) {
+        controller.putCursor(best_x, best_y);
+    } else if (! mfield.isUnbounded()) {
+        // the probabilities may take a while, the player can keep playing meanwhile
+        hint_worker.request(mfield, controller.getX(), controller.getY());
+    }
+}
+
+void Display::showGuess() {
+    HintWorker::Hint hint;
+    if (hint_worker.takeHint(hint)) {
+        controller.putCursor(hint.x, hint.y);
+    }
+}
+
 int Display::getKey() {
     return io->getChar();
 }
 
 void Display::handleKey(int key) {
+    if (IODevice::WAKE_KEY == key) {
+        showGuess();
+        return;
+    }
+    // the player has moved on, a guess for the previous state is of no use anymore
+    hint_worker.cancel();
+
     if ('q' == key || 'Q' == key) {
         pressed_keys.push_back('q');
         exit = true;
@@ -183,18 +321,33 @@ void Display::handleKey(int key) {
     } else if ('f' == key || 'F' == key) {
         pressed_keys.push_back('f');
         controller.tooggleFlag();
+    } else if ('u' == key || 'U' == key) {
+        pressed_keys.push_back('u');
+        controller.undo();
+    } else if ('y' == key || 'Y' == key) {
+        pressed_keys.push_back('y');
+        controller.redo();
+    } else if ('?' == key) {
+        pressed_keys.push_back('?');
+        showHint();
     } else if ('r' == key || 'R' == key) {
         pressed_keys.push_back('r');
         redrawWindow();
     } else if (KEY_RESIZE == key) {
         pressed_keys.push_back('-');
         checkWindowSize();
+        if (controller.getMinefield().isUnbounded()) {
+            // the viewport always fills the window
+            resizeViewport();
+            io->clear();
+            renderEntireBoard();
+        }
     }
 }
 
 void Display::updateCursor() {
     int x, y;
-    std::tie(x, y) = getConsolePosition(controller.getX(), controller.getY());
+    std::tie(x, y) = getConsolePosition(controller.getX() - view_x, controller.getY() - view_y);
     io->moveCursor(x, y);
 
     if (controller.getMinefield().isGameEnded()) {
@@ -204,14 +357,14 @@ void Display::updateCursor() {
     }
 }
 
-bool Display::isWindowSizeSufficient(int field_width, int field_height, int mine_count, int window_width, int window_height) {
+bool Display::isWindowSizeSufficient(int field_width, int field_height, std::int64_t mine_count, int window_width, int window_height) {
     int required_width, required_height;
     std::tie(required_width, required_height) = getRequiredWindowSize(field_width, field_height, mine_count);
 
     return (window_height >= required_height && window_width >= required_width);
 }
 
-std::tuple<int, int> Display::getRequiredWindowSize(int field_width, int field_height, int mine_count) {
+std::tuple<int, int> Display::getRequiredWindowSize(int field_width, int field_height, std::int64_t mine_count) {
     int required_width = field_width;
     int required_height = field_height;
 
@@ -241,7 +394,13 @@ std::tuple<int, int> Display::getRequiredWindowSize(int field_width, int field_h
 void Display::checkWindowSize() {
     int minefield_width = controller.getWidth();
     int minefield_height = controller.getHeight();
-    int mine_count = controller.getMinefield().getMineCount();
+    std::int64_t mine_count = controller.getMinefield().getMineCount();
+    if (controller.getMinefield().isUnbounded()) {
+        // the viewport adapts to the window, at least one field has to fit
+        minefield_width = 1;
+        minefield_height = 1;
+        mine_count = std::numeric_limits<int>::max();
+    }
 
     if (!isWindowSizeSufficient(minefield_width, minefield_height, mine_count, io->getWidth(), io->getHeight())) {
         int required_width, required_height;
@@ -251,8 +410,8 @@ void Display::checkWindowSize() {
 }
 
 void Display::redrawWindow() {
-    for (int x = 0; x < controller.getWidth(); x++) {
-        for (int y = 0; y < controller.getHeight(); y++) {
+    for (int x = 0; x < view_width; x++) {
+        for (int y = 0; y < view_height; y++) {
             // set to invalid color & invalid char
             // => redrawn on window update
             last_state[x][y] = std::make_tuple(-1, ';');
@@ -264,7 +423,7 @@ void Display::redrawWindow() {
     io->endWindow();
     startWindow();
 
-    renderBoard();
+    renderEntireBoard();
     renderStatusline();
     updateCursor();
 }
@@ -307,12 +466,16 @@ void Display::startWindow() {
 }
 
 void Display::run() {
+    // initial rendering, afterwards only changed fields are rendered
+    renderEntireBoard();
+
     while(!exit) {
         // rendering process
     if (!io) {
         throw std::runtime_error("OMG io is NULL");
     }
         io->setCursorVisibility(0);
+        followCursor();
         calculateStates();
         renderBoard();
         renderStatusline();
@@ -321,26 +484,23 @@ void Display::run() {
     }
 }
 
-Display::Display(std::shared_ptr<IODevice> given_iodevice, int width, int height, int mine_count, int seed, bool autodiscover_only) {
-    controller = Controller(width, height, mine_count, seed, autodiscover_only);
-    controller.putCursor((width - 1) / 2, (height - 1) / 2); // zero indexed, so subtract one before dividing
+Display::Display(std::shared_ptr<IODevice> given_iodevice, int width, int height, std::int64_t mine_count, std::int64_t seed, bool autodiscover_only) : Display(given_iodevice, Controller(width, height, mine_count, seed, autodiscover_only)) {
+}
+
+Display::Display(std::shared_ptr<IODevice> given_iodevice, const Controller& given_controller) : hint_worker([given_iodevice] { given_iodevice->wake(); }) {
+    controller = given_controller;
+    if (! controller.getMinefield().isUnbounded()) {
+        controller.putCursor((controller.getWidth() - 1) / 2, (controller.getHeight() - 1) / 2); // zero indexed, so subtract one before dividing
+    }
     exit = false;
+    solver_unique_cells = 0;
 
     io = given_iodevice;
 
-    // init state vars
-    for (int x = 0; x < width; x++) {
-        std::vector<std::tuple<int, char>> column;
-        for (int y = 0; y < height; y++) {
-            column.push_back(std::make_tuple(0, '*'));
-        }
-        state.push_back(column);
-    }
-    
-    last_state = state;
-
     try {
         startWindow();
+        // init state vars (unbounded boards need the window size for that)
+        resizeViewport();
         run();
         // clear window, so not the entire screen is filled w/ the field after quitting
         io->clear();
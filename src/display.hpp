@@ -2,25 +2,30 @@
 #define __DIPLAY_H_INCLUDED__
 
 #include "controller.hpp"
+#include "hint_worker.hpp"
 #include "iodevice.hpp"
+#include "solver.hpp"
 
 #include <tuple>
 #include <string>
 #include <vector>
 #include <exception>
 #include <memory>
+#include <cstdint>
 
 struct msgs_struct {
     std::string won;
     std::string lost;
     std::string running;
     std::string remaining_mines;
+    std::string placed_flags;
 
     msgs_struct() {
         won = "won";
         lost = "lost";
         running = "live";
         remaining_mines = "%mine_count% mines remaining";
+        placed_flags = "%flag_count% flags placed";
     }
 };
 
@@ -33,17 +38,94 @@ class Display {
     private:
         Controller controller;
         bool exit;
+        /// how the fields of the viewport should be rendered, and how they have been rendered, indexed by viewport coordinates
         std::vector<std::vector<std::tuple<int, char>>> state, last_state;
         std::vector<char> pressed_keys;
+
+        /// fields changed since the last frame, as retrieved from the controller
+        std::vector<std::tuple<int, int>> changed_cells;
+
+        /// finds the fields shown as hint
+        /**
+         * Only updated when a hint is requested, w/ the fields changed since the last hint.
+         * @see showHint()
+         */
+        Solver solver;
+
+        /// fields changed since the solver has been updated last
+        /**
+         * Collected every frame, but only passed to the solver on hints:
+         * duplicates are removed whenever the list has doubled, so it stays in proportion to the fields actually changed.
+         */
+        std::vector<std::tuple<int, int>> solver_changed_cells;
+
+        /// size of solver_changed_cells after the last removal of duplicates
+        std::size_t solver_unique_cells;
         std::shared_ptr<IODevice> io;
 
+        /// board coordinates of the top left field of the viewport
+        /**
+         * Always (0, 0) on bounded boards, as the viewport covers the entire board.
+         * Unbounded boards move the viewport when the cursor leaves it.
+         */
+        int view_x, view_y;
+
+        /// size of the viewport (in fields)
         /**
-         * Renders the Board of the Game according to state var.
+         * The board size on bounded boards, as much as fits into the window on unbounded boards.
+         */
+        int view_width, view_height;
+
+        /// finds the best guess in the background, if the solver can't deduce anything
+        /**
+         * Wakes up io when done, every key other than IODevice::WAKE_KEY cancels it.
+         * Declared last, so its thread is joined before anything it may use is destroyed.
+         * @see showHint()
+         * @see showGuess()
+         */
+        HintWorker hint_worker;
+
+        /**
+         * Renders a single field according to state var, if it differs from what has been rendered last.
+         * @param x x coordinate inside of the viewport
+         * @param y y coordinate inside of the viewport
+         */
+        void renderField(int x, int y);
+
+        /**
+         * Renders the changed fields of the Board of the Game according to state var.
          */
         void renderBoard();
 
+        /**
+         * Renders every field of the Board of the Game according to state var.
+         */
+        void renderEntireBoard();
+
+        /**
+         * Calculates how a single field should be rendered.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return tuple (color, char) to be printed
+         */
+        std::tuple<int, char> calculateState(int x, int y);
+
+        /**
+         * Sets the viewport size and resets the state vars to it.
+         * Bounded boards use the board size, unbounded boards fill the window.
+         * Everything is rendered again on the next frame.
+         */
+        void resizeViewport();
+
+        /**
+         * Moves the viewport, so the cursor is centered, if the cursor has left it.
+         * Recalculates and renders all fields after moving.
+         */
+        void followCursor();
+
         /**
          * Calculates how the board should be rendered.
+         * Only fields reported as changed by the controller are recalculated.
          * Writes what to render into the state var.
          * Actually Print anything
          */
@@ -54,6 +136,19 @@ class Display {
          */
         void renderStatusline();
 
+        /**
+         * Moves the cursor to the closest field that is provably safe.
+         * If there is none, moves it to the closest provable mine w/o flag instead.
+         * If nothing can be deduced on a bounded board, the field least likely to be a mine is searched for in the background (see showGuess()).
+         */
+        void showHint();
+
+        /**
+         * Moves the cursor to the guess found in the background, if there is one.
+         * Called when the IODevice has been woken up.
+         */
+        void showGuess();
+
         /**
          * Gets a input Key
          * @return key code from curses
@@ -109,7 +204,15 @@ class Display {
          * @param seed seed for the RNG
          * @param autodiscover_only if enabled, fields cannot be opened directly
          */
-        Display(std::shared_ptr<IODevice> given_iodevice, int width, int height, int mine_count, int seed = 0, bool autodiscover_only = false);
+        Display(std::shared_ptr<IODevice> given_iodevice, int width, int height, std::int64_t mine_count, std::int64_t seed = 0, bool autodiscover_only = false);
+
+        /**
+         * Constructor for a given controller, e.g. one controlling an unbounded minefield. Automatically takes over the window. (Is blocking)
+         * On bounded minefields the cursor is placed in the center, on unbounded ones it is kept and the viewport is centered around it.
+         * @param given_iodevice an IO-device to read the controls from and display the output to
+         * @param given_controller the controller to play with
+         */
+        Display(std::shared_ptr<IODevice> given_iodevice, const Controller& given_controller);
 
         /**
          * Returns a copy of the used Controller
@@ -140,7 +243,7 @@ class Display {
          * Checks if a given window size is sufficient to display a given mine field.
          * @returns true if the given window size is sufficient for given mine field
          */
-        static bool isWindowSizeSufficient(int field_width, int field_height, int mine_count, int window_width, int window_height);
+        static bool isWindowSizeSufficient(int field_width, int field_height, std::int64_t mine_count, int window_width, int window_height);
 
         /**
          * Calculates the required window size for a given minefield
@@ -150,12 +253,12 @@ class Display {
          * @param mine_count amount of mines on the minefield
          * @return tuple (required width, required height) to display given minefield
          */
-        static std::tuple<int, int> getRequiredWindowSize(int field_width, int field_height, int mine_count);
+        static std::tuple<int, int> getRequiredWindowSize(int field_width, int field_height, std::int64_t mine_count);
 
         /**
          * Calculates and returns the width of the longest text (in the status bar)
          * @return width of the longest text
          */
-        static int getMaxTextWidth(int mine_count);
+        static int getMaxTextWidth(std::int64_t mine_count);
 };
 #endif //__DIPLAY_H_INCLUDED__
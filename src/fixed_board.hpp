@@ -0,0 +1,156 @@
+/// compile-time sized boards
+/** \file
+ * Contains the board generation for the classic minefield sizes, w/ the dimensions as template parameters.
+ * The generated cells use the same layout as the dense storage of the minefield (see board_planes.hpp),
+ * so the minefield can copy them over and continue w/ its regular code paths.
+ */
+#ifndef __FIXED_BOARD_HPP_INCLUDED__
+#define __FIXED_BOARD_HPP_INCLUDED__
+
+#include "board_planes.hpp"
+#include "neighbour_count.hpp"
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+/// Generates the cells of a board whose dimensions are known at compile time
+/**
+ * All storage lives in std::arrays (no heap allocations) and all loops have constant trip counts,
+ * so bounds checks and index math fold away.
+ * Boards are at most 64 cells wide, so every row is exactly one group.
+ *
+ * Placing the mines draws the exact same random numbers as the generic constructor of the minefield,
+ * therefore a seed results in the same board on both paths (see mine_placement.hpp).
+ * @tparam WIDTH amount of columns
+ * @tparam HEIGHT amount of rows
+ */
+template <int WIDTH, int HEIGHT>
+class FixedBoard {
+    static_assert(0 < WIDTH && WIDTH <= 64, "fixed boards must be 1 to 64 cells wide");
+    static_assert(0 < HEIGHT, "fixed boards must have at least one row");
+
+    public:
+        /// amount of cells on the board
+        static constexpr int CELL_COUNT = WIDTH * HEIGHT;
+
+        /// amount of words of the board, one group per row
+        static constexpr int WORD_COUNT = HEIGHT * PLANE_COUNT;
+
+        /// bits of a row word that lie on the board
+        static constexpr std::uint64_t ROW_MASK = (64 == WIDTH) ? ~std::uint64_t(0) : (std::uint64_t(1) << (WIDTH % 64)) - 1;
+
+        /// x offsets of the 8 sorrounding cells
+        static constexpr int NEIGHBOUR_DX[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+        /// y offsets of the 8 sorrounding cells
+        static constexpr int NEIGHBOUR_DY[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+        /// the cells of the board, row by row
+        std::array<std::uint64_t, WORD_COUNT> words;
+
+        /**
+         * Returns true if the given coordinates are on the board.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return true if the position is valid
+         */
+        static constexpr bool isPosValid(int x, int y) {
+            return 0 <= x && x < WIDTH && 0 <= y && y < HEIGHT;
+        }
+
+        /**
+         * Places the given amount of mines and calculates the sorrounding mine counts.
+         * @param mine_count amount of mines, 0..CELL_COUNT
+         * @param rdm_num_machine seeded random number generator
+         */
+        void generate(int mine_count, std::mt19937& rdm_num_machine) {
+            words.fill(0);
+            placeMines(mine_count, rdm_num_machine);
+            countMines();
+        }
+
+        /**
+         * Returns the amount of mines sorrounding the given cell, by looking at the neighbours one by one.
+         * Only used to cross check the word parallel calculation.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return amount of mines in the sorrounding cells
+         */
+        int countNeighbours(int x, int y) const {
+            int count = 0;
+            for (int i = 0; i < 8; i++) {
+                int current_x = x + NEIGHBOUR_DX[i];
+                int current_y = y + NEIGHBOUR_DY[i];
+                if (isPosValid(current_x, current_y)) {
+                    count += getGroupBit(&words[current_y * PLANE_COUNT], MINE_PLANE, current_x);
+                }
+            }
+            return count;
+        }
+
+    private:
+        /**
+         * Places the mines, using the same algorithm (and random numbers) as placeMines() in mine_placement.hpp.
+         * @param mine_count amount of mines
+         * @param rdm_num_machine seeded random number generator
+         */
+        void placeMines(int mine_count, std::mt19937& rdm_num_machine) {
+            // more mines than free cells -> pick the free cells
+            bool complement = 2 * mine_count > CELL_COUNT;
+            int pick_count = complement ? CELL_COUNT - mine_count : mine_count;
+            if (complement) {
+                for (int y = 0; y < HEIGHT; y++) {
+                    words[y * PLANE_COUNT + MINE_PLANE] = ROW_MASK;
+                }
+            }
+
+            std::array<int, CELL_COUNT> positions;
+            for (int i = 0; i < CELL_COUNT; i++) {
+                positions[i] = i;
+            }
+
+            std::uniform_int_distribution<> distr;
+            for (int random_min = 0; random_min < pick_count; random_min++) {
+                int chosen_index = distr(rdm_num_machine, std::uniform_int_distribution<>::param_type(random_min, CELL_COUNT - 1));
+                int chosen_pos = positions[chosen_index];
+
+                setGroupBit(&words[(chosen_pos / WIDTH) * PLANE_COUNT], MINE_PLANE, chosen_pos % WIDTH, ! complement);
+
+                positions[chosen_index] = positions[random_min];
+                positions[random_min] = chosen_pos;
+            }
+        }
+
+        /**
+         * Calculates the count planes of all rows, 64 cells at once.
+         */
+        void countMines() {
+            for (int y = 0; y < HEIGHT; y++) {
+                // a row is a single word -> no words to the left and right
+                std::uint64_t rows[3][3] = {
+                    {0, (0 < y) ? words[(y - 1) * PLANE_COUNT + MINE_PLANE] : 0, 0},
+                    {0, words[y * PLANE_COUNT + MINE_PLANE], 0},
+                    {0, (y + 1 < HEIGHT) ? words[(y + 1) * PLANE_COUNT + MINE_PLANE] : 0, 0},
+                };
+
+                std::uint64_t counts[4];
+                countNeighbourWords(rows[0], rows[1], rows[2], counts);
+
+                // the cell right of the board would receive a count, keep the padding empty
+                words[y * PLANE_COUNT + COUNT_PLANE_0] = counts[0] & ROW_MASK;
+                words[y * PLANE_COUNT + COUNT_PLANE_1] = counts[1] & ROW_MASK;
+                words[y * PLANE_COUNT + COUNT_PLANE_2] = counts[2] & ROW_MASK;
+                words[y * PLANE_COUNT + COUNT_PLANE_3] = counts[3] & ROW_MASK;
+            }
+        }
+};
+
+// mention here for linker
+template <int WIDTH, int HEIGHT>
+constexpr int FixedBoard<WIDTH, HEIGHT>::NEIGHBOUR_DX[8];
+
+template <int WIDTH, int HEIGHT>
+constexpr int FixedBoard<WIDTH, HEIGHT>::NEIGHBOUR_DY[8];
+
+#endif // __FIXED_BOARD_HPP_INCLUDED__
@@ -0,0 +1,126 @@
+/// visible constraints of a minefield
+/** \file
+ * Contains the function that reads the frontier of a minefield.
+ */
+#include "frontier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+std::uint64_t frontierKey(int x, int y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+std::tuple<int, int> frontierCoordinates(std::uint64_t field) {
+    return std::make_tuple(static_cast<int>(static_cast<std::uint32_t>(field >> 32)), static_cast<int>(static_cast<std::uint32_t>(field)));
+}
+
+double logBinomial(std::int64_t n, std::int64_t k) {
+    if (k < 0 || n < k) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+}
+
+Frontier readFrontier(const Minefield& mfield) {
+    Frontier frontier;
+    frontier.width = mfield.getXDimension();
+    int width = frontier.width;
+    int height = mfield.getYDimension();
+    frontier.open.assign(static_cast<std::size_t>(width) * height, false);
+    frontier.closed_count = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            frontier.open[static_cast<std::size_t>(y) * width + x] = mfield.isOpen(x, y);
+            frontier.closed_count += frontier.open[static_cast<std::size_t>(y) * width + x] ? 0 : 1;
+        }
+    }
+
+    // frontier fields and the open fields constraining them
+    // index into fields, by width * y + x
+    std::vector<int> indices(frontier.open.size(), -1);
+    std::vector<std::uint64_t> fields;
+    std::vector<std::vector<int>> constraint_fields;
+    std::vector<int> constraint_mines;
+    std::vector<std::vector<int>> constraints_of;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (! frontier.open[static_cast<std::size_t>(y) * width + x]) {
+                continue;
+            }
+
+            std::vector<int> closed;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int current_x = x + dx;
+                    int current_y = y + dy;
+                    if (! mfield.isPosValid(current_x, current_y) || frontier.open[static_cast<std::size_t>(current_y) * width + current_x]) {
+                        continue;
+                    }
+                    int& index = indices[static_cast<std::size_t>(current_y) * width + current_x];
+                    if (index < 0) {
+                        index = static_cast<int>(fields.size());
+                        fields.push_back(frontierKey(current_x, current_y));
+                        constraints_of.emplace_back();
+                    }
+                    closed.push_back(index);
+                }
+            }
+            if (! closed.empty()) {
+                for (int field : closed) {
+                    constraints_of[field].push_back(static_cast<int>(constraint_fields.size()));
+                }
+                constraint_fields.push_back(closed);
+                constraint_mines.push_back(mfield.getSorroundingMineCount(x, y));
+            }
+        }
+    }
+    frontier.interior_count = frontier.closed_count - static_cast<std::int64_t>(fields.size());
+
+    // components in breadth first order, so fields sharing open fields are close to each other
+    std::vector<int> local(fields.size(), -1);
+    std::vector<bool> constraint_seen(constraint_fields.size(), false);
+    for (std::size_t start = 0; start < fields.size(); start++) {
+        if (0 <= local[start]) {
+            continue;
+        }
+
+        FrontierComponent component;
+        std::vector<int> constraints;
+        local[start] = 0;
+        component.fields.push_back(fields[start]);
+        std::vector<int> queue(1, static_cast<int>(start));
+        for (std::size_t head = 0; head < queue.size(); head++) {
+            for (int c : constraints_of[queue[head]]) {
+                if (constraint_seen[c]) {
+                    continue;
+                }
+                constraint_seen[c] = true;
+                constraints.push_back(c);
+                for (int field : constraint_fields[c]) {
+                    if (local[field] < 0) {
+                        local[field] = static_cast<int>(component.fields.size());
+                        component.fields.push_back(fields[field]);
+                        queue.push_back(field);
+                    }
+                }
+            }
+        }
+        for (int c : constraints) {
+            std::vector<int> own;
+            for (int field : constraint_fields[c]) {
+                own.push_back(local[field]);
+            }
+            component.constraint_fields.push_back(own);
+            component.constraint_mines.push_back(constraint_mines[c]);
+        }
+        frontier.components.push_back(component);
+    }
+
+    std::stable_sort(frontier.components.begin(), frontier.components.end(), [](const FrontierComponent& a, const FrontierComponent& b) {
+        return a.fields.size() > b.fields.size();
+    });
+    return frontier;
+}
@@ -0,0 +1,73 @@
+/// visible constraints of a minefield
+/** \file
+ * Contains the function that turns what the player sees of a minefield into constraints on its closed fields,
+ * and the binomial weights used to combine them w/ the fields nobody sees.
+ * Shared by the probability engine and the monte carlo estimator.
+ */
+#ifndef __FRONTIER_HPP_INCLUDED__
+#define __FRONTIER_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+/// part of the frontier whose fields don't share open fields w/ the rest
+struct FrontierComponent {
+    /// packed coordinates of the fields (see frontierKey()), in breadth first order
+    std::vector<std::uint64_t> fields;
+    /// indices into fields, per open field
+    std::vector<std::vector<int>> constraint_fields;
+    /// amount of mines among constraint_fields, per open field
+    std::vector<int> constraint_mines;
+};
+
+/// closed fields next to open fields, and the open fields constraining them
+struct Frontier {
+    /// components, largest first
+    std::vector<FrontierComponent> components;
+    /// true for open fields, indexed by width * y + x
+    std::vector<bool> open;
+    /// width of the minefield
+    int width;
+    /// amount of closed fields
+    std::int64_t closed_count;
+    /// amount of closed fields w/o open neighbours
+    std::int64_t interior_count;
+};
+
+/**
+ * Packs coordinates into a single key.
+ * @param x x coordinate
+ * @param y y coordinate
+ * @return key of the field
+ */
+std::uint64_t frontierKey(int x, int y);
+
+/**
+ * Unpacks a key.
+ * @param field key of the field
+ * @return (x, y) coordinates of the field
+ */
+std::tuple<int, int> frontierCoordinates(std::uint64_t field);
+
+/**
+ * Returns log(binomial(n, k)), the amount of ways to place k mines on n fields.
+ * Used to weight the interior, as the amount itself overflows any floating point type on larger boards.
+ * @param n amount of fields
+ * @param k amount of mines
+ * @return natural logarithm of the binomial coefficient, -infinity if k is out of range
+ */
+double logBinomial(std::int64_t n, std::int64_t k);
+
+/**
+ * Reads the open fields and their amounts of sorrounding mines (flags are ignored).
+ * Every open field w/ closed neighbours is a constraint: its closed neighbours contain exactly its amount of sorrounding mines.
+ * Fields are in the same component if an open field sees both of them (transitively).
+ * @param mfield bounded minefield w/ a running game
+ * @return the frontier
+ */
+Frontier readFrontier(const Minefield& mfield);
+
+#endif // __FRONTIER_HPP_INCLUDED__
@@ -0,0 +1,176 @@
+/// background hint method bodies
+/** \file
+ * Contains the method bodies for the worker looking for the best guess in the background.
+ */
+#include "hint_worker.hpp"
+
+#include "monte_carlo.hpp"
+#include "probability.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+const std::size_t HintWorker::STATE_LIMIT = 100000;
+const double HintWorker::TIME_BUDGET = 200;
+
+HintWorker::HintWorker(std::function<void()> on_finished) : on_finished(on_finished), stopping(false), generation(0), has_request(false), busy(false), request_x(0), request_y(0), has_hint(false), hint{0, 0, 0} {
+}
+
+HintWorker::~HintWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        generation++;
+    }
+    changed.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void HintWorker::request(const Minefield& mfield, int x, int y) {
+    if (mfield.isUnbounded()) {
+        throw std::runtime_error("Hints in the background require a bounded minefield.");
+    }
+
+    // the snapshot shares the cells w/ the player's minefield, the next change of it copies them (see Minefield::isOnlyOwner())
+    Minefield snapshot = mfield;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+        has_request = true;
+        has_hint = false;
+        request_mfield = std::move(snapshot);
+        request_x = x;
+        request_y = y;
+        if (! thread.joinable()) {
+            thread = std::thread(&HintWorker::work, this);
+        }
+    }
+    changed.notify_all();
+}
+
+void HintWorker::cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    has_hint = false;
+    if (has_request) {
+        // drop the snapshot right away, so the player's minefield doesn't have to copy its cells on the next change
+        has_request = false;
+        request_mfield = Minefield();
+        changed.notify_all();
+    }
+}
+
+bool HintWorker::takeHint(Hint& into) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (! has_hint) {
+        return false;
+    }
+    has_hint = false;
+    into = hint;
+    return true;
+}
+
+void HintWorker::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] {
+        return ! has_request && ! busy;
+    });
+}
+
+void HintWorker::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] {
+            return stopping || has_request;
+        });
+        if (stopping) {
+            return;
+        }
+
+        std::uint64_t request_generation = generation;
+        Minefield mfield = std::move(request_mfield);
+        int x = request_x;
+        int y = request_y;
+        has_request = false;
+        busy = true;
+
+        lock.unlock();
+        Hint found;
+        bool is_found = false;
+        try {
+            is_found = findHint(mfield, x, y, request_generation, found);
+        } catch (std::exception&) {
+            // nothing to hint at (or out of memory), but the thread has to keep running
+        }
+        // release the snapshot before posting, the player's minefield may be changed in place again afterwards
+        mfield = Minefield();
+        lock.lock();
+
+        if (is_found && request_generation == generation) {
+            hint = found;
+            has_hint = true;
+            lock.unlock();
+            on_finished();
+            lock.lock();
+        }
+        busy = false;
+        changed.notify_all();
+    }
+}
+
+bool HintWorker::isSuperseded(std::uint64_t request_generation) const {
+    return request_generation != generation;
+}
+
+bool HintWorker::findHint(const Minefield& mfield, int x, int y, std::uint64_t request_generation, Hint& into) {
+    if (! mfield.isGameRunning()) {
+        return false;
+    }
+
+    auto superseded = [this, request_generation]() {
+        return isSuperseded(request_generation);
+    };
+    ProbabilityEngine engine;
+    engine.setStateLimit(STATE_LIMIT);
+    engine.setCancelCheck(superseded);
+    MonteCarloEstimator estimator;
+    estimator.setCancelCheck(superseded);
+    bool exact = engine.calculate(mfield);
+    if (isSuperseded(request_generation)) {
+        return false;
+    }
+    if (! exact) {
+        estimator.setTimeBudget(TIME_BUDGET);
+        estimator.estimate(mfield);
+        if (isSuperseded(request_generation)) {
+            return false;
+        }
+    }
+
+    // least likely to be a mine, ties broken by the distance to the cursor (in moves)
+    // equally likely fields may differ in the last bits, so close probabilities count as ties
+    const double tie = 1e-9;
+    bool found = false;
+    std::int64_t best_distance = 0;
+    for (int current_y = 0; current_y < mfield.getYDimension(); current_y++) {
+        for (int current_x = 0; current_x < mfield.getXDimension(); current_x++) {
+            if (mfield.isOpen(current_x, current_y) || mfield.isFlagged(current_x, current_y)) {
+                continue;
+            }
+
+            double probability = exact ? engine.getProbability(current_x, current_y) : estimator.getEstimate(current_x, current_y).probability;
+            std::int64_t distance = std::abs(static_cast<std::int64_t>(current_x) - x) + std::abs(static_cast<std::int64_t>(current_y) - y);
+            if (! found || probability < into.probability - tie || (probability <= into.probability + tie && distance < best_distance)) {
+                into = Hint{current_x, current_y, probability};
+                best_distance = distance;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
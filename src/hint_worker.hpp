@@ -0,0 +1,155 @@
+/// background hint class definition
+/** \file
+ * Contains the class definition for the worker looking for the best guess in the background.
+ */
+#ifndef __HINT_WORKER_HPP_INCLUDED__
+#define __HINT_WORKER_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/// Finds the field least likely to be a mine on a background thread
+/**
+ * Meant for hints when the Solver can't deduce anything: the exact probabilities may take a while on wide frontiers,
+ * so they are calculated on a snapshot of the minefield while the player keeps playing.
+ * Uses the ProbabilityEngine, if a component exceeds the state limit the MonteCarloEstimator w/ a fixed time budget instead.
+ *
+ * A single thread is started w/ the first request and handles one request at a time.
+ * Every request (and every call to cancel()) supersedes the previous one:
+ * a superseded calculation is stopped early (the engines check the generation while running), its result is discarded,
+ * and the callback is only invoked for results that can be taken.
+ */
+class HintWorker {
+    public:
+        /// best guess found by the worker
+        struct Hint {
+            /// x coordinate
+            int x;
+            /// y coordinate
+            int y;
+            /// (estimated) probability of the field being a mine
+            double probability;
+        };
+
+        /// state limit passed to the ProbabilityEngine
+        static const std::size_t STATE_LIMIT;
+
+        /// time budget (in ms) of the MonteCarloEstimator, if the state limit is exceeded
+        static const double TIME_BUDGET;
+
+        /**
+         * Creates a new worker, w/o starting its thread.
+         * @param on_finished invoked on the worker thread after a hint can be taken, must be thread-safe
+         */
+        explicit HintWorker(std::function<void()> on_finished);
+
+        /**
+         * Cancels the current request and waits for the thread to finish.
+         */
+        ~HintWorker();
+
+        HintWorker(const HintWorker&) = delete;
+        HintWorker& operator=(const HintWorker&) = delete;
+
+        /**
+         * Requests the best guess on the given minefield, superseding any previous request.
+         * The minefield is copied (sharing its cells until either copy changes), so it may be changed right away.
+         * Ties are broken by the distance to the given position (in moves).
+         * @param mfield bounded minefield w/ a running game
+         * @param x x coordinate of the cursor
+         * @param y y coordinate of the cursor
+         * @throws std::runtime_error if the minefield is unbounded
+         */
+        void request(const Minefield& mfield, int x, int y);
+
+        /**
+         * Discards the current request and any hint not taken yet.
+         * A calculation already in progress is stopped early, its result is dropped.
+         */
+        void cancel();
+
+        /**
+         * Takes the hint of the last request, if it has been found.
+         * @param into set to the hint, if there is one
+         * @return true if a hint has been taken, false if there is none (yet)
+         */
+        bool takeHint(Hint& into);
+
+        /**
+         * Blocks until the current request has been handled (or discarded).
+         */
+        void wait();
+
+    private:
+        /// invoked after a hint can be taken
+        std::function<void()> on_finished;
+
+        /// the thread handling the requests, started w/ the first request
+        std::thread thread;
+
+        /// guards all members below (generation is only changed while holding it, but may be read w/o)
+        std::mutex mutex;
+
+        /// notified on new requests, when a request has been handled, and when stopping
+        std::condition_variable changed;
+
+        /// set by the destructor
+        bool stopping;
+
+        /// incremented by every request and every cancellation, results of other generations are discarded
+        /**
+         * Atomic, so the running calculation can check it w/o locking (see isSuperseded()).
+         */
+        std::atomic<std::uint64_t> generation;
+
+        /// true if there is a request the thread hasn't picked up yet
+        bool has_request;
+
+        /// true while the thread handles a request
+        bool busy;
+
+        /// snapshot of the requested minefield
+        Minefield request_mfield;
+
+        /// cursor position of the request
+        int request_x, request_y;
+
+        /// true if hint belongs to the current generation and hasn't been taken yet
+        bool has_hint;
+
+        /// last hint found
+        Hint hint;
+
+        /**
+         * Handles requests until stopped, runs on the worker thread.
+         */
+        void work();
+
+        /**
+         * Returns true if a request of the given generation has been superseded.
+         * Doesn't lock, so it is cheap enough to be checked often while calculating.
+         * @param request_generation generation of the request
+         * @return true if the result is going to be discarded
+         */
+        bool isSuperseded(std::uint64_t request_generation) const;
+
+        /**
+         * Finds the closed field w/o flag least likely to be a mine.
+         * @param mfield bounded minefield w/ a running game
+         * @param x x coordinate of the cursor
+         * @param y y coordinate of the cursor
+         * @param request_generation generation of the request, the calculation is stopped early once superseded
+         * @param into set to the best guess
+         * @return true if a field has been found
+         */
+        bool findHint(const Minefield& mfield, int x, int y, std::uint64_t request_generation, Hint& into);
+};
+
+#endif // __HINT_WORKER_HPP_INCLUDED__
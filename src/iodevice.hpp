@@ -7,14 +7,25 @@ class IODevice {
     public:
         virtual ~IODevice() {} 
 
+        /// returned by getChar() after wake() has been called, no key uses this code
+        enum : int { WAKE_KEY = -2 };
+
         /**
          * Returns a pressed key to be handled by the display class.  
-         * Is blocking.
+         * Is blocking, until a key is pressed or wake() is called.
          * Note: Returned as int for compatibility to curses KEY_ consts
-         * @returns the pressed key
+         * @returns the pressed key, WAKE_KEY if woken up
          */
         virtual int getChar() = 0;
 
+        /**
+         * Makes a (current or future) call to getChar() return WAKE_KEY, e.g. when a background computation has finished.
+         * Several calls before getChar() returns may be merged into one WAKE_KEY.
+         *
+         * Note: The only method that may be called from other threads.
+         */
+        virtual void wake() = 0;
+
         /**
          * Sets the print color to a predefined color pair
          * @param colorCode a given color code
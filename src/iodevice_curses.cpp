@@ -1,10 +1,63 @@
 #include "iodevice_curses.hpp"
 
 #include <curses.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
 #include <string>
+#include <unistd.h>
+
+IODeviceCurses::IODeviceCurses() {
+    if (0 != pipe(wake_pipe)) {
+        throw std::runtime_error("Can't create the wake pipe.");
+    }
+    for (int fd : wake_pipe) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+}
+
+IODeviceCurses::~IODeviceCurses() {
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+}
+
+bool IODeviceCurses::drainWakePipe() {
+    bool woken = false;
+    char buffer[64];
+    while (0 < read(wake_pipe[0], buffer, sizeof(buffer))) {
+        woken = true;
+    }
+    return woken;
+}
 
 int IODeviceCurses::getChar() {
-    return getch();
+    while (true) {
+        // curses may have read more than one key from stdin already, these don't show up in poll()
+        nodelay(stdscr, TRUE);
+        int key = getch();
+        nodelay(stdscr, FALSE);
+        if (ERR != key) {
+            return key;
+        }
+        if (drainWakePipe()) {
+            return WAKE_KEY;
+        }
+
+        // sleep until either is readable, interrupted by signals (e.g. SIGWINCH, turned into KEY_RESIZE by getch())
+        struct pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+        if (0 > poll(fds, 2, -1) && EINTR != errno) {
+            throw std::runtime_error("Can't wait for input.");
+        }
+    }
+}
+
+void IODeviceCurses::wake() {
+    // if the pipe is full (EAGAIN), there is a pending wake already
+    char byte = 0;
+    while (0 > write(wake_pipe[1], &byte, 1) && EINTR == errno) {
+    }
 }
 
 void IODeviceCurses::setColor(int colorCode) {
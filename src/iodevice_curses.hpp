@@ -6,8 +6,30 @@
 #include <iostream>
 
 class IODeviceCurses: public IODevice {
+    private:
+        /// self-pipe: wake() writes to [1], getChar() polls [0] next to stdin
+        int wake_pipe[2];
+
+        /**
+         * Reads everything written to the wake pipe.
+         * @returns true if wake() has been called since the last drain
+         */
+        bool drainWakePipe();
+
     public:
+        /**
+         * Creates the wake pipe.
+         * @throws std::runtime_error if the pipe can't be created
+         */
+        IODeviceCurses();
+
+        ~IODeviceCurses();
+
+        IODeviceCurses(const IODeviceCurses&) = delete;
+        IODeviceCurses& operator=(const IODeviceCurses&) = delete;
+
         int getChar();
+        void wake();
         void setColor(int colorCode);
         void putString(int x, int y, std::string to_print);
         void moveCursor(int x, int y);
@@ -7,6 +7,7 @@
 #include <map>
 #include <tuple>
 #include <algorithm>
+#include <chrono>
 #include <curses.h>
 
 void IODeviceSimulation::checkColorMode() {
@@ -29,6 +30,15 @@ int IODeviceSimulation::getChar() {
     c = input.front();
     input.pop_front();
 
+    if (WAIT_FOR_WAKE == c) {
+        std::unique_lock<std::mutex> lock(wake_state->mutex);
+        if (! wake_state->woken.wait_for(lock, std::chrono::milliseconds(WAKE_TIMEOUT), [this] { return 0 < wake_state->pending; })) {
+            throw std::runtime_error("Waited for a wake in vain.");
+        }
+        wake_state->pending--;
+        return WAKE_KEY;
+    }
+
     // KEY_RESIZE
     if (mockRemaining > 0 && KEY_RESIZE == c) {
         mockRemaining = 0;
@@ -36,6 +46,14 @@ int IODeviceSimulation::getChar() {
     return c;
 }
 
+void IODeviceSimulation::wake() {
+    {
+        std::lock_guard<std::mutex> lock(wake_state->mutex);
+        wake_state->pending++;
+    }
+    wake_state->woken.notify_all();
+}
+
 void IODeviceSimulation::addChar(int nextchar){
     input.push_back(nextchar);
 }
@@ -9,6 +9,9 @@
 #include <map>
 #include <tuple>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 /**
  * Can be used to simulate user Input and screen Output for 
@@ -24,6 +27,16 @@ class IODeviceSimulation: public IODevice {
          */
         std::list<int> input;
 
+        /// calls of wake() not yet delivered, shared between copies (as wake() is called through the copy the display uses)
+        struct WakeState {
+            std::mutex mutex;
+            std::condition_variable woken;
+            int pending = 0;
+        };
+
+        /// wake() calls, delivered at WAIT_FOR_WAKE
+        std::shared_ptr<WakeState> wake_state = std::make_shared<WakeState>();
+
         /// foreground colors
         std::vector<std::vector<int>> foreground;
 
@@ -114,6 +127,16 @@ class IODeviceSimulation: public IODevice {
         void checkWindowActive();
 
     public:
+        /// input that blocks getChar() until wake() has been called, then returns WAKE_KEY
+        /**
+         * Wakes are only delivered at this input (so the keys handled before are deterministic),
+         * every wake() is delivered at the next WAIT_FOR_WAKE.
+         */
+        enum : int { WAIT_FOR_WAKE = -3 };
+
+        /// how long getChar() waits at WAIT_FOR_WAKE before throwing, in ms
+        enum : int { WAKE_TIMEOUT = 10000 };
+
         // methods for input simulation content
 
         /**
@@ -277,7 +300,12 @@ class IODeviceSimulation: public IODevice {
 
         // methods from interface
 
+        /**
+         * Returns the next added char.
+         * @throws std::runtime_error if no wake() has been called WAKE_TIMEOUT ms after reaching WAIT_FOR_WAKE
+         */
         int getChar();
+        void wake();
         void setColor(int colorCode);
         void putString(int x, int y, std::string to_print);
         void moveCursor(int x, int y);
@@ -0,0 +1,53 @@
+/// mine placement method bodies
+/** \file
+ * Contains the method bodies for the mine placement.
+ */
+#include "mine_placement.hpp"
+
+#include <unordered_map>
+
+MinePlacement placeMines(int cell_count, int mine_count, std::mt19937& rdm_num_machine) {
+    MinePlacement placement;
+    placement.complement = 2 * static_cast<long long>(mine_count) > cell_count;
+    int pick_count = placement.complement ? cell_count - mine_count : mine_count;
+    placement.positions.reserve(pick_count);
+
+    std::uniform_int_distribution<> distr;
+
+    // partial Fisher-Yates over the list 0..cell_count-1:
+    // when many cells are picked, store the entire list (cheaper than hashing)
+    if (static_cast<long long>(pick_count) * PLACEMENT_DENSE_LIST_FACTOR >= cell_count) {
+        std::vector<int> list(cell_count);
+        for (int i = 0; i < cell_count; i++) {
+            list[i] = i;
+        }
+        for (int random_min = 0; random_min < pick_count; random_min++) {
+            int chosen_index = distr(rdm_num_machine, std::uniform_int_distribution<>::param_type(random_min, cell_count - 1));
+            placement.positions.push_back(list[chosen_index]);
+            list[chosen_index] = list[random_min];
+        }
+        return placement;
+    }
+
+    // otherwise the list is only stored where it differs from the identity (entries swapped to the back)
+    std::unordered_map<int, int> swapped;
+    swapped.reserve(pick_count);
+    auto entry = [&swapped](int index) {
+        auto found = swapped.find(index);
+        return (swapped.end() == found) ? index : found->second;
+    };
+
+    for (int random_min = 0; random_min < pick_count; random_min++) {
+        int chosen_index = distr(rdm_num_machine, std::uniform_int_distribution<>::param_type(random_min, cell_count - 1));
+        int chosen_pos = entry(chosen_index);
+
+        // swap: chosen spot <-> first item in range (the first item is never looked at again)
+        int first_pos = entry(random_min);
+        swapped[chosen_index] = first_pos;
+        swapped.erase(random_min);
+
+        placement.positions.push_back(chosen_pos);
+    }
+
+    return placement;
+}
@@ -0,0 +1,47 @@
+/// mine placement for the dense storage
+/** \file
+ * Contains the function that picks the mine positions of dense minefields.
+ * The mapping from seed to layout is versioned, see doc/placement.md.
+ */
+#ifndef __MINE_PLACEMENT_HPP_INCLUDED__
+#define __MINE_PLACEMENT_HPP_INCLUDED__
+
+#include <random>
+#include <vector>
+
+/// version of the mapping from seed to mine layout
+/**
+ * Increased whenever a seed results in a different layout than before.
+ * See doc/placement.md for the history.
+ */
+const int PLACEMENT_VERSION = 2;
+
+/// the entire list of cells is stored if at least 1/PLACEMENT_DENSE_LIST_FACTOR of the cells are picked
+/**
+ * Both ways draw the same random numbers and result in the same layout, this only trades memory for speed.
+ */
+const int PLACEMENT_DENSE_LIST_FACTOR = 16;
+
+/// result of the mine placement
+struct MinePlacement {
+    /// if set, positions lists the cells w/o mine, all other cells are mines
+    bool complement;
+
+    /// picked cells, encoded as width * y + x
+    std::vector<int> positions;
+};
+
+/**
+ * Picks the mine positions of a board w/ the given amount of cells.
+ * Draws a partial Fisher-Yates shuffle of all cell indices, but only remembers the swapped entries,
+ * so memory is proportional to the amount of picked cells instead of the amount of cells.
+ * If many cells are picked the entire list is stored instead, see PLACEMENT_DENSE_LIST_FACTOR.
+ * If more than half of the cells are mines, the cells w/o mines are picked instead (complement sampling).
+ * @param cell_count amount of cells on the board
+ * @param mine_count amount of mines, 0..cell_count
+ * @param rdm_num_machine seeded random number generator
+ * @return the picked cells
+ */
+MinePlacement placeMines(int cell_count, int mine_count, std::mt19937& rdm_num_machine);
+
+#endif // __MINE_PLACEMENT_HPP_INCLUDED__
@@ -4,20 +4,81 @@
  */
 #include "minefield.hpp"
 
+#include "fixed_board.hpp"
+#include "mine_placement.hpp"
+#include "neighbour_count.hpp"
+
 #include <vector>
 #include <stdexcept>
 #include <tuple>
 #include <random>
+#include <string>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 #include <functional>
+#include <thread>
+
+const std::int64_t Minefield::CHUNKED_THRESHOLD;
+const int Minefield::UNBOUNDED_LIMIT;
+const int Minefield::MIN_UNBOUNDED_DENSITY;
+const std::int64_t Minefield::BITWISE_EXPANSION_THRESHOLD;
+
+/**
+ * Returns the random key of a field in the given visible state, used for the state hash.
+ * Derived from the position (splitmix64 finalizer), so no table is needed, also on unbounded boards.
+ * @param x x coordinate
+ * @param y y coordinate
+ * @param state visible state: 0-8 sorrounding mines, 9 opened mine, 10 flag
+ * @return key to xor into the state hash
+ */
+static std::uint64_t fieldKey(int x, int y, int state) {
+    std::uint64_t value = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+    for (int round = 0; round < 2; round++) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        value ^= value >> 31;
+        value += static_cast<std::uint64_t>(state);
+    }
+    return value;
+}
+
+/**
+ * Spreads the set bits of a word towards the higher bits, as long as the mask is set (occluded fill).
+ * @param bits bits to spread, must be a subset of mask
+ * @param mask bits that may be set
+ * @return bits and every mask bit reachable from them
+ */
+static std::uint64_t fillUp(std::uint64_t bits, std::uint64_t mask) {
+    for (int shift = 1; shift < 64; shift *= 2) {
+        bits |= (bits << shift) & mask;
+        mask &= mask << shift;
+    }
+    return bits;
+}
+
+/**
+ * Spreads the set bits of a word towards the lower bits, as long as the mask is set (occluded fill).
+ * @param bits bits to spread, must be a subset of mask
+ * @param mask bits that may be set
+ * @return bits and every mask bit reachable from them
+ */
+static std::uint64_t fillDown(std::uint64_t bits, std::uint64_t mask) {
+    for (int shift = 1; shift < 64; shift *= 2) {
+        bits |= (bits >> shift) & mask;
+        mask &= mask >> shift;
+    }
+    return bits;
+}
 
-Minefield::Minefield(int dimension_x, int dimension_y, int mine_count, int seed) {
+Minefield::Minefield(int dimension_x, int dimension_y, std::int64_t mine_count, std::int64_t seed, StorageMode storage_mode) {
     if (dimension_x <= 0 || dimension_y <= 0) {
         throw std::range_error("Given X and Y dimensions must be >0.");
     }
 
-    if (mine_count > dimension_x * dimension_y) {
+    std::int64_t cell_count = static_cast<std::int64_t>(dimension_x) * dimension_y;
+    if (mine_count > cell_count) {
         throw std::runtime_error("Given minecount doesn't fit on given X and Y dimensions");
     }
 
@@ -31,169 +92,359 @@ Minefield::Minefield(int dimension_x, int dimension_y, int mine_count, int seed)
     given_x_dimension = dimension_x;
     given_y_dimension = dimension_y;
 
+    expansion_engine = ExpansionEngine::automatic;
+    cell_words = nullptr;
+    track_changes = false;
+    journal = std::make_shared<MoveJournal>();
+
     // init caching vars
     open_cnt = 0;
     flag_cnt = 0;
     opened_mine = false;
-    
-    // init matrixes
-    for (int x = 0; x < dimension_x; x++) {
-        std::vector<bool> column;
-        for (int y = 0; y < dimension_y; y++) {
-            column.push_back(false);
+    state_hash = 0;
+
+    words_per_row = (dimension_x + 63) / 64;
+    unbounded = false;
+    chunked = StorageMode::chunked == storage_mode || (StorageMode::automatic == storage_mode && cell_count > CHUNKED_THRESHOLD);
+    if (! chunked && cell_count > std::numeric_limits<int>::max()) {
+        throw std::range_error("Dense storage can't hold more than 2^31-1 fields, use the chunked storage.");
+    }
+    if (chunked) {
+        // mines and counts are generated per chunk on first access
+        chunk_storage = ChunkedStorage(dimension_x, dimension_y, mine_count, seed);
+        return;
+    }
+
+    // init bit planes (all cells empty)
+    allocateCells(static_cast<std::size_t>(words_per_row) * dimension_y * PLANE_COUNT);
+
+    if (StorageMode::tiled == storage_mode) {
+        generateTiled(0);
+        return;
+    }
+
+    // classic sizes are generated w/ the dimensions known at compile time (same board as below)
+    if (StorageMode::fixed == storage_mode || StorageMode::automatic == storage_mode) {
+        if (generateFixed(mine_count, seed)) {
+            return;
+        }
+        if (StorageMode::fixed == storage_mode) {
+            throw std::range_error("Fixed storage is only available for 9x9, 16x16 and 30x16 minefields.");
         }
-        mines.push_back(column);
-        flags.push_back(column);
-        opened.push_back(column);
     }
 
     // seed randomizer
     //A Mersenne Twister pseudo-random generator of 32-bit numbers with a state size of 19937 bits.
-    std::mt19937 rdm_num_machine(seed);
-
-    // pick mine_count random spots to place mines
-    // 1. put all spots in list (encoded as x_dimension * y + x)
-    // 2. pick random spot in list
-    // 3. swap: first spot in list and chosen spot
-    // 4. narrow rdmizer to exclude already found mine
-    // 5. go to 2.
-    
-    std::vector<int> positions;
+    std::mt19937 rdm_num_machine = createRandomizer(seed);
 
-    for (int i = 0; i < dimension_x * dimension_y; i++) {
-        positions.push_back(i);
+    // pick the mines (or the free fields on boards w/ more mines than free fields)
+    // memory is proportional to the amount of picked fields, see mine_placement.hpp
+    MinePlacement placement = placeMines(dimension_x * dimension_y, static_cast<int>(mine_count), rdm_num_machine);
+    if (placement.complement) {
+        for (int y = 0; y < dimension_y; y++) {
+            for (int x = 0; x < dimension_x; x++) {
+                setBit(MINE_PLANE, x, y, true);
+            }
+        }
+    }
+    for (int chosen_pos : placement.positions) {
+        // resolve chosen spot (encoded as x_dimension * y + x)
+        setBit(MINE_PLANE, chosen_pos % dimension_x, chosen_pos / dimension_x, ! placement.complement);
     }
 
-    int random_min = 0;
-    int random_max = positions.size() - 1;
+    // cache the amount of sorrounding mines for every cell, 64 cells at once
+    countNeighbourPlanes(&cell_words[MINE_PLANE], PLANE_COUNT, &cell_words[COUNT_PLANE_0], PLANE_COUNT, dimension_x, dimension_y);
+}
+
+Minefield Minefield::createUnbounded(int mine_density, std::int64_t seed) {
+    if (mine_density < MIN_UNBOUNDED_DENSITY || mine_density > 99) {
+        throw std::range_error("Mine density of unbounded minefields must be between " + std::to_string(MIN_UNBOUNDED_DENSITY) + " and 99.");
+    }
 
-    for (int current_mine_num = 0; current_mine_num < mine_count; current_mine_num++) {
-        std::uniform_int_distribution<> distr(random_min, random_max);
-        int chosen_index = distr(rdm_num_machine);
-        int chosen_pos = positions[chosen_index];
+    const int chunk_cells = ChunkedStorage::CHUNK_SIZE * ChunkedStorage::CHUNK_SIZE;
+
+    Minefield mfield(1, 1, 0, seed, StorageMode::chunked);
+    mfield.unbounded = true;
+    mfield.given_x_dimension = 0;
+    mfield.given_y_dimension = 0;
+    mfield.given_mine_count = -1;
+    mfield.chunk_storage = ChunkedStorage((chunk_cells * mine_density) / 100, seed);
+    return mfield;
+}
 
-        // resolve chosen spot
-        int x = chosen_pos % dimension_x;
-        int y = chosen_pos / dimension_x;
+Minefield Minefield::createTiled(int dimension_x, int dimension_y, std::int64_t mine_count, std::int64_t seed, int thread_count) {
+    // checks the parameters, the chunked storage doesn't generate anything up front
+    Minefield mfield(dimension_x, dimension_y, mine_count, seed, StorageMode::chunked);
+    if (static_cast<std::int64_t>(dimension_x) * dimension_y > std::numeric_limits<int>::max()) {
+        throw std::range_error("Dense storage can't hold more than 2^31-1 fields, use the chunked storage.");
+    }
+
+    mfield.chunked = false;
+    mfield.chunk_storage = ChunkedStorage();
+    mfield.allocateCells(static_cast<std::size_t>(mfield.words_per_row) * dimension_y * PLANE_COUNT);
+    mfield.generateTiled(thread_count);
+    return mfield;
+}
+
+void Minefield::generateTiled(int thread_count) {
+    const int tile_size = ChunkedStorage::CHUNK_SIZE;
+    static_assert(64 == ChunkedStorage::CHUNK_SIZE, "a tile has to be exactly one group wide");
+
+    int dimension_x = getXDimension();
+    int dimension_y = getYDimension();
+    int tile_rows = (dimension_y + tile_size - 1) / tile_size;
+    std::size_t row_stride = static_cast<std::size_t>(words_per_row) * PLANE_COUNT;
+
+    if (thread_count <= 0) {
+        thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    thread_count = std::min(thread_count, tile_rows);
+
+    // runs fn(thread) on thread_count threads, the calling thread is one of them
+    auto runThreads = [thread_count](const std::function<void(int)>& fn) {
+        std::vector<std::thread> threads;
+        for (int thread = 1; thread < thread_count; thread++) {
+            threads.emplace_back(fn, thread);
+        }
+        fn(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    };
+
+    // the mine shares of the tiles are the ones of the chunks (exact total)
+    ChunkedStorage shares(dimension_x, dimension_y, getMineCount(), getSeed());
+
+    // stage 1: mines, every thread takes every thread_count-th row of tiles
+    runThreads([&](int thread) {
+        for (int tile_y = thread; tile_y < tile_rows; tile_y += thread_count) {
+            int tile_height = std::min(tile_size, dimension_y - tile_y * tile_size);
+            for (int tile_x = 0; tile_x < words_per_row; tile_x++) {
+                int tile_width = std::min(tile_size, dimension_x - tile_x * tile_size);
+                int tile_mines = static_cast<int>(shares.getChunkMineCount(tile_x, tile_y));
+                std::uint64_t* words = &cell_words[static_cast<std::size_t>(tile_y) * tile_size * row_stride + tile_x * PLANE_COUNT];
+                ChunkedStorage::placeChunkMines(getSeed(), tile_x, tile_y, tile_width, tile_height, tile_mines, words, row_stride);
+            }
+        }
+    });
+
+    // stage 2: counts, needs the mines of the neighbouring tiles -> starts after all mines are placed
+    std::uint64_t last_word_mask = (0 == dimension_x % 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << (dimension_x % 64)) - 1;
+    runThreads([&](int thread) {
+        int first_row = static_cast<int>(static_cast<std::int64_t>(dimension_y) * thread / thread_count);
+        int end_row = static_cast<int>(static_cast<std::int64_t>(dimension_y) * (thread + 1) / thread_count);
+        for (int y = first_row; y < end_row; y++) {
+            for (int word_x = 0; word_x < words_per_row; word_x++) {
+                std::uint64_t rows[3][3];
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) {
+                        int current_y = y + dy - 1;
+                        int current_word = word_x + dx - 1;
+                        bool valid = 0 <= current_y && current_y < dimension_y && 0 <= current_word && current_word < words_per_row;
+                        rows[dy][dx] = valid ? cell_words[current_y * row_stride + current_word * PLANE_COUNT + MINE_PLANE] : 0;
+                    }
+                }
 
-        // put mine at spot
-        mines[x][y] = true;
+                std::uint64_t counts[4];
+                countNeighbourWords(rows[0], rows[1], rows[2], counts);
 
-        // swap: chosen spot <-> first item in range
-        positions[chosen_index] = positions[random_min];
-        positions[random_min] = chosen_pos;
+                // cells right of the board would receive a count, keep the padding empty
+                std::uint64_t mask = (word_x + 1 == words_per_row) ? last_word_mask : ~std::uint64_t(0);
+                std::uint64_t* current_group = &cell_words[y * row_stride + word_x * PLANE_COUNT];
+                current_group[COUNT_PLANE_0] = counts[0] & mask;
+                current_group[COUNT_PLANE_1] = counts[1] & mask;
+                current_group[COUNT_PLANE_2] = counts[2] & mask;
+                current_group[COUNT_PLANE_3] = counts[3] & mask;
+            }
+        }
+    });
+}
 
-        // narrow rdmizer
-        random_min++;
+std::mt19937 Minefield::createRandomizer(std::int64_t seed) {
+    // seeds that fit into an int are used directly (so they keep generating the same boards)
+    if (std::numeric_limits<std::int32_t>::min() <= seed && seed <= std::numeric_limits<std::int32_t>::max()) {
+        return std::mt19937(static_cast<std::uint32_t>(seed));
     }
+
+    std::uint64_t bits = static_cast<std::uint64_t>(seed);
+    std::seed_seq sequence = {static_cast<std::uint32_t>(bits), static_cast<std::uint32_t>(bits >> 32)};
+    return std::mt19937(sequence);
 }
 
-void Minefield::checkPos(int x, int y) {
-    if (! isPosValid(x, y)) {
-        throw std::runtime_error("Given position is invalid.");
+bool Minefield::generateFixed(int mine_count, std::int64_t seed) {
+    if (9 == getXDimension() && 9 == getYDimension()) {
+        copyFixedBoard<9, 9>(mine_count, seed);
+    } else if (16 == getXDimension() && 16 == getYDimension()) {
+        copyFixedBoard<16, 16>(mine_count, seed);
+    } else if (30 == getXDimension() && 16 == getYDimension()) {
+        copyFixedBoard<30, 16>(mine_count, seed);
+    } else {
+        return false;
     }
+    return true;
 }
 
-void Minefield::checkRunning() {
-    if(! isGameRunning()) {
-        throw std::runtime_error("Game is not running anymore.");
+template <int WIDTH, int HEIGHT>
+void Minefield::copyFixedBoard(int mine_count, std::int64_t seed) {
+    FixedBoard<WIDTH, HEIGHT> board;
+    std::mt19937 rdm_num_machine = createRandomizer(seed);
+    board.generate(mine_count, rdm_num_machine);
+
+    // one group per row on both sides
+    std::copy(board.words.begin(), board.words.end(), cell_words);
+}
+
+void Minefield::allocateCells(std::size_t word_count) {
+    cells = std::make_shared<std::vector<std::uint64_t>>(word_count, 0);
+    cell_words = cells->data();
+}
+
+void Minefield::detachCells() {
+    if (! isOnlyOwner(cells)) {
+        cells = std::make_shared<std::vector<std::uint64_t>>(*cells);
+        cell_words = cells->data();
     }
 }
 
-bool Minefield::isGameEnded() {
-    return ! isGameRunning();
+bool Minefield::isSharingCells() const {
+    return ! chunked && 1 < cells.use_count();
 }
 
-bool Minefield::isGameRunning() {
-    // two requirements
-    // 1. no mines have been opened
-    // 2. there is a field to be opened that is not a mine
-    
-    // no mine opened
-    if (opened_mine) {
-        return false;
+MoveJournal& Minefield::editJournal() {
+    if (! isOnlyOwner(journal)) {
+        journal = std::make_shared<MoveJournal>(*journal);
     }
+    return *journal;
+}
 
-    // an open field w/o mine exists
-    // -> more fields to open than mines remaining
-    return ((getXDimension() * getYDimension()) - open_cnt) > given_mine_count;
-    for (int x = 0; x < getXDimension(); x++) {
-        for (int y = 0; y < getYDimension(); y++) {
-            if((! mines[x][y]) && (! isOpen(x, y))) {
-                return true;
-            }
-         }
+void Minefield::beginJournalEntry(int x, int y) {
+    // disabled journals are never written, copies w/o undo keep sharing them
+    // (while recording the journal isn't shared, so the record calls of the move don't check again)
+    if (journal->isEnabled()) {
+        editJournal().beginEntry(x, y);
     }
+}
 
-    // requirements not met
-    return false;
+bool Minefield::isSharingJournal() const {
+    return 1 < journal.use_count();
 }
 
-bool Minefield::isGameWon() {
-    if (! isGameEnded()) {
-        return false;
+void Minefield::checkRunning() const {
+    if(! isGameRunning()) {
+        throw std::runtime_error("Game is not running anymore.");
     }
+}
 
-    // all fields w/o mines are opened
-    // -> no field opened w/o mine
-    for (int x = 0; x < getXDimension(); x++) {
-        for (int y = 0; y < getYDimension(); y++) {
-            if ((! isOpen(x, y)) && (! mines[x][y])) {
-                // field w/o mine has not been opened
-                return false;
+const std::uint64_t* Minefield::chunkedGroup(int x, int y) const {
+    return chunk_storage.group(x, y);
+}
+
+int Minefield::getCount(int x, int y) const {
+    return getGroupCount(group(x, y), x);
+}
+
+void Minefield::addToSorroundingCounts(int x, int y, int delta) {
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            int current_x = x + dx;
+            int current_y = y + dy;
+
+            if ((dx != 0 || dy != 0) && isPosValid(current_x, current_y)) {
+                std::uint64_t* current_group = group(current_x, current_y);
+                setGroupCount(current_group, current_x, getGroupCount(current_group, current_x) + delta);
             }
         }
     }
-
-    // all fields w/o mines are opened
-    return true;
 }
 
-bool Minefield::isGameLost() {
-    if (! isGameEnded()) {
-        return false;
+void Minefield::addToSorroundingFlagCounts(int x, int y, int delta) {
+    if (! chunked) {
+        // dense: the 3 fields of a row are in 1 or 2 words, no lookup per field
+        detachCells();
+        int first_x = std::max(x - 1, 0);
+        int last_x = std::min(x + 1, getXDimension() - 1);
+        for (int row = std::max(y - 1, 0); row <= std::min(y + 1, getYDimension() - 1); row++) {
+            for (int word_x = first_x / 64; word_x <= last_x / 64; word_x++) {
+                std::uint64_t mask = 0;
+                for (int current_x = std::max(first_x, word_x * 64); current_x <= std::min(last_x, word_x * 64 + 63); current_x++) {
+                    mask |= std::uint64_t(1) << (current_x & 63);
+                }
+                if (row == y && x / 64 == word_x) {
+                    mask &= ~(std::uint64_t(1) << (x & 63));
+                }
+                addToGroupFlagCounts(&cell_words[(static_cast<std::size_t>(row) * words_per_row + word_x) * PLANE_COUNT], mask, delta);
+            }
+        }
+        return;
     }
 
-    // there is a field w/ a mine that has been opened
-    for (int x = 0; x < getXDimension(); x++) {
-        for (int y = 0; y < getYDimension(); y++) {
-            if (mines[x][y] && isOpen(x, y)) {
-                return true;
+    for (int dy = -1; dy <= 1; dy++) {
+        int current_y = y + dy;
+
+        // the fields of a row are changed at once, unless they are split over two groups
+        std::uint64_t* current_group = nullptr;
+        std::uint64_t mask = 0;
+        for (int current_x = x - 1; current_x <= x + 1; current_x++) {
+            if ((current_x == x && 0 == dy) || ! isPosValid(current_x, current_y)) {
+                continue;
             }
+            if (0 != mask && 0 == (current_x & 63)) {
+                addToGroupFlagCounts(current_group, mask, delta);
+                mask = 0;
+            }
+            if (0 == mask) {
+                current_group = group(current_x, current_y);
+            }
+            mask |= std::uint64_t(1) << (current_x & 63);
+        }
+        if (0 != mask) {
+            addToGroupFlagCounts(current_group, mask, delta);
         }
     }
-    return false;
 }
 
-bool Minefield::isPosValid(int x, int y) {
-    if (x < 0 || x >= getXDimension()) {
+bool Minefield::isGameEnded() const {
+    return ! isGameRunning();
+}
+
+bool Minefield::isGameRunning() const {
+    // two requirements
+    // 1. no mines have been opened
+    // 2. there is a field to be opened that is not a mine
+    
+    // no mine opened
+    if (opened_mine) {
         return false;
     }
 
-    if (y < 0 || y >= getYDimension()) {
-        return false;
+    // unbounded boards always have fields left to open
+    if (unbounded) {
+        return true;
     }
 
-    return true;
+    // an open field w/o mine exists
+    // -> more fields to open than mines remaining
+    return (static_cast<std::int64_t>(getXDimension()) * getYDimension() - open_cnt) > given_mine_count;
 }
 
-bool Minefield::isFlagged(int x, int y) {
-    checkPos(x, y);
-    return flags[x][y];
+bool Minefield::isGameWon() const {
+    // game over w/o opening a mine
+    // -> all fields w/o mines are opened
+    return isGameEnded() && ! opened_mine;
 }
 
-bool Minefield::isMine(int x, int y) {
+bool Minefield::isGameLost() const {
+    // game is lost exactly when a mine has been opened
+    return opened_mine;
+}
+
+bool Minefield::isMine(int x, int y) const {
     checkPos(x, y);
     if (isGameRunning() && ! isOpen(x, y)) {
         throw std::runtime_error("Can't check if is mine on not-opened field.");
     }
 
-    return mines[x][y];
-}
-
-bool Minefield::isOpen(int x, int y) {
-    checkPos(x, y);
-    return opened[x][y];
+    return getBit(MINE_PLANE, x, y);
 }
 
 void Minefield::flag(int x, int y) {
@@ -204,10 +455,39 @@ void Minefield::flag(int x, int y) {
         throw std::runtime_error("Can't place flag on opened field.");
     }
 
-    if (! isFlagged(x, y)) {
-        flags[x][y] = true;
+    tryFlag(x, y);
+}
+
+Minefield::MoveResult Minefield::tryFlag(int x, int y) {
+    beginJournalEntry(x, y);
+    MoveResult result = flagField(x, y);
+    journal->endEntry();
+    evictFarChunks(x, y);
+    return result;
+}
+
+Minefield::MoveResult Minefield::flagField(int x, int y) {
+    if (! isPosValid(x, y)) {
+        return MoveResult::invalid;
+    }
+    if (! isGameRunning()) {
+        return MoveResult::game_over;
+    }
+    if (getBit(OPEN_PLANE, x, y)) {
+        return MoveResult::already_open;
+    }
+
+    MoveResult result = MoveResult::flagged;
+    if (! getBit(FLAG_PLANE, x, y)) {
+        setBit(FLAG_PLANE, x, y, true);
         flag_cnt++;
+        addToSorroundingFlagCounts(x, y, 1);
+        toggleStateHash(x, y, true);
+        journal->recordFlagToggled(x, y);
+        markChanged(x, y);
+        result = MoveResult::flag_placed;
     }
+    return result;
 }
 
 void Minefield::unflag(int x, int y) {
@@ -218,150 +498,787 @@ void Minefield::unflag(int x, int y) {
         throw std::runtime_error("Can't remove flag on opened field.");
     }
 
-    if (isFlagged(x, y)) {
-        flags[x][y] = false;
+    tryUnflag(x, y);
+}
+
+Minefield::MoveResult Minefield::tryUnflag(int x, int y) {
+    beginJournalEntry(x, y);
+    MoveResult result = unflagField(x, y);
+    journal->endEntry();
+    evictFarChunks(x, y);
+    return result;
+}
+
+Minefield::MoveResult Minefield::unflagField(int x, int y) {
+    if (! isPosValid(x, y)) {
+        return MoveResult::invalid;
+    }
+    if (! isGameRunning()) {
+        return MoveResult::game_over;
+    }
+    if (getBit(OPEN_PLANE, x, y)) {
+        return MoveResult::already_open;
+    }
+
+    MoveResult result = MoveResult::not_flagged;
+    if (getBit(FLAG_PLANE, x, y)) {
+        setBit(FLAG_PLANE, x, y, false);
         flag_cnt--;
+        addToSorroundingFlagCounts(x, y, -1);
+        toggleStateHash(x, y, true);
+        journal->recordFlagToggled(x, y);
+        markChanged(x, y);
+        result = MoveResult::flag_removed;
     }
+    return result;
 }
 
 void Minefield::open(int x, int y, bool recursive) {
     checkPos(x, y);
     checkRunning();
 
-    if (flags[x][y]) {
+    if (getBit(FLAG_PLANE, x, y)) {
         throw std::runtime_error("Can't open given position, flag is placed.");
     }
 
+    tryOpen(x, y, recursive);
+}
+
+Minefield::MoveResult Minefield::tryOpen(int x, int y, bool recursive) {
+    beginJournalEntry(x, y);
+    MoveResult result = openField(x, y, recursive);
+    journal->endEntry();
+    evictFarChunks(x, y);
+    return result;
+}
+
+Minefield::MoveResult Minefield::openField(int x, int y, bool recursive) {
+    if (! isPosValid(x, y)) {
+        return MoveResult::invalid;
+    }
+    if (! isGameRunning()) {
+        return MoveResult::game_over;
+    }
+    if (getBit(FLAG_PLANE, x, y)) {
+        return MoveResult::flagged;
+    }
+
+    std::int64_t open_before = getOpenCount();
+
     // check if is first spot to be opened
-    if (mines[x][y] && 0 == getOpenCount()) {
-        // move this mine to another open place
-        std::vector<std::tuple<int, int>> emptySpots;
-        for (int lx = 0; lx < getXDimension(); lx++) {
-            for (int ly = 0; ly < getYDimension(); ly++) {
-                if (! mines[lx][ly]) {
-                    emptySpots.push_back(std::make_tuple(lx, ly));
+    if (getBit(MINE_PLANE, x, y) && 0 == getOpenCount()) {
+        relocateMine(x, y);
+    }
+
+    uncover(x, y);
+
+    if (recursive && ! getBit(MINE_PLANE, x, y) && 0 == getCount(x, y)) {
+        if (usesBitwiseExpansion()) {
+            openZeroRegionBitwise(x, y);
+        } else {
+            openZeroRegion(x, y);
+        }
+    }
+    return (open_before == getOpenCount()) ? MoveResult::already_open : MoveResult::opened;
+}
+
+Minefield::MoveResult Minefield::tryChord(int x, int y) {
+    beginJournalEntry(x, y);
+    MoveResult result = chordField(x, y);
+    journal->endEntry();
+    evictFarChunks(x, y);
+    return result;
+}
+
+Minefield::MoveResult Minefield::chordField(int x, int y) {
+    if (! isPosValid(x, y)) {
+        return MoveResult::invalid;
+    }
+    if (! isGameRunning()) {
+        return MoveResult::game_over;
+    }
+    if (getBit(FLAG_PLANE, x, y)) {
+        return MoveResult::flagged;
+    }
+    if (! getBit(OPEN_PLANE, x, y)) {
+        return MoveResult::not_open;
+    }
+
+    // fields w/o sorrounding mines have been expanded when they were opened
+    int flag_count = getGroupFlagCount(group(x, y), x);
+    if (0 == flag_count || getCount(x, y) != flag_count) {
+        return MoveResult::already_open;
+    }
+
+    // the chorded field is open -> not the first move, no mine has to be moved
+    std::int64_t open_before = getOpenCount();
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            int current_x = x + dx;
+            int current_y = y + dy;
+            if (! isPosValid(current_x, current_y) || ! isGameRunning()) {
+                continue;
+            }
+
+            const std::uint64_t* current_group = group(current_x, current_y);
+            if (getGroupBit(current_group, FLAG_PLANE, current_x) || getGroupBit(current_group, OPEN_PLANE, current_x)) {
+                continue;
+            }
+
+            uncover(current_x, current_y);
+            if (! getBit(MINE_PLANE, current_x, current_y) && 0 == getCount(current_x, current_y)) {
+                if (usesBitwiseExpansion()) {
+                    openZeroRegionBitwise(current_x, current_y);
+                } else {
+                    openZeroRegion(current_x, current_y);
                 }
             }
         }
+    }
+    return (open_before == getOpenCount()) ? MoveResult::already_open : MoveResult::opened;
+}
+
+void Minefield::applyMoves(const Move* moves, std::size_t move_count, MoveResult* results, std::vector<std::tuple<int, int>>& changed) {
+    // the batch reports its changes in any case, nothing is pending while tracking is disabled
+    bool tracking = track_changes;
+    track_changes = true;
+
+    for (std::size_t i = 0; i < move_count; i++) {
+        const Move& move = moves[i];
+        beginJournalEntry(move.x, move.y);
+        switch (move.type) {
+            case MoveType::open:
+                results[i] = openField(move.x, move.y, true);
+                break;
+            case MoveType::flag:
+                results[i] = flagField(move.x, move.y);
+                break;
+            case MoveType::unflag:
+                results[i] = unflagField(move.x, move.y);
+                break;
+            case MoveType::chord:
+                results[i] = chordField(move.x, move.y);
+                break;
+        }
+        journal->endEntry();
+    }
+
+    // chunks are evicted once per batch, around the last valid move
+    for (std::size_t i = move_count; i > 0; i--) {
+        if (isPosValid(moves[i - 1].x, moves[i - 1].y)) {
+            evictFarChunks(moves[i - 1].x, moves[i - 1].y);
+            break;
+        }
+    }
+
+    drainChangedCells(changed);
+    track_changes = tracking;
+}
+
+void Minefield::evictFarChunks(int x, int y) {
+    if (chunked) {
+        chunk_storage.evictFarChunks(x, y);
+    }
+}
+
+void Minefield::relocateMine(int x, int y) {
+    // (any coordinate is valid on unbounded boards, so found is tracked separately)
+    bool found = false;
+    int chosen_x = -1;
+    int chosen_y = -1;
+
+    if (! chunked) {
+        // move this mine to another open place: the k-th free field in column-major order (the order the fields have always been picked in)
+        // free fields are counted per block of 64 columns (one word per row), so whole blocks are skipped w/o looking at single fields
+        const int width = getXDimension();
+        const int height = getYDimension();
+        std::uint64_t last_word_mask = (0 == width % 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << (width % 64)) - 1;
+        auto free_bits = [&](int word_x, int row) {
+            std::uint64_t mask = (word_x + 1 == words_per_row) ? last_word_mask : ~std::uint64_t(0);
+            return ~cell_words[(static_cast<std::size_t>(row) * words_per_row + word_x) * PLANE_COUNT + MINE_PLANE] & mask;
+        };
+
+        std::vector<std::int64_t> block_free(words_per_row, 0);
+        std::int64_t free_count = 0;
+        for (int row = 0; row < height; row++) {
+            for (int word_x = 0; word_x < words_per_row; word_x++) {
+                block_free[word_x] += __builtin_popcountll(free_bits(word_x, row));
+            }
+        }
+        for (std::int64_t count : block_free) {
+            free_count += count;
+        }
 
         // pick random empty spot
-        if (0 < emptySpots.size()) {
+        if (0 < free_count) {
             std::mt19937 rdm_num_machine(x * getYDimension() + y);
-            std::uniform_int_distribution<> distr(0, emptySpots.size() - 1);
-            int chosen_index = distr(rdm_num_machine);
+            std::uniform_int_distribution<> distr(0, free_count - 1);
+            std::int64_t chosen_index = distr(rdm_num_machine);
 
-            int chosen_x, chosen_y;
-            std::tie(chosen_x, chosen_y) = emptySpots[chosen_index];
+            int word_x = 0;
+            while (block_free[word_x] <= chosen_index) {
+                chosen_index -= block_free[word_x];
+                word_x++;
+            }
 
-            // move mines
-            mines[chosen_x][chosen_y] = true;
-            mines[x][y] = false;
+            // column by column inside the block
+            for (int bit = 0; bit < 64 && ! found; bit++) {
+                std::uint64_t column = std::uint64_t(1) << bit;
+                for (int row = 0; row < height; row++) {
+                    if (0 != (free_bits(word_x, row) & column) && 0 == chosen_index--) {
+                        chosen_x = word_x * 64 + bit;
+                        chosen_y = row;
+                        found = true;
+                        break;
+                    }
+                }
+            }
         }
+    } else {
+        // scan the chunks in row-major order, starting w/ the chunk of the mine
+        // (there is a free field, otherwise the game would not be running)
+        // unbounded boards have less mines than cells in every chunk -> the chunk of the mine is sufficient
+        const int chunk_size = ChunkedStorage::CHUNK_SIZE;
+        int chunks_x = unbounded ? 1 : (getXDimension() + chunk_size - 1) / chunk_size;
+        int chunks_y = unbounded ? 1 : (getYDimension() + chunk_size - 1) / chunk_size;
+        std::int64_t chunk_total = static_cast<std::int64_t>(chunks_x) * chunks_y;
+        std::int64_t first_chunk = unbounded ? 0 : static_cast<std::int64_t>(y / chunk_size) * chunks_x + x / chunk_size;
+
+        for (std::int64_t i = 0; i < chunk_total && ! found; i++) {
+            std::int64_t chunk = (first_chunk + i) % chunk_total;
+            int min_x = static_cast<int>(chunk % chunks_x) * chunk_size;
+            int min_y = static_cast<int>(chunk / chunks_x) * chunk_size;
+            if (unbounded) {
+                min_x = ChunkedStorage::getChunkCoordinate(x) * chunk_size;
+                min_y = ChunkedStorage::getChunkCoordinate(y) * chunk_size;
+            }
+
+            for (int ly = min_y; ly - min_y < chunk_size && ! found; ly++) {
+                for (int lx = min_x; lx - min_x < chunk_size; lx++) {
+                    if (isPosValid(lx, ly) && ! getBit(MINE_PLANE, lx, ly)) {
+                        chosen_x = lx;
+                        chosen_y = ly;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+        }
+
     }
 
-    // recursive open? -> redirect to non-recursive open for counting purposes
-    if (recursive) {
-        open(x, y, false);
-    } else {
-        if (! opened[x][y]) {
-            opened[x][y] = true;
-            open_cnt++;
+    if (found) {
+        moveMine(x, y, chosen_x, chosen_y);
+        journal->recordRelocation(x, y, chosen_x, chosen_y);
+    }
+}
 
-            if (isMine(x, y)) {
-                opened_mine = true;
+void Minefield::moveMine(int from_x, int from_y, int to_x, int to_y) {
+    // chunks calculate their counts from the mine plane when first accessed:
+    // access all cells whose count changes before moving the mine, so no count is changed twice
+    if (chunked) {
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (isPosValid(from_x + dx, from_y + dy)) {
+                    group(from_x + dx, from_y + dy);
+                }
+                if (isPosValid(to_x + dx, to_y + dy)) {
+                    group(to_x + dx, to_y + dy);
+                }
             }
         }
     }
 
-    if (recursive && !isMine(x, y) && (0 == getSorroundingMineCount(x, y))) {
-        std::function<bool (int, int, std::vector<std::tuple<int, int>>&)> recursive_open = [&](int x, int y, std::vector<std::tuple<int, int>>& done){
-            // stop on: invalid pos, already visited by recursive machine
-            std::tuple<int, int> coords_tuple = std::make_tuple(x, y);
-            if (! isPosValid(x, y)) {
-                return false;
+    // move mines (and keep the cached counts in sync)
+    setBit(MINE_PLANE, to_x, to_y, true);
+    setBit(MINE_PLANE, from_x, from_y, false);
+    addToSorroundingCounts(to_x, to_y, 1);
+    addToSorroundingCounts(from_x, from_y, -1);
+}
+
+void Minefield::uncover(int x, int y) {
+    if (! getBit(OPEN_PLANE, x, y)) {
+        setBit(OPEN_PLANE, x, y, true);
+        open_cnt++;
+        journal->recordOpened(x, y, 1);
+        toggleStateHash(x, y, false);
+        markChanged(x, y);
+
+        if (getBit(MINE_PLANE, x, y)) {
+            opened_mine = true;
+            journal->recordLost();
+            markRevealed();
+        }
+    }
+}
+
+void Minefield::toggleStateHash(int x, int y, bool flag) {
+    int state = 10;
+    if (! flag) {
+        state = getBit(MINE_PLANE, x, y) ? 9 : getCount(x, y);
+    }
+    state_hash ^= fieldKey(x, y, state);
+}
+
+std::uint64_t Minefield::getStateHash() const {
+    return state_hash;
+}
+
+void Minefield::markChanged(int x, int y) {
+    if (track_changes && ! getBit(DIRTY_PLANE, x, y)) {
+        setBit(DIRTY_PLANE, x, y, true);
+        changed_cells.push_back(std::make_tuple(x, y));
+    }
+}
+
+void Minefield::markRevealed() {
+    // the journal keeps the revealed fields, so undo and redo don't have to search them again
+    if (! track_changes && ! journal->isEnabled()) {
+        return;
+    }
+
+    // after losing, unflagged mines and wrongly placed flags become visible
+    // (collected first, marking them changed must not modify the storage while iterating it)
+    std::vector<std::tuple<int, int>> revealed_cells;
+    auto collect = [&revealed_cells](int x, int y, const std::uint64_t* current_group) {
+        std::uint64_t mine = current_group[MINE_PLANE];
+        std::uint64_t flag = current_group[FLAG_PLANE];
+        std::uint64_t revealed = (mine & ~flag & ~current_group[OPEN_PLANE]) | (flag & ~mine);
+
+        while (0 != revealed) {
+            int bit = __builtin_ctzll(revealed);
+            revealed_cells.push_back(std::make_tuple(x + bit, y));
+            revealed &= revealed - 1;
+        }
+    };
+
+    if (chunked) {
+        // chunks that have never been accessed have never been displayed either -> can be skipped
+        chunk_storage.forEachChunk([&collect](int chunk_x, int chunk_y, std::uint64_t* words) {
+            for (int row = 0; row < ChunkedStorage::CHUNK_SIZE; row++) {
+                collect(chunk_x * ChunkedStorage::CHUNK_SIZE, chunk_y * ChunkedStorage::CHUNK_SIZE + row, &words[row * PLANE_COUNT]);
             }
-            if (done.end() != std::find(done.begin(), done.end(), coords_tuple)) {
-               return false;
+        });
+    } else {
+        for (int y = 0; y < getYDimension(); y++) {
+            for (int word_x = 0; word_x < words_per_row; word_x++) {
+                collect(word_x * 64, y, &cell_words[(static_cast<std::size_t>(y) * words_per_row + word_x) * PLANE_COUNT]);
             }
+        }
+    }
+
+    for (auto& cell : revealed_cells) {
+        journal->recordRevealed(std::get<0>(cell), std::get<1>(cell));
+        markChanged(std::get<0>(cell), std::get<1>(cell));
+    }
+}
+
+void Minefield::recordOpenedWord(int word_x, int y, std::uint64_t opened) {
+    // one run per block of adjacent bits
+    while (0 != opened) {
+        int first = __builtin_ctzll(opened);
+        std::uint64_t rest = ~(opened >> first);
+        int length = (0 == rest) ? 64 - first : __builtin_ctzll(rest);
+        journal->recordOpened(word_x * 64 + first, y, length);
+        opened &= (64 == length) ? 0 : ~(((std::uint64_t(1) << length) - 1) << first);
+    }
+}
+
+void Minefield::setChangeTrackingEnabled(bool enabled) {
+    if (! enabled) {
+        std::vector<std::tuple<int, int>> discarded;
+        drainChangedCells(discarded);
+    }
+    track_changes = enabled;
+}
+
+bool Minefield::isChangeTrackingEnabled() const {
+    return track_changes;
+}
+
+void Minefield::setUndoEnabled(bool enabled) {
+    // setting discards all entries, so there is nothing to copy
+    journal = std::make_shared<MoveJournal>();
+    journal->setEnabled(enabled);
+}
+
+bool Minefield::isUndoEnabled() const {
+    return journal->isEnabled();
+}
+
+bool Minefield::canUndo() const {
+    return journal->canUndo();
+}
+
+bool Minefield::canRedo() const {
+    return journal->canRedo();
+}
+
+bool Minefield::undo() {
+    if (! journal->canUndo()) {
+        return false;
+    }
+
+    const MoveJournal::Entry& entry = editJournal().undo();
+    applyJournalEntry(entry, false);
+    evictFarChunks(entry.x, entry.y);
+    return true;
+}
+
+bool Minefield::redo() {
+    if (! journal->canRedo()) {
+        return false;
+    }
+
+    const MoveJournal::Entry& entry = editJournal().redo();
+    applyJournalEntry(entry, true);
+    evictFarChunks(entry.x, entry.y);
+    return true;
+}
+
+std::size_t Minefield::getUndoMemory() const {
+    return journal->getMemory();
+}
 
-            // remove flags (as only safe spots get opened via this function this is safe to do)
-            flags[x][y] = false; 
-            // not been visited => open (non-recursively)
-            if (isGameRunning()) {
-                open(x, y, false);
+void Minefield::applyJournalEntry(const MoveJournal::Entry& entry, bool forward) {
+    // the fields revealed by losing (recorded when the game has been lost) are hidden again
+    auto mark_revealed = [this, &entry]() {
+        const JournalRun* revealed_runs = journal->getRevealedRuns(entry);
+        for (std::size_t i = 0; i < entry.end_revealed - entry.first_revealed; i++) {
+            for (int x = revealed_runs[i].x; x < revealed_runs[i].x + revealed_runs[i].length; x++) {
+                markChanged(x, revealed_runs[i].y);
             }
+        }
+    };
+    if (entry.lost && ! forward) {
+        mark_revealed();
+        opened_mine = false;
+    }
+    if (entry.relocated && forward) {
+        moveMine(entry.mine_x, entry.mine_y, entry.relocated_x, entry.relocated_y);
+    }
 
-            // only carry on if self has no sorrounding mines
-            if (0 == getSorroundingMineCount(x, y)) {
-                // add self to done list
-                done.push_back(coords_tuple);
+    // flags have been placed or removed -> toggling reverts and repeats the move
+    const JournalRun* flag_runs = journal->getFlagRuns(entry);
+    for (std::size_t i = 0; i < entry.end_flag - entry.first_flag; i++) {
+        const JournalRun& run = flag_runs[i];
+        for (int x = run.x; x < run.x + run.length; x++) {
+            bool flagged = ! getBit(FLAG_PLANE, x, run.y);
+            setBit(FLAG_PLANE, x, run.y, flagged);
+            flag_cnt += flagged ? 1 : -1;
+            addToSorroundingFlagCounts(x, run.y, flagged ? 1 : -1);
+            toggleStateHash(x, run.y, true);
+            markChanged(x, run.y);
+        }
+    }
 
-                // invoke self on sorrounding fields (no valid coord check, comes in next sub-call)
-                for (int dx : {-1, 0, 1}) {
-                    for (int dy : {-1, 0, 1}) {
-                        if (isGameRunning()) {
-                            recursive_open(x + dx, y + dy, done);
-                        }
+    const JournalRun* opened_runs = journal->getOpenedRuns(entry);
+    for (std::size_t i = 0; i < entry.end_opened - entry.first_opened; i++) {
+        const JournalRun& run = opened_runs[i];
+        for (int x = run.x; x < run.x + run.length; x++) {
+            setBit(OPEN_PLANE, x, run.y, forward);
+            toggleStateHash(x, run.y, false);
+            markChanged(x, run.y);
+        }
+        open_cnt += forward ? run.length : -run.length;
+
+        // fields next to a closed field have to be expanded again
+        // (fields opened again are simply expanded again when reached by the next region)
+        if (! forward) {
+            for (int row = run.y - 1; row <= run.y + 1; row++) {
+                for (int x = run.x - 1; x <= run.x + run.length; x++) {
+                    if (isPosValid(x, row)) {
+                        setBit(EXPANDED_PLANE, x, row, false);
                     }
                 }
             }
+        }
+    }
 
-            return true;
-        };
-
-        std::vector<std::tuple<int, int>> tmp_tuple_list;
-        recursive_open(x, y, tmp_tuple_list);
+    if (entry.relocated && ! forward) {
+        moveMine(entry.relocated_x, entry.relocated_y, entry.mine_x, entry.mine_y);
+    }
+    if (entry.lost && forward) {
+        opened_mine = true;
+        mark_revealed();
     }
 }
 
-int Minefield::getSorroundingMineCount(int x, int y) {
-    checkPos(x, y);
-    
-    if (isGameRunning() && ! isOpen(x, y)) {
-        throw std::runtime_error("Can't display sorrounding mines on unopened field while game is still running.");
+void Minefield::drainChangedCells(std::vector<std::tuple<int, int>>& into) {
+    into.clear();
+    std::swap(into, changed_cells);
+
+    for (auto& cell : into) {
+        setBit(DIRTY_PLANE, std::get<0>(cell), std::get<1>(cell), false);
     }
+}
 
-    int sum = 0;
+bool Minefield::isUnexpandedZero(int x, int y) const {
+    return ! getBit(EXPANDED_PLANE, x, y) && ! getBit(MINE_PLANE, x, y) && 0 == getCount(x, y);
+}
 
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
-            if (dx != 0 || dy != 0) {
-                // ignore self
-                int current_x = x + dx;
-                int current_y = y + dy;
-
-                if (isPosValid(current_x, current_y)) {
-                    if (mines[current_x][current_y]) {
-                        sum++;
-                    }
+void Minefield::openZeroRegion(int x, int y) {
+    // scanline fill:
+    // 1. take a seed, extend it to the left and right as long as there are unexpanded zero fields -> span
+    // 2. mark the span as expanded, open the span and all fields around it
+    // (only safe spots get opened this way, so flags can be removed)
+    // 3. push one seed for every run of unexpanded zero fields in the rows above and below
+    std::vector<std::tuple<int, int>> seeds;
+    seeds.push_back(std::make_tuple(x, y));
+
+    while (! seeds.empty() && isGameRunning()) {
+        int seed_x, seed_y;
+        std::tie(seed_x, seed_y) = seeds.back();
+        seeds.pop_back();
+
+        if (! isUnexpandedZero(seed_x, seed_y)) {
+            // reached via another span in the meantime
+            continue;
+        }
+
+        int left = seed_x;
+        while (isPosValid(left - 1, seed_y) && isUnexpandedZero(left - 1, seed_y)) {
+            left--;
+        }
+        int right = seed_x;
+        while (isPosValid(right + 1, seed_y) && isUnexpandedZero(right + 1, seed_y)) {
+            right++;
+        }
+
+        for (int span_x = left; span_x <= right; span_x++) {
+            setBit(EXPANDED_PLANE, span_x, seed_y, true);
+        }
+
+        int min_x = isPosValid(left - 1, seed_y) ? left - 1 : left;
+        int max_x = isPosValid(right + 1, seed_y) ? right + 1 : right;
+        for (int row = seed_y - 1; row <= seed_y + 1; row++) {
+            if (! isPosValid(left, row)) {
+                continue;
+            }
+
+            bool in_run = false;
+            for (int current_x = min_x; current_x <= max_x && isGameRunning(); current_x++) {
+                if (getBit(FLAG_PLANE, current_x, row)) {
+                    setBit(FLAG_PLANE, current_x, row, false);
+                    flag_cnt--;
+                    addToSorroundingFlagCounts(current_x, row, -1);
+                    toggleStateHash(current_x, row, true);
+                    journal->recordFlagToggled(current_x, row);
+                    markChanged(current_x, row);
                 }
+                uncover(current_x, row);
+
+                // new seed at the start of every run of zero fields
+                bool is_candidate = row != seed_y && isUnexpandedZero(current_x, row);
+                if (is_candidate && ! in_run) {
+                    seeds.push_back(std::make_tuple(current_x, row));
+                }
+                in_run = is_candidate;
             }
         }
     }
+}
+
+void Minefield::openZeroRegionBitwise(int x, int y) {
+    if (! isUnexpandedZero(x, y)) {
+        return;
+    }
 
-    return sum;
+    detachCells();
+
+    // the region is grown directly in the expanded plane:
+    // previously expanded regions are complete (all their neighbours w/o sorrounding mines are expanded as well),
+    // so they never grow and their border is open already
+    const int height = getYDimension();
+    std::uint64_t last_word_mask = (0 == getXDimension() % 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << (getXDimension() % 64)) - 1;
+    auto word = [this](int row, int word_x, Plane plane) -> std::uint64_t& {
+        return cell_words[(static_cast<std::size_t>(row) * words_per_row + word_x) * PLANE_COUNT + plane];
+    };
+    auto zeros = [&](int row, int word_x) {
+        std::uint64_t* current_group = &word(row, word_x, MINE_PLANE);
+        std::uint64_t zero = ~(current_group[MINE_PLANE] | current_group[COUNT_PLANE_0] | current_group[COUNT_PLANE_1] | current_group[COUNT_PLANE_2] | current_group[COUNT_PLANE_3]);
+        return (word_x + 1 == words_per_row) ? zero & last_word_mask : zero;
+    };
+    // region of the given row, grown by one field to the left and right
+    auto dilated = [&](int row, int word_x) {
+        std::uint64_t center = word(row, word_x, EXPANDED_PLANE);
+        std::uint64_t left = (0 < word_x) ? word(row, word_x - 1, EXPANDED_PLANE) : 0;
+        std::uint64_t right = (word_x + 1 < words_per_row) ? word(row, word_x + 1, EXPANDED_PLANE) : 0;
+        return center | (center << 1) | (left >> 63) | (center >> 1) | (right << 63);
+    };
+
+    // bounding box of the region (in rows and words)
+    int top = y;
+    int bottom = y;
+    int first_word = x / 64;
+    int last_word = x / 64;
+
+    // adds the given bits to the region of the row, fills them horizontally and updates the bounding box
+    // (the fill may carry across word borders in both directions)
+    auto grow = [&](int row, int word_x, std::uint64_t bits) {
+        word(row, word_x, EXPANDED_PLANE) |= bits;
+        for (int current = word_x, carry = 0; current < words_per_row; current++) {
+            std::uint64_t mask = zeros(row, current);
+            std::uint64_t& region = word(row, current, EXPANDED_PLANE);
+            std::uint64_t filled = fillUp(region | (carry & mask & 1), mask);
+            if (current != word_x && filled == region) {
+                break;
+            }
+            region = filled;
+            last_word = std::max(last_word, current);
+            carry = static_cast<int>(filled >> 63);
+        }
+        for (int current = word_x, carry = 0; current >= 0; current--) {
+            std::uint64_t mask = zeros(row, current);
+            std::uint64_t& region = word(row, current, EXPANDED_PLANE);
+            std::uint64_t carried = carry ? (mask & (std::uint64_t(1) << 63)) : 0;
+            std::uint64_t filled = fillDown(region | carried, mask);
+            if (current != word_x && filled == region) {
+                break;
+            }
+            region = filled;
+            first_word = std::min(first_word, current);
+            carry = static_cast<int>(filled & 1);
+        }
+        top = std::min(top, row);
+        bottom = std::max(bottom, row);
+    };
+
+    // takes the region of the rows above and below into the given row, returns true if it grew
+    auto sweepRow = [&](int row) {
+        bool grown = false;
+        for (int word_x = std::max(0, first_word - 1); word_x <= std::min(words_per_row - 1, last_word + 1); word_x++) {
+            std::uint64_t neighbours = 0;
+            if (0 < row) {
+                neighbours |= dilated(row - 1, word_x);
+            }
+            if (row + 1 < height) {
+                neighbours |= dilated(row + 1, word_x);
+            }
+            std::uint64_t bits = neighbours & zeros(row, word_x) & ~word(row, word_x, EXPANDED_PLANE);
+            if (0 != bits) {
+                grow(row, word_x, bits);
+                grown = true;
+            }
+        }
+        return grown;
+    };
+
+    grow(y, x / 64, std::uint64_t(1) << (x % 64));
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (int row = std::max(0, top - 1); row <= std::min(height - 1, bottom + 1); row++) {
+            grown |= sweepRow(row);
+        }
+        for (int row = std::min(height - 1, bottom + 1); row >= std::max(0, top - 1); row--) {
+            grown |= sweepRow(row);
+        }
+    }
+
+    // open the region and its border (only safe fields, so flags can be removed)
+    for (int row = std::max(0, top - 1); row <= std::min(height - 1, bottom + 1); row++) {
+        for (int word_x = std::max(0, first_word - 1); word_x <= std::min(words_per_row - 1, last_word + 1); word_x++) {
+            std::uint64_t border = dilated(row, word_x);
+            if (0 < row) {
+                border |= dilated(row - 1, word_x);
+            }
+            if (row + 1 < height) {
+                border |= dilated(row + 1, word_x);
+            }
+            if (word_x + 1 == words_per_row) {
+                border &= last_word_mask;
+            }
+
+            std::uint64_t opened = border & ~word(row, word_x, OPEN_PLANE);
+            std::uint64_t unflagged = opened & word(row, word_x, FLAG_PLANE);
+            word(row, word_x, OPEN_PLANE) |= opened;
+            word(row, word_x, FLAG_PLANE) &= ~opened;
+            open_cnt += __builtin_popcountll(opened);
+            flag_cnt -= __builtin_popcountll(unflagged);
+            while (0 != unflagged) {
+                addToSorroundingFlagCounts(word_x * 64 + __builtin_ctzll(unflagged), row, -1);
+                toggleStateHash(word_x * 64 + __builtin_ctzll(unflagged), row, true);
+                journal->recordFlagToggled(word_x * 64 + __builtin_ctzll(unflagged), row);
+                unflagged &= unflagged - 1;
+            }
+            recordOpenedWord(word_x, row, opened);
+
+            while (0 != opened) {
+                toggleStateHash(word_x * 64 + __builtin_ctzll(opened), row, false);
+                markChanged(word_x * 64 + __builtin_ctzll(opened), row);
+                opened &= opened - 1;
+            }
+        }
+    }
+}
+
+void Minefield::setExpansionEngine(ExpansionEngine engine) {
+    expansion_engine = engine;
+}
+
+bool Minefield::usesBitwiseExpansion() const {
+    if (chunked || ExpansionEngine::scanline == expansion_engine) {
+        return false;
+    }
+    return ExpansionEngine::bitwise == expansion_engine
+        || static_cast<std::int64_t>(getXDimension()) * getYDimension() >= BITWISE_EXPANSION_THRESHOLD;
 }
 
-int Minefield::getXDimension() {
-    return given_x_dimension;
+int Minefield::getSorroundingMineCount(int x, int y) const {
+    checkPos(x, y);
+    
+    if (isGameRunning() && ! isOpen(x, y)) {
+        throw std::runtime_error("Can't display sorrounding mines on unopened field while game is still running.");
+    }
+
+    return getCount(x, y);
 }
 
-int Minefield::getYDimension() {
-    return given_y_dimension;
+int Minefield::getSorroundingFlagCount(int x, int y) const {
+    checkPos(x, y);
+    return getGroupFlagCount(group(x, y), x);
 }
 
-int Minefield::getMineCount() {
+std::int64_t Minefield::getMineCount() const {
     return given_mine_count;
 }
 
-int Minefield::getFlagCount() {
+std::int64_t Minefield::getFlagCount() const {
     return flag_cnt;
 }
 
-int Minefield::getOpenCount() {
+std::int64_t Minefield::getOpenCount() const {
     return open_cnt;
 }
 
-int Minefield::getSeed() {
+std::int64_t Minefield::getSeed() const {
     return given_seed;
 }
+
+bool Minefield::isChunked() const {
+    return chunked;
+}
+
+std::size_t Minefield::getCellMemory() const {
+    if (chunked) {
+        return chunk_storage.getMemory();
+    }
+    return cells->size() * sizeof(std::uint64_t);
+}
+
+bool Minefield::isUnbounded() const {
+    return unbounded;
+}
+
+void Minefield::setChunkLimit(std::size_t max_chunks) {
+    if (chunked) {
+        chunk_storage.setChunkLimit(max_chunks);
+    }
+}
+
+std::size_t Minefield::getEvictedChunkCount() const {
+    if (chunked) {
+        return chunk_storage.getEvictedChunkCount();
+    }
+    return 0;
+}
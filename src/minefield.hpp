@@ -6,6 +6,16 @@
 #define __MINEFIELD_HPP_INCLUDED__
 
 #include <vector>
+#include <tuple>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <random>
+
+#include "board_planes.hpp"
+#include "chunked_storage.hpp"
+#include "move_journal.hpp"
 
 /// Implements the internal game logic
 /**
@@ -15,33 +25,93 @@
  * To keep calculation times low, a bunch of caching variables are used.
  * Therefore, the private attributes should only be directly accessed after careful code review.
  * This is unfourtunately necessary as otherwise constant iterations over the entire minefield are required.
+ *
+ * A minefield must only be used by one thread at a time, even for const access (reading a chunked storage allocates chunks).
+ * Copies of it may be used by other threads though: a copy still sharing the cells or the journal only writes in place
+ * once all other copies have released them (see isOnlyOwner()).
  */
 class Minefield {
     private:
-        /// mine positions
+        /// state of all cells
         /**
-         * Used to save the position of the mines, intialized in the constructor.
-         * Access from outside via isMine() method.
-         * Access internally directly.
-         * @see isMine()
+         * All cells in one contiguous block, row-major, bit-packed.
+         * Every row is padded to a multiple of 64 cells, so a row always starts on a new word.
+         * For every word of a row PLANE_COUNT words are stored: one per plane.
+         * (So the mine, flag and open bits of a cell are in the same cache line.)
+         * The amount of sorrounding mines is stored bit-sliced over the four count planes,
+         * it is calculated once in the constructor and kept up to date when a mine is moved.
+         *
+         * Only used if the storage is not chunked.
+         * Don't access directly, use getBit() and setBit().
+         *
+         * Shared between copies of the minefield (so copying is O(1)) until one of them changes a cell:
+         * every write goes through the non-const group(), which detaches the cells first (copy-on-write).
+         * @see Plane
+         * @see getBit()
+         * @see setBit()
+         * @see detachCells()
          */
-        std::vector<std::vector<bool>> mines;
+        std::shared_ptr<std::vector<std::uint64_t>> cells;
 
-        /// flag positions
+        /// first word of cells, nullptr if chunked
         /**
-         * Used to save the position of the flags, intialized in the constructor.
-         * Access via the flag()/unflag() methods.
-         * @see flag()
-         * @see unflag()
+         * Saves the indirection through the shared pointer on every access.
+         * Copies of the minefield share the cells, so this stays valid when copied.
          */
-        std::vector<std::vector<bool>> flags;
+        std::uint64_t* cell_words;
+
+        /// true if the cells are stored in chunk_storage instead of cells
+        bool chunked;
 
-        /// opened fields
+        /// true if the board has no borders (implies chunked)
         /**
-         * Saves the positions of the opened fields. Access via the open() method.
-         * @see open()
+         * @see createUnbounded()
+         */
+        bool unbounded;
+
+        /// state of all cells for very large boards
+        /**
+         * Holds the same groups as cells, but split into lazily allocated chunks.
+         * Only used if chunked is set.
+         * @see group()
+         */
+        ChunkedStorage chunk_storage;
+
+        /// amount of 64 bit words per row and plane
+        /**
+         * Row width in words (not cells), set in the constructor.
+         */
+        int words_per_row;
+
+        /// fields changed since the last drain
+        /**
+         * Every field whose visible state changed is appended once (deduplicated via the dirty plane).
+         * Retrieved and reset via drainChangedCells().
+         * Stays empty while change tracking is disabled.
+         * @see drainChangedCells()
+         * @see markChanged()
+         */
+        std::vector<std::tuple<int, int>> changed_cells;
+
+        /// true if changed fields are recorded
+        /**
+         * Disabled by default, so minefields that are never drained don't collect the changes forever.
+         * @see setChangeTrackingEnabled()
          */
-        std::vector<std::vector<bool>> opened;
+        bool track_changes;
+
+        /// changes of the moves, to undo and redo them
+        /**
+         * Disabled by default, so minefields used w/o undo don't pay for it.
+         * Every tryOpen(), tryFlag(), tryUnflag(), tryChord() (and every move of applyMoves()) is one entry.
+         * Shared between copies of the minefield like the cells, so copying doesn't copy the history:
+         * the journal is detached before an entry is recorded and before undo() and redo() step through it.
+         * @see setUndoEnabled()
+         * @see undo()
+         * @see redo()
+         * @see editJournal()
+         */
+        std::shared_ptr<MoveJournal> journal;
 
         /// seed used for generation
         /**
@@ -49,14 +119,14 @@ class Minefield {
          * Kept to potentially return later.
          * @see getSeed()
          */
-        int given_seed;
+        std::int64_t given_seed;
 
         /// caching var for mine count
         /**
          * Holds the amount of placed mines. Remains constant after initialisation through the constructor.
          * @see getMineCount()
          */
-        int given_mine_count;
+        std::int64_t given_mine_count;
 
         /// caching var for x dimension
         /**
@@ -79,7 +149,7 @@ class Minefield {
          * @see getOpenCount()
          * @see open()
          */
-        int open_cnt;
+        std::int64_t open_cnt;
 
         /// caching var for amount of placed flags
         /**
@@ -89,15 +159,26 @@ class Minefield {
          * @see flag()
          * @see unflag()
          */
-        int flag_cnt;
+        std::int64_t flag_cnt;
 
         /// caching var, true if a mine has been opened.
         /**
          * A caching var to save if a mine has been opened.
-         * Greatly decreased time for checks if the game is still running.
+         * Together with open_cnt all game state queries can be answered w/o looking at the fields.
          * @see isGameRunning()
+         * @see isGameWon()
+         * @see isGameLost()
          */
         bool opened_mine;
+
+        /// hash of the visible state: opened fields (w/ their amount of sorrounding mines) and flags
+        /**
+         * Xor of a random key per visible field (zobrist hashing), closed fields w/o flag have no key.
+         * Updated whenever a field is opened or a flag is placed or removed, so it is never calculated from the whole board.
+         * @see getStateHash()
+         * @see toggleStateHash()
+         */
+        std::uint64_t state_hash;
         
         /**
          * Throws if given position is invalid.
@@ -106,50 +187,421 @@ class Minefield {
          * @param y y coordinate
          * @throws std::exception if the given location is invalid
          */
-        void checkPos(int x, int y);
+        void checkPos(int x, int y) const;
 
         /**
          * Throws if the game is not running.
          * @throws std::exception if the game is not running anymore
          */
-        void checkRunning();
+        void checkRunning() const;
+
+        /**
+         * Creates the random number generator used to place the mines.
+         * Seeds in the range of a 32 bit int seed the generator directly, larger seeds are mixed in via a seed sequence.
+         * @param seed seed given on creation
+         * @return the seeded generator
+         */
+        static std::mt19937 createRandomizer(std::int64_t seed);
+
+        /**
+         * Fills the dense storage tile by tile, w/ the same mines as the chunked storage would place.
+         * Every tile only depends on the seed and its position, so the board doesn't depend on the amount of threads.
+         * @param thread_count amount of threads, 0 for one per core
+         */
+        void generateTiled(int thread_count);
+
+        /**
+         * Fills the dense storage w/ a board generated by a FixedBoard, if there is one for the dimensions.
+         * @param mine_count amount of mines to place
+         * @param seed seed for the random number generator
+         * @return false if the dimensions are not one of the classic sizes
+         */
+        bool generateFixed(int mine_count, std::int64_t seed);
+
+        /**
+         * Fills the dense storage w/ a board generated by FixedBoard<WIDTH, HEIGHT>.
+         * @param mine_count amount of mines to place
+         * @param seed seed for the random number generator
+         */
+        template <int WIDTH, int HEIGHT>
+        void copyFixedBoard(int mine_count, std::int64_t seed);
+
+        /**
+         * Allocates new dense cells, all bits cleared. Not shared w/ any other minefield.
+         * @param word_count amount of words
+         */
+        void allocateCells(std::size_t word_count);
+
+        /**
+         * Returns true if no other minefield shares the given data, so it may be changed in place.
+         * Copies sharing the data may live on other threads: the fence makes their reads (before they released the data)
+         * happen before the writes of this minefield. Only this minefield could copy the pointer again, so the count is exact.
+         * @param shared cells or journal of this minefield
+         * @return true if this minefield is the only owner
+         */
+        template<typename T>
+        static bool isOnlyOwner(const std::shared_ptr<T>& shared) {
+            if (1 != shared.use_count()) {
+                return false;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+
+        /**
+         * Copies the dense cells if they are shared w/ another minefield, so they can be changed.
+         * Called before every write.
+         */
+        void detachCells();
+
+        /**
+         * Copies the journal if it is shared w/ another minefield, so it can be changed.
+         * Called before every entry is recorded (only if recording is enabled) and before undo() and redo().
+         * @return the journal, not shared anymore
+         */
+        MoveJournal& editJournal();
+
+        /**
+         * Starts a journal entry for the move at the given position, if recording is enabled.
+         * @param x x coordinate of the move
+         * @param y y coordinate of the move
+         */
+        void beginJournalEntry(int x, int y);
+
+        /**
+         * Returns the group of 64 cells containing the given cell, from the dense or the chunked storage.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return pointer to the PLANE_COUNT words of the group
+         */
+        const std::uint64_t* group(int x, int y) const;
+
+        /**
+         * Returns the group of 64 cells containing the given cell, from the dense or the chunked storage.
+         * Detaches shared cells, as the group is going to be written.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return pointer to the PLANE_COUNT words of the group
+         */
+        std::uint64_t* group(int x, int y);
+
+        /**
+         * Returns the group containing the given cell from the chunked storage.
+         * Kept out of line, so the dense path of group() stays small enough to be inlined everywhere.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return pointer to the PLANE_COUNT words of the group
+         */
+        const std::uint64_t* chunkedGroup(int x, int y) const;
+
+        /**
+         * Reads the bit of a cell from the given plane.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param plane the plane to read from
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return the bit of the cell
+         */
+        bool getBit(Plane plane, int x, int y) const;
+
+        /**
+         * Sets the bit of a cell in the given plane.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param plane the plane to write to
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param value the new value of the bit
+         */
+        void setBit(Plane plane, int x, int y, bool value);
+
+        /**
+         * Returns the cached amount of sorrounding mines of a cell.
+         * Doesn't check the position, only call with valid coordinates.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return amount of mines in the 8 sorrounding cells
+         */
+        int getCount(int x, int y) const;
+
+        /**
+         * Adds the given value to the cached mine count of all cells sorrounding the given position.
+         * Used when a mine is placed (+1) or removed (-1).
+         * @param x x coordinate of the placed/removed mine
+         * @param y y coordinate of the placed/removed mine
+         * @param delta value to add to the sorrounding counts
+         */
+        void addToSorroundingCounts(int x, int y, int delta);
+
+        /**
+         * Adds the given value to the cached flag count of all cells sorrounding the given position.
+         * Called whenever a flag is placed (+1) or removed (-1), so chords don't have to count flags.
+         * @param x x coordinate of the placed/removed flag
+         * @param y y coordinate of the placed/removed flag
+         * @param delta value to add to the sorrounding flag counts
+         */
+        void addToSorroundingFlagCounts(int x, int y, int delta);
+
+        /**
+         * Moves the mine at the given position to a free field (used if the first opened field is a mine).
+         * Dense boards pick a random free field.
+         * Chunked boards can't list all free fields, so the next free field (in chunk order) is used.
+         * @param x x coordinate of the mine
+         * @param y y coordinate of the mine
+         */
+        void relocateMine(int x, int y);
+
+        /**
+         * Moves a mine to a field w/o mine and updates the sorrounding counts.
+         * @param from_x x coordinate of the mine
+         * @param from_y y coordinate of the mine
+         * @param to_x x coordinate of the field w/o mine
+         * @param to_y y coordinate of the field w/o mine
+         */
+        void moveMine(int from_x, int from_y, int to_x, int to_y);
+
+        /**
+         * Records the fields opened in a word of the given row as runs in the journal.
+         * @param word_x index of the word in the row
+         * @param y y coordinate of the row
+         * @param opened bits of the opened fields
+         */
+        void recordOpenedWord(int word_x, int y, std::uint64_t opened);
+
+        /**
+         * Reverts or repeats the changes of a journal entry, and marks the changed fields.
+         * Undone opens reset the expanded bits around the closed fields, the next region will expand them again.
+         * @param entry entry of the journal
+         * @param forward true to repeat (redo), false to revert (undo)
+         */
+        void applyJournalEntry(const MoveJournal::Entry& entry, bool forward);
+
+        /**
+         * Evicts chunks far away from the given position to disk, if the chunk limit is exceeded.
+         * Called at the end of every move, when no pointers into the storage are held anymore.
+         * @param x x coordinate of the move
+         * @param y y coordinate of the move
+         * @see setChunkLimit()
+         */
+        void evictFarChunks(int x, int y);
+
+        /**
+         * Opens a single field, w/o any checks.
+         * Updates the caching vars.
+         * @param x x coordinate
+         * @param y y coordinate
+         */
+        void uncover(int x, int y);
+
+        /**
+         * Appends the given field to the changed fields, unless it is already listed or change tracking is disabled.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @see drainChangedCells()
+         */
+        void markChanged(int x, int y);
+
+        /**
+         * Adds or removes the key of a visible field to/from the state hash (xor).
+         * Call whenever a field is opened or closed, or a flag is placed or removed.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param flag true for the key of the flag, false for the key of the opened field (depends on the sorrounding mines)
+         */
+        void toggleStateHash(int x, int y, bool flag);
+
+        /**
+         * Marks all fields as changed that become visible when the game is lost:
+         * mines w/o a flag and flags w/o a mine.
+         * Searches the whole board (the accessed chunks), the fields are recorded in the journal for undo and redo.
+         */
+        void markRevealed();
+
+        /**
+         * Returns true if the given field has no mine and no sorrounding mines, but has not been expanded by openZeroRegion() yet.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return true if the field has to be expanded
+         */
+        bool isUnexpandedZero(int x, int y) const;
+
+        /**
+         * Opens the region of fields w/o sorrounding mines containing the given field, including its border.
+         * Implemented as iterative scanline fill, so it runs in linear time and doesn't recurse.
+         * The expanded plane is used as visited bitmap.
+         * Flags inside the opened region are removed.
+         * Stops as soon as the game ends.
+         * @param x x coordinate of a field w/o sorrounding mines
+         * @param y y coordinate of a field w/o sorrounding mines
+         */
+        void openZeroRegion(int x, int y);
+
+        /**
+         * Opens the region of fields w/o sorrounding mines containing the given field, including its border.
+         * Same result as openZeroRegion(), but grows the region 64 fields at once:
+         * Rows are swept down and up, every row takes the (dilated) region of the rows above and below,
+         * masked by the fields w/o sorrounding mines, and fills it horizontally. Repeated until the region doesn't grow anymore.
+         * Only for the dense storage.
+         * @param x x coordinate of a field w/o sorrounding mines
+         * @param y y coordinate of a field w/o sorrounding mines
+         */
+        void openZeroRegionBitwise(int x, int y);
     public:
+        /// how the cells are stored
+        enum class StorageMode {
+            /// fixed for the classic sizes, dense for other regular boards, chunked above CHUNKED_THRESHOLD cells
+            automatic,
+            /// all cells in one block, allocated up front
+            dense,
+            /// like dense, but generated by a compile-time sized FixedBoard, only for 9x9, 16x16 and 30x16
+            fixed,
+            /// chunks of 64x64 cells allocated on first access, see ChunkedStorage
+            chunked,
+            /// like dense, but generated in tiles of 64x64 cells on all cores, same board as chunked
+            tiled
+        };
+
+        /// how regions w/o sorrounding mines are opened
+        enum class ExpansionEngine {
+            /// bitwise on dense boards w/ at least BITWISE_EXPANSION_THRESHOLD cells, scanline otherwise
+            automatic,
+            /// scanline fill, one field at a time
+            scanline,
+            /// dilation of whole words until nothing changes anymore, only on dense boards (falls back to scanline on chunked boards)
+            bitwise
+        };
+
+        /// result of the non-throwing moves tryOpen(), tryFlag() and tryUnflag()
+        enum class MoveResult {
+            /// at least one field has been opened (the game may have ended by it)
+            opened,
+            /// the field is open already: nothing opened, no flag placed or removed
+            already_open,
+            /// the field carries a flag: not opened, no second flag placed
+            flagged,
+            /// a flag has been placed
+            flag_placed,
+            /// a flag has been removed
+            flag_removed,
+            /// there is no flag to remove
+            not_flagged,
+            /// chord on a field that hasn't been opened yet, nothing changed
+            not_open,
+            /// the game is not running anymore, nothing changed
+            game_over,
+            /// the position is not on the board, nothing changed
+            invalid,
+            /// the move is not allowed by the controller (open w/ autodiscover only), nothing changed
+            not_allowed
+        };
+
+        /// kind of a move, see Move
+        enum class MoveType {
+            /// tryOpen(), recursive
+            open,
+            /// tryFlag()
+            flag,
+            /// tryUnflag()
+            unflag,
+            /// tryChord()
+            chord
+        };
+
+        /// a single move of a batch, see applyMoves()
+        struct Move {
+            /// what to do
+            MoveType type;
+            /// x coordinate
+            int x;
+            /// y coordinate
+            int y;
+        };
+
+        /// amount of cells from which ExpansionEngine::automatic picks the bitwise engine
+        static const std::int64_t BITWISE_EXPANSION_THRESHOLD = 4096;
+
+        /// amount of cells above which StorageMode::automatic picks the chunked storage
+        static const std::int64_t CHUNKED_THRESHOLD = std::int64_t(1) << 26;
+
+        /// coordinates of unbounded boards must be strictly between -UNBOUNDED_LIMIT and UNBOUNDED_LIMIT
+        /**
+         * Keeps all coordinate calculations far away from integer overflows.
+         */
+        static const int UNBOUNDED_LIMIT = 1 << 30;
+
+        /// minimum mine density of unbounded boards (in percent)
+        /**
+         * Below that the regions w/o sorrounding mines can grow infinitely large, so a single click could never finish.
+         */
+        static const int MIN_UNBOUNDED_DENSITY = 12;
+
         /**
          * Creates a new Minefield.
          * Mines are automatically randomly placed.
          * Given Dimensions must both be >0
+         *
+         * Dense boards place the mines w/ a Mersenne Twister seeded by seed (so a seed always gives the same board).
+         * Chunked (and tiled) boards derive the mines of every chunk from the seed and the chunk position,
+         * so they result in a different placement for the same seed.
          * @param dimension_x amount of columns, index: 0..dimension_x-1
          * @param dimension_y amount of rows, index: 0..dimension_y-1
          * @param mine_count amount of mines to be placed
          * @param seed seed to initialize the random number generator
-         * @throws std::exception if dimension_x or dimension_y are 0 or less, more mines should be placed than spots are available
+         * @param storage_mode how the cells are stored, by default chunked only for very large boards
+         * @throws std::exception if dimension_x or dimension_y are 0 or less, more mines should be placed than spots are available, or the storage mode is fixed on a non-classic size
+         */
+        Minefield(int dimension_x = 8, int dimension_y = 8, std::int64_t mine_count = 10, std::int64_t seed = 0, StorageMode storage_mode = StorageMode::automatic);
+
+        /**
+         * Creates a new Minefield w/o borders.
+         * Chunks are generated from the seed as they are explored, every chunk holds the same share of mines.
+         * Coordinates can be negative, see UNBOUNDED_LIMIT for the valid range.
+         * The game can only be lost: it runs until a mine is opened.
+         * @param mine_density percentage of cells w/ a mine, MIN_UNBOUNDED_DENSITY..99
+         * @param seed seed to place the mines
+         * @return the new minefield
+         * @throws std::exception if the density is out of range
+         */
+        static Minefield createUnbounded(int mine_density, std::int64_t seed = 0);
+
+        /**
+         * Creates a new Minefield w/ the tiled storage, generated by the given amount of threads.
+         * The board only depends on the seed, not on the amount of threads.
+         * @param dimension_x amount of columns, index: 0..dimension_x-1
+         * @param dimension_y amount of rows, index: 0..dimension_y-1
+         * @param mine_count amount of mines to be placed
+         * @param seed seed to place the mines
+         * @param thread_count amount of threads, 0 for one per core
+         * @return the new minefield
+         * @throws std::exception if the dimensions or the mine count are invalid
          */
-        Minefield(int dimension_x = 8, int dimension_y = 8, int mine_count = 10, int seed = 0);
+        static Minefield createTiled(int dimension_x, int dimension_y, std::int64_t mine_count, std::int64_t seed, int thread_count);
         
         /**
          * Returns true if the game has ended and no more moves can be taken
          * @return true if no more turns can be taken
          */
-        bool isGameEnded();
+        bool isGameEnded() const;
 
         /**
          * Returns true if the game is still running and more moves can be made.
          * @return true if more turns can be taken
          */
-        bool isGameRunning();
+        bool isGameRunning() const;
 
         /**
          * Returns true if the game is over and has been won.
          * @return true if game is over & won
          */
-        bool isGameWon();
+        bool isGameWon() const;
 
         /**
          * Returns true if the game is over and has been lost.
          * (By clicking on a mine e.g.)
          * @return true if game is over & lost
          */
-        bool isGameLost();
+        bool isGameLost() const;
 
         /**
          * Returns true if the given coordinates are a valid position on the current playing field.
@@ -158,7 +610,7 @@ class Minefield {
          * @param y y coordinate
          * @return true if the given coordinates are on the playing field.
          */
-        bool isPosValid(int x, int y);
+        bool isPosValid(int x, int y) const;
         
         /**
          * Returns true if a flag has been set at the given location.
@@ -168,7 +620,7 @@ class Minefield {
          * @return true if given position has a flag on it
          * @throws std::exception if the given position is invalid
          */
-        bool isFlagged(int x, int y);
+        bool isFlagged(int x, int y) const;
 
         /**
          * Returns true if the given position has been opened.
@@ -178,7 +630,7 @@ class Minefield {
          * @return true if given position has been opened
          * @throws std::exception if the given position is invalid
          */
-        bool isOpen(int x, int y);
+        bool isOpen(int x, int y) const;
 
         /**
          * Returns true if the given position is a mine (and has been opened).
@@ -190,7 +642,7 @@ class Minefield {
          * @return true if given position is a mince
          * @throws std::exception if the given position is invalid or has not been opened (and game is running)
          */
-        bool isMine(int x, int y);
+        bool isMine(int x, int y) const;
 
         /**
          * Places a flag on the given coordinates.
@@ -227,6 +679,57 @@ class Minefield {
          */
         void open(int x, int y, bool recursive = true);
 
+        /**
+         * Opens the given field, like open(), but reports errors as result instead of throwing.
+         * Meant for callers issuing lots of moves (e.g. bots), where late or invalid moves are expected.
+         * An open field w/o sorrounding mines that has been opened non-recursively is expanded, like open() does.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param recursive will open sorrounding fields if current field has no sorrounding mines
+         * @return opened if any field has been opened, otherwise why not: already_open, flagged, game_over or invalid
+         */
+        MoveResult tryOpen(int x, int y, bool recursive = true);
+
+        /**
+         * Places a flag on the given field, like flag(), but reports errors as result instead of throwing.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return flag_placed, or why not: flagged (already), already_open, game_over or invalid
+         */
+        MoveResult tryFlag(int x, int y);
+
+        /**
+         * Removes the flag from the given field, like unflag(), but reports errors as result instead of throwing.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return flag_removed, or why not: not_flagged, already_open, game_over or invalid
+         */
+        MoveResult tryUnflag(int x, int y);
+
+        /**
+         * Opens all sorrounding fields w/o flag of an open field, if as many flags are placed around it as there are sorrounding mines (autodiscover).
+         * Reports errors as result instead of throwing.
+         * The amount of sorrounding flags is cached per field, so checking the flags is a single lookup.
+         * @param x x coordinate of an open field
+         * @param y y coordinate of an open field
+         * @return opened if any field has been opened, already_open if the flags don't match the sorrounding mines (or all are open),
+         *         otherwise why not: flagged, not_open, game_over or invalid
+         */
+        MoveResult tryChord(int x, int y);
+
+        /**
+         * Applies the given moves in order, like the try* calls, and collects all changes.
+         * Moves after the end of the game are reported as game_over.
+         * Chunks are evicted once after the batch (instead of after every move).
+         * @param moves first move
+         * @param move_count amount of moves
+         * @param results receives one result per move, must hold move_count results
+         * @param changed receives the fields changed since the last drain (incl. the whole batch), every field once.
+         *                The changes of the batch are collected even while change tracking is disabled.
+         * @see drainChangedCells()
+         */
+        void applyMoves(const Move* moves, std::size_t move_count, MoveResult* results, std::vector<std::tuple<int, int>>& changed);
+
         /**
          * Returns the amount of the sorrounding mines (0-8).
          * Throws when the given field cannot be checked (isn't opened.)
@@ -236,48 +739,314 @@ class Minefield {
          * @return the number of the sorrounding mines, >=0 and <=8
          * @throws std::exception if the given position is invalid or on non-opened position before game end
          */
-        int getSorroundingMineCount(int x, int y);
+        int getSorroundingMineCount(int x, int y) const;
+
+        /**
+         * Returns the amount of flags placed on the sorrounding fields (0-8).
+         * The count is kept up to date on every flag change, so this is a single lookup.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return the number of the sorrounding flags, >=0 and <=8
+         * @throws std::exception if the given position is invalid
+         */
+        int getSorroundingFlagCount(int x, int y) const;
+
+        /**
+         * Retrieves the fields whose visible state changed since the last call.
+         * Covers opened fields (including recursively opened ones), placed and removed flags and the mines revealed after losing.
+         * Every field is reported at most once per call.
+         * Changes are only recorded while change tracking is enabled, see setChangeTrackingEnabled().
+         *
+         * The given vector is cleared and swapped with the internal list,
+         * so passing the same vector on every call doesn't allocate once both have grown large enough.
+         * @param into receives the (x, y) coordinates of the changed fields
+         */
+        void drainChangedCells(std::vector<std::tuple<int, int>>& into);
+
+        /**
+         * Returns a 64 bit hash of the visible state: which fields are open (and their amount of sorrounding mines), and where flags are placed.
+         * Boards w/ the same visible state have the same hash, independent of the moves leading to it (also w/ undo).
+         * Mines revealed by losing are not part of the state.
+         * Kept up to date w/ every changed field, so it is available immediately (e.g. for transposition tables).
+         * @return hash of the visible state, 0 if nothing is open or flagged
+         */
+        std::uint64_t getStateHash() const;
 
         /**
          * Returns the amount of columns (width of the field).
+         * Unbounded boards return 0.
          * Note: return value == 10 -> Indexes are 0-9
          * (Index 10 doesn't exist)
          * @return the width of the playing field
          */
-        int getXDimension();
+        int getXDimension() const;
 
         /**
          * Returns the amount of rows (height of the field).
+         * Unbounded boards return 0.
          * Note: return value == 10 -> Indexes are 0-9
          * (Index 10 doesn't exist)
          * @return the height of the playing field
          */
-        int getYDimension();
+        int getYDimension() const;
 
         /**
          * Returns the amount of all mines.
-         * @return amount of all mines
+         * @return amount of all mines, -1 on unbounded boards
          */
-        int getMineCount();
+        std::int64_t getMineCount() const;
 
         /**
          * Returns the amount of placed flags.
          * Note: There can be more flags than mines
          * @return amount of placed flags
          */
-        int getFlagCount();
+        std::int64_t getFlagCount() const;
 
         /**
          * Returns the amount of opened fields.
          * @return amount of opened fields
          */
-        int getOpenCount();
+        std::int64_t getOpenCount() const;
 
         /**
          * Returns the seed the RNG has been initialized w/
          * @return seed given on creation
          */
-        int getSeed();
+        std::int64_t getSeed() const;
+
+        /**
+         * Returns true if the cells are stored in lazily allocated chunks.
+         * @return true if the board uses the chunked storage
+         */
+        bool isChunked() const;
+
+        /**
+         * Returns true if the board has no borders.
+         * @return true if the board has been created by createUnbounded()
+         */
+        bool isUnbounded() const;
+
+        /**
+         * Limits the amount of chunks kept in memory, 0 for no limit.
+         * After every move, chunks far away from the move are evicted to a temporary file once the limit is exceeded.
+         * Does nothing on boards that are not chunked.
+         * Copies of the minefield keep the limit, but load all evicted chunks back into memory.
+         * @param max_chunks maximum amount of chunks in memory
+         * @throws std::exception if the temporary file can't be created
+         */
+        void setChunkLimit(std::size_t max_chunks);
+
+        /**
+         * Returns the amount of chunks that have been evicted to disk.
+         * @return amount of evicted chunks, 0 on boards that are not chunked
+         */
+        std::size_t getEvictedChunkCount() const;
+
+        /**
+         * Returns the amount of cell memory allocated, in bytes.
+         * For chunked boards this grows w/ the explored area.
+         * @return bytes used to store the cells
+         */
+        std::size_t getCellMemory() const;
+
+        /**
+         * Selects how regions w/o sorrounding mines are opened by open().
+         * All engines result in the same board, they only differ in speed.
+         * @param engine engine to use
+         */
+        void setExpansionEngine(ExpansionEngine engine);
+
+        /**
+         * Returns true if open() uses the bitwise engine on this board.
+         * @return true if the bitwise engine is selected (or picked automatically) and the storage supports it
+         */
+        bool usesBitwiseExpansion() const;
+
+        /**
+         * Returns true if the cells are shared w/ a copy of this minefield (or the minefield it has been copied from).
+         * Copies share the cells until one of them changes, so bots can branch off copies cheaply.
+         * @return true if the cells have not been copied yet
+         */
+        bool isSharingCells() const;
+
+        /**
+         * Returns true if the undo journal is shared w/ a copy of this minefield (or the minefield it has been copied from).
+         * Copies share the journal until one of them records, undoes or redoes a move.
+         * @return true if the journal has not been copied yet
+         */
+        bool isSharingJournal() const;
+
+        /**
+         * Enables or disables recording the changed fields, to be retrieved by drainChangedCells().
+         * Enabled tracking must be drained regularly, the changes pile up otherwise.
+         * Disabling discards all changes not drained yet.
+         * @param enabled true to record the changed fields
+         */
+        void setChangeTrackingEnabled(bool enabled);
+
+        /**
+         * Returns true if the changed fields are recorded.
+         * @return true if change tracking is enabled
+         */
+        bool isChangeTrackingEnabled() const;
+
+        /**
+         * Enables or disables recording the moves, so they can be undone.
+         * Enabling (and disabling) discards all previously recorded moves.
+         * @param enabled true to record moves
+         */
+        void setUndoEnabled(bool enabled);
+
+        /**
+         * Returns true if the moves are recorded for undo.
+         * @return true if undo is enabled
+         */
+        bool isUndoEnabled() const;
+
+        /**
+         * Returns true if there is a recorded move to undo.
+         * @return true if undo() would change the board
+         */
+        bool canUndo() const;
+
+        /**
+         * Returns true if there is an undone move to redo.
+         * @return true if redo() would change the board
+         */
+        bool canRedo() const;
+
+        /**
+         * Reverts the last recorded move (incl. the entire opened region, removed flags and losing the game).
+         * Only moves that changed something are recorded.
+         * The reverted fields are reported as changed.
+         * Runs in time proportional to the amount of fields changed by the move (incl. the fields revealed by losing).
+         * @return false if there is no move to undo, nothing changed
+         */
+        bool undo();
+
+        /**
+         * Repeats the last undone move. Undone moves are discarded by the next move.
+         * The repeated fields are reported as changed.
+         * @return false if there is no move to redo, nothing changed
+         */
+        bool redo();
+
+        /**
+         * Returns the amount of bytes used by the recorded moves.
+         * Proportional to the amount of changed fields: opened regions are stored as runs of fields, not as copies of the board.
+         * @return used memory in bytes
+         */
+        std::size_t getUndoMemory() const;
+
+    private:
+        /// engine used to open regions w/o sorrounding mines
+        /**
+         * @see setExpansionEngine()
+         */
+        ExpansionEngine expansion_engine;
+
+
+        /**
+         * Implementation of tryOpen(), w/o evicting chunks.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @param recursive will open sorrounding fields if current field has no sorrounding mines
+         * @return see tryOpen()
+         */
+        MoveResult openField(int x, int y, bool recursive);
+
+        /**
+         * Implementation of tryFlag(), w/o evicting chunks.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return see tryFlag()
+         */
+        MoveResult flagField(int x, int y);
+
+        /**
+         * Implementation of tryUnflag(), w/o evicting chunks.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return see tryUnflag()
+         */
+        MoveResult unflagField(int x, int y);
+
+        /**
+         * Implementation of tryChord(), w/o evicting chunks.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return see tryChord()
+         */
+        MoveResult chordField(int x, int y);
 };
 
+// The cell queries below are called for every cell on every frame,
+// so they are defined inline to boil down to a bounds check plus shift-and-mask.
+
+inline const std::uint64_t* Minefield::group(int x, int y) const {
+    if (__builtin_expect(chunked, false)) {
+        return chunkedGroup(x, y);
+    }
+    return &cell_words[(static_cast<std::size_t>(y) * words_per_row + (x >> 6)) * PLANE_COUNT];
+}
+
+inline std::uint64_t* Minefield::group(int x, int y) {
+    if (__builtin_expect(chunked, false)) {
+        return const_cast<std::uint64_t*>(chunkedGroup(x, y));
+    }
+    if (__builtin_expect(! isOnlyOwner(cells), false)) {
+        detachCells();
+    }
+    return &cell_words[(static_cast<std::size_t>(y) * words_per_row + (x >> 6)) * PLANE_COUNT];
+}
+
+inline bool Minefield::getBit(Plane plane, int x, int y) const {
+    return getGroupBit(group(x, y), plane, x);
+}
+
+inline void Minefield::setBit(Plane plane, int x, int y, bool value) {
+    setGroupBit(group(x, y), plane, x, value);
+}
+
+inline void Minefield::checkPos(int x, int y) const {
+    if (! isPosValid(x, y)) {
+        throw std::runtime_error("Given position is invalid.");
+    }
+}
+
+inline bool Minefield::isPosValid(int x, int y) const {
+    if (unbounded) {
+        return -UNBOUNDED_LIMIT < x && x < UNBOUNDED_LIMIT && -UNBOUNDED_LIMIT < y && y < UNBOUNDED_LIMIT;
+    }
+
+    if (x < 0 || x >= getXDimension()) {
+        return false;
+    }
+
+    if (y < 0 || y >= getYDimension()) {
+        return false;
+    }
+
+    return true;
+}
+
+inline bool Minefield::isFlagged(int x, int y) const {
+    checkPos(x, y);
+    return getBit(FLAG_PLANE, x, y);
+}
+
+inline bool Minefield::isOpen(int x, int y) const {
+    checkPos(x, y);
+    return getBit(OPEN_PLANE, x, y);
+}
+
+inline int Minefield::getXDimension() const {
+    return given_x_dimension;
+}
+
+inline int Minefield::getYDimension() const {
+    return given_y_dimension;
+}
+
 #endif // __MINEFIELD_HPP_INCLUDED__
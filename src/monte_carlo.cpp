@@ -0,0 +1,407 @@
+/// monte carlo estimator method bodies
+/** \file
+ * Contains the method bodies for the sampling mine probability estimator.
+ */
+#include "monte_carlo.hpp"
+
+#include "frontier.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+/// weighted sums of the samples of a single thread
+/**
+ * All weights are stored relative to exp(log_scale), the largest weight seen so far,
+ * so neither the sums nor the squared sums overflow.
+ */
+struct SampleSums {
+    /// log of the weight all sums are relative to
+    double log_scale = -std::numeric_limits<double>::infinity();
+    /// sum of weights
+    double weight = 0;
+    /// sum of squared weights
+    double squared = 0;
+    /// sum of weights, per frontier field being a mine
+    std::vector<double> mine;
+    /// sum of squared weights, per frontier field being a mine
+    std::vector<double> mine_squared;
+    /// sum of weights times the interior density
+    double interior = 0;
+    /// sum of squared weights times the interior density
+    double interior_squared = 0;
+    /// sum of squared weights times the squared interior density
+    double interior_squared_twice = 0;
+    /// amount of accepted samples
+    std::int64_t accepted = 0;
+    /// amount of rejected samples
+    std::int64_t rejected = 0;
+
+    /**
+     * Multiplies all sums by exp(log_scale - new_log_scale), so they are relative to the new scale.
+     * @param new_log_scale log of the new reference weight, >= log_scale
+     */
+    void rescale(double new_log_scale) {
+        if (std::isinf(log_scale)) {
+            log_scale = new_log_scale;
+            return;
+        }
+        double factor = std::exp(log_scale - new_log_scale);
+        double squared_factor = factor * factor;
+        weight *= factor;
+        squared *= squared_factor;
+        interior *= factor;
+        interior_squared *= squared_factor;
+        interior_squared_twice *= squared_factor;
+        for (std::size_t i = 0; i < mine.size(); i++) {
+            mine[i] *= factor;
+            mine_squared[i] *= squared_factor;
+        }
+        log_scale = new_log_scale;
+    }
+};
+
+/**
+ * Turns weighted sums into an estimate w/ a ~95% confidence interval.
+ * @param sum sum of weights where the event happened
+ * @param sum_squared sum of squared weights where the event happened (x^2 = x for 0/1 events)
+ * @param sums sums of all weights
+ * @return estimate
+ */
+static MonteCarloEstimator::Estimate toEstimate(double sum, double sum_squared, const SampleSums& sums) {
+    double p = sum / sums.weight;
+    double variance = (sum_squared * (1 - 2 * p) + p * p * sums.squared) / (sums.weight * sums.weight);
+    double half_width = 1.96 * std::sqrt(std::max(0.0, variance));
+    return {p, std::max(0.0, p - half_width), std::min(1.0, p + half_width)};
+}
+
+MonteCarloEstimator::MonteCarloEstimator() {
+    thread_count = 0;
+    time_budget = 100;
+    sample_limit = 0;
+    seed = 0;
+    cancel_check = nullptr;
+    interior = {0, 0, 0};
+    width = 0;
+    sample_count = 0;
+    rejected_count = 0;
+    effective_sample_size = 0;
+}
+
+void MonteCarloEstimator::setThreadCount(int given_thread_count) {
+    thread_count = given_thread_count;
+}
+
+void MonteCarloEstimator::setTimeBudget(double ms) {
+    time_budget = ms;
+}
+
+void MonteCarloEstimator::setSampleLimit(std::int64_t given_sample_limit) {
+    sample_limit = given_sample_limit;
+}
+
+void MonteCarloEstimator::setSeed(std::int64_t given_seed) {
+    seed = given_seed;
+}
+
+void MonteCarloEstimator::setCancelCheck(std::function<bool()> cancelled) {
+    cancel_check = cancelled;
+}
+
+void MonteCarloEstimator::estimate(const Minefield& mfield) {
+    if (mfield.isUnbounded()) {
+        throw std::runtime_error("Probabilities can only be estimated for bounded minefields.");
+    }
+    if (time_budget <= 0 && sample_limit <= 0) {
+        throw std::runtime_error("Sampling requires a time budget or a sample limit.");
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::milli>(time_budget);
+
+    frontier.clear();
+    interior = {0, 0, 0};
+    sample_count = 0;
+    rejected_count = 0;
+    effective_sample_size = 0;
+    width = mfield.getXDimension();
+    open.assign(static_cast<std::size_t>(width) * mfield.getYDimension(), false);
+    if (! mfield.isGameRunning()) {
+        return;
+    }
+
+    // all components are sampled together, they share the remaining mines
+    Frontier visible = readFrontier(mfield);
+    std::vector<std::uint64_t> fields;
+    std::vector<std::vector<int>> constraint_fields;
+    std::vector<int> constraint_mines;
+    std::vector<std::vector<int>> touching;
+    for (auto& component : visible.components) {
+        int first_field = static_cast<int>(fields.size());
+        fields.insert(fields.end(), component.fields.begin(), component.fields.end());
+        touching.resize(fields.size());
+        for (std::size_t c = 0; c < component.constraint_fields.size(); c++) {
+            std::vector<int> own;
+            for (int field : component.constraint_fields[c]) {
+                own.push_back(first_field + field);
+                touching[first_field + field].push_back(static_cast<int>(constraint_fields.size()));
+            }
+            constraint_fields.push_back(own);
+            constraint_mines.push_back(component.constraint_mines[c]);
+        }
+    }
+    std::vector<int> constraint_sizes;
+    for (auto& own : constraint_fields) {
+        constraint_sizes.push_back(static_cast<int>(own.size()));
+    }
+    std::int64_t interior_count = visible.interior_count;
+    std::int64_t mine_count = mfield.getMineCount();
+    open.swap(visible.open);
+
+    double density = static_cast<double>(mine_count) / static_cast<double>(visible.closed_count);
+    density = std::min(std::max(density, 1e-6), 1 - 1e-6);
+    double log_mine = std::log(density);
+    double log_safe = std::log(1 - density);
+
+    int threads_to_use = thread_count;
+    if (threads_to_use <= 0) {
+        threads_to_use = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    std::atomic<std::int64_t> attempts(0);
+    std::vector<SampleSums> thread_sums(threads_to_use);
+    auto sample = [&](int thread) {
+        SampleSums& sums = thread_sums[thread];
+        sums.mine.assign(fields.size(), 0.0);
+        sums.mine_squared.assign(fields.size(), 0.0);
+
+        std::seed_seq sequence = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(static_cast<std::uint64_t>(seed) >> 32), static_cast<std::uint32_t>(thread)};
+        std::mt19937 rdm_num_machine(sequence);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        // per open field: mines and fields left; per field: -1 if unassigned, otherwise 1 for mines
+        std::vector<int> remaining(constraint_mines.size()), unassigned(constraint_mines.size());
+        std::vector<int> values(fields.size());
+        // assigned fields in order (to undo them), mines in the same order
+        std::vector<int> trail, mines;
+        // open fields that force their other fields
+        std::vector<int> forced;
+
+        // assigns a field and queues the open fields that force their other fields now, false on a contradiction
+        auto assign = [&](int field, int value) {
+            values[field] = value;
+            trail.push_back(field);
+            if (1 == value) {
+                mines.push_back(field);
+            }
+            bool valid = true;
+            for (int c : touching[field]) {
+                unassigned[c]--;
+                remaining[c] -= value;
+                valid = valid && 0 <= remaining[c] && remaining[c] <= unassigned[c];
+                if (0 < unassigned[c] && (0 == remaining[c] || remaining[c] == unassigned[c])) {
+                    forced.push_back(c);
+                }
+            }
+            return valid;
+        };
+
+        // assigns the fields of the queued open fields, false on a contradiction
+        auto propagate = [&]() {
+            while (! forced.empty()) {
+                int c = forced.back();
+                forced.pop_back();
+                if (0 == unassigned[c]) {
+                    continue;
+                }
+                int value = (0 == remaining[c]) ? 0 : 1;
+                for (int field : constraint_fields[c]) {
+                    if (-1 == values[field] && ! assign(field, value)) {
+                        forced.clear();
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+
+        // reverts all assignments after the given length of the trail
+        auto undo = [&](std::size_t length) {
+            while (length < trail.size()) {
+                int field = trail.back();
+                trail.pop_back();
+                for (int c : touching[field]) {
+                    unassigned[c]++;
+                    remaining[c] += values[field];
+                }
+                if (1 == values[field]) {
+                    mines.pop_back();
+                }
+                values[field] = -1;
+            }
+        };
+
+        while (true) {
+            if (0 < sample_limit && sample_limit <= attempts++) {
+                break;
+            }
+            if (0 < time_budget && deadline <= std::chrono::steady_clock::now()) {
+                break;
+            }
+            if (cancel_check && cancel_check()) {
+                break;
+            }
+
+            std::copy(constraint_mines.begin(), constraint_mines.end(), remaining.begin());
+            std::copy(constraint_sizes.begin(), constraint_sizes.end(), unassigned.begin());
+            std::fill(values.begin(), values.end(), -1);
+            trail.clear();
+            mines.clear();
+            forced.clear();
+            for (std::size_t c = 0; c < constraint_mines.size(); c++) {
+                if (0 == remaining[c] || remaining[c] == unassigned[c]) {
+                    forced.push_back(static_cast<int>(c));
+                }
+            }
+
+            // only fields that aren't forced are chosen at random, a value leading to a contradiction right away is never chosen
+            double log_probability = 0;
+            bool valid = propagate();
+            for (std::size_t i = 0; i < fields.size() && valid; i++) {
+                if (-1 != values[i]) {
+                    continue;
+                }
+
+                // (the mine is tried last and kept if chosen)
+                std::size_t length = trail.size();
+                bool possible[2];
+                possible[0] = assign(static_cast<int>(i), 0) && propagate();
+                undo(length);
+                possible[1] = assign(static_cast<int>(i), 1) && propagate();
+
+                int value;
+                if (possible[0] && possible[1]) {
+                    value = (uniform(rdm_num_machine) < density) ? 1 : 0;
+                    log_probability += (1 == value) ? log_mine : log_safe;
+                } else if (possible[0] || possible[1]) {
+                    value = possible[1] ? 1 : 0;
+                } else {
+                    valid = false;
+                    break;
+                }
+                if (0 == value) {
+                    undo(length);
+                    valid = assign(static_cast<int>(i), 0) && propagate();
+                }
+            }
+
+            std::int64_t interior_mines = mine_count - static_cast<std::int64_t>(mines.size());
+            double log_weight = logBinomial(interior_count, interior_mines) - log_probability;
+            if (! valid || std::isinf(log_weight)) {
+                sums.rejected++;
+                continue;
+            }
+
+            if (sums.log_scale < log_weight) {
+                sums.rescale(log_weight);
+            }
+            double weight = std::exp(log_weight - sums.log_scale);
+            double squared = weight * weight;
+            double interior_density = (0 < interior_count) ? static_cast<double>(interior_mines) / static_cast<double>(interior_count) : 0.0;
+            sums.weight += weight;
+            sums.squared += squared;
+            sums.interior += weight * interior_density;
+            sums.interior_squared += squared * interior_density;
+            sums.interior_squared_twice += squared * interior_density * interior_density;
+            for (int field : mines) {
+                sums.mine[field] += weight;
+                sums.mine_squared[field] += squared;
+            }
+            sums.accepted++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < threads_to_use; thread++) {
+        threads.emplace_back(sample, thread);
+    }
+    sample(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // merge relative to the largest weight of all threads
+    SampleSums total;
+    total.mine.assign(fields.size(), 0.0);
+    total.mine_squared.assign(fields.size(), 0.0);
+    for (auto& sums : thread_sums) {
+        total.log_scale = std::max(total.log_scale, sums.log_scale);
+    }
+    for (auto& sums : thread_sums) {
+        sample_count += sums.accepted;
+        rejected_count += sums.rejected;
+        if (0 == sums.accepted) {
+            continue;
+        }
+        sums.rescale(total.log_scale);
+        total.weight += sums.weight;
+        total.squared += sums.squared;
+        total.interior += sums.interior;
+        total.interior_squared += sums.interior_squared;
+        total.interior_squared_twice += sums.interior_squared_twice;
+        for (std::size_t i = 0; i < fields.size(); i++) {
+            total.mine[i] += sums.mine[i];
+            total.mine_squared[i] += sums.mine_squared[i];
+        }
+    }
+
+    if (0 == sample_count) {
+        // nothing known: every closed field is a mine w/ the same probability
+        for (auto field : fields) {
+            frontier[field] = {density, 0, 1};
+        }
+        interior = {density, 0, 1};
+        return;
+    }
+
+    effective_sample_size = total.weight * total.weight / total.squared;
+    for (std::size_t i = 0; i < fields.size(); i++) {
+        frontier[fields[i]] = toEstimate(total.mine[i], total.mine_squared[i], total);
+    }
+    if (0 < interior_count) {
+        double p = total.interior / total.weight;
+        double variance = (total.interior_squared_twice - 2 * p * total.interior_squared + p * p * total.squared) / (total.weight * total.weight);
+        double half_width = 1.96 * std::sqrt(std::max(0.0, variance));
+        interior = {p, std::max(0.0, p - half_width), std::min(1.0, p + half_width)};
+    }
+}
+
+MonteCarloEstimator::Estimate MonteCarloEstimator::getEstimate(int x, int y) const {
+    auto found = frontier.find(frontierKey(x, y));
+    if (frontier.end() != found) {
+        return found->second;
+    }
+    if (open.empty() || open[static_cast<std::size_t>(y) * width + x]) {
+        return {0, 0, 0};
+    }
+    return interior;
+}
+
+MonteCarloEstimator::Estimate MonteCarloEstimator::getInteriorEstimate() const {
+    return interior;
+}
+
+std::int64_t MonteCarloEstimator::getSampleCount() const {
+    return sample_count;
+}
+
+std::int64_t MonteCarloEstimator::getRejectedCount() const {
+    return rejected_count;
+}
+
+double MonteCarloEstimator::getEffectiveSampleSize() const {
+    return effective_sample_size;
+}
@@ -0,0 +1,159 @@
+/// monte carlo estimator class definition
+/** \file
+ * Contains the class definition for the sampling mine probability estimator.
+ */
+#ifndef __MONTE_CARLO_HPP_INCLUDED__
+#define __MONTE_CARLO_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/// Estimates the mine probability of every closed field by sampling mine layouts
+/**
+ * Meant for frontiers too large for the ProbabilityEngine (see ProbabilityEngine::setStateLimit()).
+ * Uses the same visible state: open fields and their amount of sorrounding mines (flags are ignored).
+ *
+ * A sample assigns the frontier fields one after another, like the enumeration of the ProbabilityEngine:
+ * a field is only made a mine (or safe) if the open fields around it can still be satisfied,
+ * if both are possible it is a mine w/ the mine density of the closed fields.
+ * Every complete sample is consistent w/ all visible numbers, samples running into a dead end are rejected.
+ * As the choices are not uniform, every sample is weighted by binomial(interior, remaining mines) / probability of its choices (importance sampling),
+ * in log space, as these weights overflow any floating point type on larger boards.
+ *
+ * Sampling runs on several threads until the time budget or the sample limit is used up (or until cancelled, see setCancelCheck()).
+ * The confidence bounds are derived from the weighted variance, so they also widen if a few samples dominate the weights.
+ */
+class MonteCarloEstimator {
+    public:
+        /// probability of a field w/ its confidence bounds
+        struct Estimate {
+            /// estimated probability
+            double probability;
+            /// lower end of the ~95% confidence interval
+            double lower;
+            /// upper end of the ~95% confidence interval
+            double upper;
+        };
+
+        /**
+         * Creates a new estimator using one thread per core, a time budget of 100 ms and no sample limit.
+         */
+        MonteCarloEstimator();
+
+        /**
+         * Sets the amount of threads used for sampling.
+         * @param thread_count amount of threads, 0 for one per core
+         */
+        void setThreadCount(int thread_count);
+
+        /**
+         * Sets the time spent on sampling.
+         * @param ms time budget in ms, 0 for none (then a sample limit is required)
+         */
+        void setTimeBudget(double ms);
+
+        /**
+         * Sets the amount of samples (accepted or rejected) to draw at most.
+         * W/ a single thread and no time budget, the estimates only depend on the seed.
+         * @param sample_limit amount of samples, 0 for none
+         */
+        void setSampleLimit(std::int64_t sample_limit);
+
+        /**
+         * Sets the seed of the random generators, every thread derives its own from it.
+         * @param seed seed for the samples
+         */
+        void setSeed(std::int64_t seed);
+
+        /**
+         * Sets the check telling whether the estimates are still needed.
+         * It is called from all threads before every sample, and sampling stops as soon as it returns true.
+         * @param cancelled returns true to stop, must be thread-safe; empty for no check
+         */
+        void setCancelCheck(std::function<bool()> cancelled);
+
+        /**
+         * Samples the given minefield, replacing the previous results.
+         * If the game isn't running, every probability is 0.
+         * @param mfield minefield to examine, must be bounded
+         * @throws std::runtime_error if the minefield is unbounded, or if neither a time budget nor a sample limit is set
+         */
+        void estimate(const Minefield& mfield);
+
+        /**
+         * Returns the estimated probability of the given field being a mine.
+         * W/o accepted samples, the probability is the mine density of the closed fields, and the bounds are 0 and 1.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return estimate, all 0 for open fields
+         */
+        Estimate getEstimate(int x, int y) const;
+
+        /**
+         * Returns the estimate shared by all closed fields w/o open neighbours.
+         * @return estimate
+         */
+        Estimate getInteriorEstimate() const;
+
+        /**
+         * Returns the amount of samples consistent w/ all open fields.
+         * @return amount of accepted samples
+         */
+        std::int64_t getSampleCount() const;
+
+        /**
+         * Returns the amount of samples that ran into a dead end.
+         * @return amount of rejected samples
+         */
+        std::int64_t getRejectedCount() const;
+
+        /**
+         * Returns the effective sample size: the amount of equally weighted samples giving the same precision.
+         * @return (sum of weights)^2 / sum of squared weights
+         */
+        double getEffectiveSampleSize() const;
+
+    private:
+        /// amount of threads, 0 for one per core
+        int thread_count;
+
+        /// time budget in ms, 0 for none
+        double time_budget;
+
+        /// maximum amount of samples, 0 for none
+        std::int64_t sample_limit;
+
+        /// seed of the random generators
+        std::int64_t seed;
+
+        /// returns true if sampling should stop, may be empty
+        std::function<bool()> cancel_check;
+
+        /// estimates of the frontier fields, by packed coordinates
+        std::unordered_map<std::uint64_t, Estimate> frontier;
+
+        /// estimate of each interior field
+        Estimate interior;
+
+        /// open fields, used to tell them apart from interior fields
+        std::vector<bool> open;
+
+        /// width of the examined minefield
+        int width;
+
+        /// amount of accepted samples
+        std::int64_t sample_count;
+
+        /// amount of rejected samples
+        std::int64_t rejected_count;
+
+        /// effective sample size
+        double effective_sample_size;
+};
+
+#endif // __MONTE_CARLO_HPP_INCLUDED__
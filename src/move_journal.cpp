@@ -0,0 +1,155 @@
+/// move journal method bodies
+/** \file
+ * Contains the method bodies for the move journal.
+ */
+#include "move_journal.hpp"
+
+MoveJournal::MoveJournal() {
+    enabled = false;
+    recording = false;
+    applied = 0;
+}
+
+void MoveJournal::setEnabled(bool given_enabled) {
+    enabled = given_enabled;
+    recording = false;
+    entries.clear();
+    opened_runs.clear();
+    flag_runs.clear();
+    revealed_runs.clear();
+    applied = 0;
+}
+
+bool MoveJournal::isEnabled() const {
+    return enabled;
+}
+
+void MoveJournal::beginEntry(int x, int y) {
+    if (! enabled) {
+        return;
+    }
+
+    // recorded behind the undone moves, they are only discarded once the move turns out to change something
+    Entry entry;
+    entry.x = x;
+    entry.y = y;
+    entry.first_opened = opened_runs.size();
+    entry.end_opened = opened_runs.size();
+    entry.first_flag = flag_runs.size();
+    entry.end_flag = flag_runs.size();
+    entry.first_revealed = revealed_runs.size();
+    entry.end_revealed = revealed_runs.size();
+    entry.lost = false;
+    entry.relocated = false;
+    entry.mine_x = entry.mine_y = entry.relocated_x = entry.relocated_y = 0;
+    entries.push_back(entry);
+    recording = true;
+}
+
+void MoveJournal::endEntry() {
+    if (! recording) {
+        return;
+    }
+    recording = false;
+
+    Entry entry = entries.back();
+    entries.pop_back();
+    entry.end_opened = opened_runs.size();
+    entry.end_flag = flag_runs.size();
+    entry.end_revealed = revealed_runs.size();
+    if (entry.first_opened == entry.end_opened && entry.first_flag == entry.end_flag && ! entry.lost && ! entry.relocated) {
+        return;
+    }
+
+    // the move replaces the undone moves: their runs are removed, the runs of the move move up
+    if (applied < entries.size()) {
+        std::size_t first_opened = entries[applied].first_opened;
+        std::size_t first_flag = entries[applied].first_flag;
+        std::size_t first_revealed = entries[applied].first_revealed;
+        opened_runs.erase(opened_runs.begin() + first_opened, opened_runs.begin() + entry.first_opened);
+        flag_runs.erase(flag_runs.begin() + first_flag, flag_runs.begin() + entry.first_flag);
+        revealed_runs.erase(revealed_runs.begin() + first_revealed, revealed_runs.begin() + entry.first_revealed);
+        entry.end_opened -= entry.first_opened - first_opened;
+        entry.first_opened = first_opened;
+        entry.end_flag -= entry.first_flag - first_flag;
+        entry.first_flag = first_flag;
+        entry.end_revealed -= entry.first_revealed - first_revealed;
+        entry.first_revealed = first_revealed;
+        entries.resize(applied);
+    }
+    entries.push_back(entry);
+    applied = entries.size();
+}
+
+void MoveJournal::recordLost() {
+    if (recording) {
+        entries.back().lost = true;
+    }
+}
+
+void MoveJournal::recordRelocation(int mine_x, int mine_y, int relocated_x, int relocated_y) {
+    if (recording) {
+        Entry& entry = entries.back();
+        entry.relocated = true;
+        entry.mine_x = mine_x;
+        entry.mine_y = mine_y;
+        entry.relocated_x = relocated_x;
+        entry.relocated_y = relocated_y;
+    }
+}
+
+bool MoveJournal::canUndo() const {
+    return ! recording && 0 < applied;
+}
+
+bool MoveJournal::canRedo() const {
+    return ! recording && applied < entries.size();
+}
+
+const MoveJournal::Entry& MoveJournal::undo() {
+    applied--;
+    return entries[applied];
+}
+
+const MoveJournal::Entry& MoveJournal::redo() {
+    applied++;
+    return entries[applied - 1];
+}
+
+const JournalRun* MoveJournal::getOpenedRuns(const Entry& entry) const {
+    return opened_runs.data() + entry.first_opened;
+}
+
+const JournalRun* MoveJournal::getFlagRuns(const Entry& entry) const {
+    return flag_runs.data() + entry.first_flag;
+}
+
+const JournalRun* MoveJournal::getRevealedRuns(const Entry& entry) const {
+    return revealed_runs.data() + entry.first_revealed;
+}
+
+std::size_t MoveJournal::getEntryCount() const {
+    return entries.size();
+}
+
+std::size_t MoveJournal::getMemory() const {
+    return entries.size() * sizeof(Entry) + (opened_runs.size() + flag_runs.size() + revealed_runs.size()) * sizeof(JournalRun);
+}
+
+void MoveJournal::appendRun(std::vector<JournalRun>& runs, int x, int y, int length) {
+    // runs of previous entries are never extended
+    std::size_t first = entries.back().first_flag;
+    if (&runs == &opened_runs) {
+        first = entries.back().first_opened;
+    } else if (&runs == &revealed_runs) {
+        first = entries.back().first_revealed;
+    }
+    if (first < runs.size()) {
+        JournalRun& last = runs.back();
+        if (last.y == y && last.x + last.length == x) {
+            last.length += length;
+            return;
+        }
+    }
+    runs.push_back({x, y, length});
+}
@@ -0,0 +1,231 @@
+/// journal of the moves on a minefield
+/** \file
+ * Contains the journal used to undo and redo moves on a minefield.
+ * Moves are stored as the cells they changed (not as snapshots of the board),
+ * so the memory of a move is proportional to the amount of changed cells.
+ */
+#ifndef __MOVE_JOURNAL_HPP_INCLUDED__
+#define __MOVE_JOURNAL_HPP_INCLUDED__
+
+#include <cstddef>
+#include <vector>
+
+/// horizontal run of cells, all changed by the same move
+struct JournalRun {
+    /// x coordinate of the leftmost cell
+    int x;
+    /// y coordinate of all cells
+    int y;
+    /// amount of cells, >=1
+    int length;
+};
+
+/// Records the changes of moves, so they can be undone and redone
+/**
+ * Every move is an entry, referencing the runs of cells it opened and the runs of cells whose flag it placed or removed
+ * (and for a losing move, the runs of cells revealed by losing).
+ * A cascade opens rows of adjacent fields, so it is stored as a few runs instead of one record per cell.
+ * The runs of all entries are stored back to back in two lists, so recording doesn't allocate per move.
+ *
+ * The journal only stores what changed, applying it is done by the minefield.
+ * Undone entries are kept for redo until the next move that changes something is recorded.
+ */
+class MoveJournal {
+    public:
+        /// changes of a single move
+        struct Entry {
+            /// position of the move
+            int x, y;
+            /// index of the first run in the opened runs
+            std::size_t first_opened;
+            /// index behind the last run in the opened runs
+            std::size_t end_opened;
+            /// index of the first run in the flag runs
+            std::size_t first_flag;
+            /// index behind the last run in the flag runs
+            std::size_t end_flag;
+            /// index of the first run in the revealed runs
+            std::size_t first_revealed;
+            /// index behind the last run in the revealed runs
+            std::size_t end_revealed;
+            /// true if the move opened a mine
+            bool lost;
+            /// true if the first move moved a mine away
+            bool relocated;
+            /// original position of the moved mine
+            int mine_x, mine_y;
+            /// position the mine has been moved to
+            int relocated_x, relocated_y;
+        };
+
+        /**
+         * Creates a new, disabled journal.
+         */
+        MoveJournal();
+
+        /**
+         * Enables or disables recording. Disabling discards all entries.
+         * @param enabled true to record moves
+         */
+        void setEnabled(bool enabled);
+
+        /**
+         * Returns true if moves are recorded.
+         * @return true if enabled
+         */
+        bool isEnabled() const;
+
+        /**
+         * Starts recording a move, if enabled.
+         * @param x x coordinate of the move
+         * @param y y coordinate of the move
+         */
+        void beginEntry(int x, int y);
+
+        /**
+         * Finishes recording the current move.
+         * Moves that didn't change anything are dropped, so they can't be undone (and the undone entries can still be redone).
+         * Moves that are kept discard the entries that could be redone.
+         */
+        void endEntry();
+
+        /**
+         * Records opened cells of the current move, does nothing if not recording.
+         * Extends the last run if the cells continue it.
+         * @param x x coordinate of the leftmost cell
+         * @param y y coordinate
+         * @param length amount of cells
+         */
+        void recordOpened(int x, int y, int length) {
+            if (recording) {
+                appendRun(opened_runs, x, y, length);
+            }
+        }
+
+        /**
+         * Records a placed or removed flag of the current move, does nothing if not recording.
+         * @param x x coordinate
+         * @param y y coordinate
+         */
+        void recordFlagToggled(int x, int y) {
+            if (recording) {
+                appendRun(flag_runs, x, y, 1);
+            }
+        }
+
+        /**
+         * Records a cell revealed by losing the game in the current move, does nothing if not recording.
+         * Extends the last run if the cell continues it.
+         * @param x x coordinate
+         * @param y y coordinate
+         */
+        void recordRevealed(int x, int y) {
+            if (recording) {
+                appendRun(revealed_runs, x, y, 1);
+            }
+        }
+
+        /**
+         * Records that the current move opened a mine, does nothing if not recording.
+         */
+        void recordLost();
+
+        /**
+         * Records that the current move moved a mine, does nothing if not recording.
+         * @param mine_x x coordinate of the mine
+         * @param mine_y y coordinate of the mine
+         * @param relocated_x x coordinate the mine has been moved to
+         * @param relocated_y y coordinate the mine has been moved to
+         */
+        void recordRelocation(int mine_x, int mine_y, int relocated_x, int relocated_y);
+
+        /**
+         * Returns true if there is an entry to undo.
+         * @return true if undo() can be called
+         */
+        bool canUndo() const;
+
+        /**
+         * Returns true if there is an undone entry to redo.
+         * @return true if redo() can be called
+         */
+        bool canRedo() const;
+
+        /**
+         * Steps back by one entry. Only call if canUndo().
+         * @return the entry to revert
+         */
+        const Entry& undo();
+
+        /**
+         * Steps forward by one entry. Only call if canRedo().
+         * @return the entry to apply again
+         */
+        const Entry& redo();
+
+        /**
+         * Returns the first run opened by the given entry.
+         * @param entry entry of this journal
+         * @return pointer to entry.end_opened - entry.first_opened runs
+         */
+        const JournalRun* getOpenedRuns(const Entry& entry) const;
+
+        /**
+         * Returns the first run of flags placed or removed by the given entry.
+         * @param entry entry of this journal
+         * @return pointer to entry.end_flag - entry.first_flag runs
+         */
+        const JournalRun* getFlagRuns(const Entry& entry) const;
+
+        /**
+         * Returns the first run of cells revealed by losing in the given entry.
+         * @param entry entry of this journal
+         * @return pointer to entry.end_revealed - entry.first_revealed runs
+         */
+        const JournalRun* getRevealedRuns(const Entry& entry) const;
+
+        /**
+         * Returns the amount of stored entries, including the ones that can be redone.
+         * @return amount of entries
+         */
+        std::size_t getEntryCount() const;
+
+        /**
+         * Returns the amount of bytes used by the entries and runs (not the reserved capacity).
+         * @return used memory in bytes
+         */
+        std::size_t getMemory() const;
+
+    private:
+        /// true if moves are recorded
+        bool enabled;
+
+        /// true between beginEntry() and endEntry()
+        bool recording;
+
+        /// all entries, oldest first
+        std::vector<Entry> entries;
+
+        /// amount of entries that are applied (the others have been undone)
+        std::size_t applied;
+
+        /// opened runs of all entries
+        std::vector<JournalRun> opened_runs;
+
+        /// flag runs of all entries
+        std::vector<JournalRun> flag_runs;
+
+        /// revealed runs of all entries
+        std::vector<JournalRun> revealed_runs;
+
+        /**
+         * Appends a run to the given list, or extends the last run of the current entry if the cells continue it.
+         * @param runs list to append to
+         * @param x x coordinate of the leftmost cell
+         * @param y y coordinate
+         * @param length amount of cells
+         */
+        void appendRun(std::vector<JournalRun>& runs, int x, int y, int length);
+};
+
+#endif // __MOVE_JOURNAL_HPP_INCLUDED__
@@ -0,0 +1,57 @@
+/// neighbour count method bodies
+/** \file
+ * Contains the scalar kernel and the selection of the kernel at runtime.
+ */
+#include "neighbour_count.hpp"
+#include "neighbour_count_kernel.hpp"
+
+#include "config.h"
+
+#include <vector>
+
+#ifdef TerminateMines_AVX2_KERNEL
+/**
+ * AVX2 implementation of countNeighbourPlanes(), see neighbour_count_avx2.cpp.
+ * Only call if the cpu supports AVX2.
+ */
+void countNeighbourPlanesAvx2(const std::uint64_t* mask, std::size_t mask_stride, std::uint64_t* counts, std::size_t count_stride, int width, int height, std::uint64_t* buffers);
+#endif
+
+bool isNeighbourKernelAvailable(NeighbourKernel kernel) {
+    if (NeighbourKernel::avx2 == kernel) {
+#ifdef TerminateMines_AVX2_KERNEL
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+    return true;
+}
+
+NeighbourKernel getDefaultNeighbourKernel() {
+    return isNeighbourKernelAvailable(NeighbourKernel::avx2) ? NeighbourKernel::avx2 : NeighbourKernel::scalar;
+}
+
+void countNeighbourPlanes(const std::uint64_t* mask, std::size_t mask_stride, std::uint64_t* counts, std::size_t count_stride, int width, int height, NeighbourKernel kernel) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    // allocated here, the avx2 translation unit must not instantiate std::vector
+    std::vector<std::uint64_t> buffers(4 * static_cast<std::size_t>((width + 63) / 64 + 2), 0);
+
+#ifdef TerminateMines_AVX2_KERNEL
+    if (NeighbourKernel::avx2 == kernel && isNeighbourKernelAvailable(kernel)) {
+        countNeighbourPlanesAvx2(mask, mask_stride, counts, count_stride, width, height, buffers.data());
+        return;
+    }
+#endif
+
+    // vectors of one word: no vector loop
+    countPlanes<std::uint64_t, 1>(mask, mask_stride, counts, count_stride, width, height, buffers.data());
+}
+
+void countNeighbourWords(const std::uint64_t above[3], const std::uint64_t self[3], const std::uint64_t below[3], std::uint64_t counts[4]) {
+    countWords(above, self, below, counts);
+}
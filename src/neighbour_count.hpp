@@ -0,0 +1,61 @@
+/// neighbour counts of whole bit masks
+/** \file
+ * Contains the kernels that calculate the amount of set neighbours for every cell of a bit mask (a 3x3 box sum).
+ * Used for the mine counts of the minefield, but works on any mask (e.g. flags).
+ *
+ * Masks are stored like the planes of the minefield (see board_planes.hpp): rows of 64 bit words, bit (x % 64) belongs to column x.
+ * Each word may be followed by other words (stride), so the kernels can read from and write into the cells of a minefield directly.
+ */
+#ifndef __NEIGHBOUR_COUNT_HPP_INCLUDED__
+#define __NEIGHBOUR_COUNT_HPP_INCLUDED__
+
+#include <cstdint>
+#include <cstddef>
+
+/// implementations of countNeighbourPlanes()
+enum class NeighbourKernel {
+    /// one word at a time, available everywhere
+    scalar,
+    /// four words at a time, only on x86 cpus w/ AVX2
+    avx2
+};
+
+/**
+ * Returns true if the given kernel has been compiled in and is supported by the cpu.
+ * @param kernel kernel to check
+ * @return true if the kernel can be used
+ */
+bool isNeighbourKernelAvailable(NeighbourKernel kernel);
+
+/**
+ * Returns the fastest kernel available on this cpu (checked once at runtime).
+ * @return the kernel used by default
+ */
+NeighbourKernel getDefaultNeighbourKernel();
+
+/**
+ * Calculates the amount of set neighbours (0..8) for every cell of the given mask.
+ * The word of row y and word column w is at mask[(y * words_per_row + w) * mask_stride], words_per_row = (width + 63) / 64.
+ * The result is written bit-sliced: bit k of the amount is written to counts[(y * words_per_row + w) * count_stride + k], k = 0..3.
+ * Bits right of the board are ignored in the mask and cleared in the counts.
+ * @param mask first word of the mask
+ * @param mask_stride distance between two words of the mask
+ * @param counts first word of the counts, must not overlap w/ the mask words
+ * @param count_stride distance between the count words of two groups, at least 4
+ * @param width amount of columns
+ * @param height amount of rows
+ * @param kernel implementation to use, falls back to scalar if it isn't available
+ */
+void countNeighbourPlanes(const std::uint64_t* mask, std::size_t mask_stride, std::uint64_t* counts, std::size_t count_stride, int width, int height, NeighbourKernel kernel = getDefaultNeighbourKernel());
+
+/**
+ * Calculates the amount of set neighbours for the 64 cells of a single word, w/ the scalar kernel of countNeighbourPlanes().
+ * For callers that gather the words themselves (e.g. across chunk borders).
+ * @param above word to the left, the word itself and the word to the right, of the row above
+ * @param self word to the left, the word itself and the word to the right, of the row itself
+ * @param below word to the left, the word itself and the word to the right, of the row below
+ * @param counts receives the bit-sliced amounts, bit k of the amount of cell i is bit i of counts[k]
+ */
+void countNeighbourWords(const std::uint64_t above[3], const std::uint64_t self[3], const std::uint64_t below[3], std::uint64_t counts[4]);
+
+#endif // __NEIGHBOUR_COUNT_HPP_INCLUDED__
@@ -0,0 +1,14 @@
+/// AVX2 neighbour count kernel
+/** \file
+ * Contains the AVX2 implementation of countNeighbourPlanes().
+ * This file is compiled w/ -mavx2, so nothing in here may be called on cpus w/o AVX2 (see isNeighbourKernelAvailable()).
+ */
+#include "neighbour_count.hpp"
+#include "neighbour_count_kernel.hpp"
+
+/// four words, operators map to AVX2 instructions
+typedef std::uint64_t WordVector __attribute__((vector_size(32)));
+
+void countNeighbourPlanesAvx2(const std::uint64_t* mask, std::size_t mask_stride, std::uint64_t* counts, std::size_t count_stride, int width, int height, std::uint64_t* buffers) {
+    countPlanes<WordVector, 4>(mask, mask_stride, counts, count_stride, width, height, buffers);
+}
@@ -0,0 +1,155 @@
+/// row kernel shared by all implementations of countNeighbourPlanes()
+/** \file
+ * Internal header of neighbour_count.cpp and neighbour_count_avx2.cpp.
+ * The kernel is a template over the word type, so the same adder network is compiled for single words and for vectors of words.
+ * Everything has internal linkage: every translation unit gets its own copy, compiled w/ its own instruction set.
+ * For the same reason nothing in here may instantiate library templates (e.g. std::vector) that are also used elsewhere:
+ * the linker could pick the copy compiled for AVX2.
+ */
+#ifndef __NEIGHBOUR_COUNT_KERNEL_HPP_INCLUDED__
+#define __NEIGHBOUR_COUNT_KERNEL_HPP_INCLUDED__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+/**
+ * Adds up to three bit-sliced inputs (full adder).
+ * @param a first input
+ * @param b second input
+ * @param c third input
+ * @param sum receives the lower bit of a + b + c
+ * @param carry receives the upper bit of a + b + c
+ */
+template <typename W>
+inline void fullAdd(W a, W b, W c, W& sum, W& carry) {
+    W partial = a ^ b;
+    sum = partial ^ c;
+    carry = (a & b) | (partial & c);
+}
+
+/**
+ * Counts the 8 neighbours of all bits of the center words (carry-save adder tree).
+ * The left/right words are the words next to the center words, so bits can be shifted in across word borders.
+ * @param above left, center and right words of the row above
+ * @param self left, center and right words of the row itself
+ * @param below left, center and right words of the row below
+ * @param counts receives the bit-sliced amounts
+ */
+template <typename W>
+inline void countWords(const W above[3], const W self[3], const W below[3], W counts[4]) {
+    W west[3], east[3];
+    const W* rows[3] = {above, self, below};
+    for (int r = 0; r < 3; r++) {
+        west[r] = (rows[r][1] << 1) | (rows[r][0] >> 63);
+        east[r] = (rows[r][1] >> 1) | (rows[r][2] << 63);
+    }
+
+    W sum_above, carry_above, sum_below, carry_below;
+    fullAdd(west[0], above[1], east[0], sum_above, carry_above);
+    fullAdd(west[2], below[1], east[2], sum_below, carry_below);
+    W sum_self = west[1] ^ east[1];
+    W carry_self = west[1] & east[1];
+
+    // ones
+    W carry_ones;
+    fullAdd(sum_above, sum_below, sum_self, counts[0], carry_ones);
+
+    // twos: carry_above + carry_below + carry_self + carry_ones
+    W twos, carry_twos;
+    fullAdd(carry_above, carry_below, carry_self, twos, carry_twos);
+    counts[1] = twos ^ carry_ones;
+    W fours = twos & carry_ones;
+
+    // fours: carry_twos + fours
+    counts[2] = carry_twos ^ fours;
+    counts[3] = carry_twos & fours;
+}
+
+/**
+ * Runs the kernel over a whole mask, see countNeighbourPlanes().
+ * Every row is first copied into a contiguous buffer w/ one empty word on each side,
+ * then VECTOR_WORDS words are processed at once by the vector type V, the remaining words one by one.
+ * @param mask first word of the mask
+ * @param mask_stride distance between two words of the mask
+ * @param counts first word of the counts
+ * @param count_stride distance between the count words of two groups
+ * @param width amount of columns
+ * @param height amount of rows
+ * @param buffers scratch space of 4 * (words_per_row + 2) words, all 0
+ */
+template <typename V, int VECTOR_WORDS>
+void countPlanes(const std::uint64_t* mask, std::size_t mask_stride, std::uint64_t* counts, std::size_t count_stride, int width, int height, std::uint64_t* buffers) {
+    int words_per_row = (width + 63) / 64;
+    std::uint64_t last_word_mask = (0 == width % 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << (width % 64)) - 1;
+
+    // rows y-1, y and y+1 (rotated), buffer[i + 1] holds word i
+    std::size_t buffer_size = words_per_row + 2;
+    std::uint64_t* empty = &buffers[3 * buffer_size];
+    std::uint64_t* rows[3] = {&buffers[0], &buffers[buffer_size], &buffers[2 * buffer_size]};
+
+    auto load = [&](std::uint64_t* buffer, int y) {
+        for (int w = 0; w < words_per_row; w++) {
+            buffer[w + 1] = mask[(static_cast<std::size_t>(y) * words_per_row + w) * mask_stride];
+        }
+        buffer[words_per_row] &= last_word_mask;
+    };
+
+    if (0 < height) {
+        load(rows[1], 0);
+    }
+    for (int y = 0; y < height; y++) {
+        if (y + 1 < height) {
+            load(rows[2], y + 1);
+        }
+        const std::uint64_t* above = (0 < y) ? rows[0] : empty;
+        const std::uint64_t* self = rows[1];
+        const std::uint64_t* below = (y + 1 < height) ? rows[2] : empty;
+
+        std::uint64_t* out = &counts[static_cast<std::size_t>(y) * words_per_row * count_stride];
+        int w = 0;
+        for (; w + VECTOR_WORDS <= words_per_row; w += VECTOR_WORDS) {
+            V vectors[3][3];
+            for (int dx = 0; dx < 3; dx++) {
+                std::memcpy(&vectors[0][dx], &above[w + dx], sizeof(V));
+                std::memcpy(&vectors[1][dx], &self[w + dx], sizeof(V));
+                std::memcpy(&vectors[2][dx], &below[w + dx], sizeof(V));
+            }
+
+            V vector_counts[4];
+            countWords(vectors[0], vectors[1], vectors[2], vector_counts);
+
+            std::uint64_t words[4][VECTOR_WORDS];
+            std::memcpy(words, vector_counts, sizeof(words));
+            for (int i = 0; i < VECTOR_WORDS; i++) {
+                for (int k = 0; k < 4; k++) {
+                    out[(w + i) * count_stride + k] = words[k][i];
+                }
+            }
+        }
+        for (; w < words_per_row; w++) {
+            std::uint64_t word_counts[4];
+            countWords(&above[w], &self[w], &below[w], word_counts);
+            for (int k = 0; k < 4; k++) {
+                out[w * count_stride + k] = word_counts[k];
+            }
+        }
+
+        // cells right of the board would receive a count, keep the padding empty
+        for (int k = 0; k < 4; k++) {
+            out[(words_per_row - 1) * count_stride + k] &= last_word_mask;
+        }
+
+        // rotate: row y becomes the row above
+        std::uint64_t* oldest = rows[0];
+        rows[0] = rows[1];
+        rows[1] = rows[2];
+        rows[2] = oldest;
+    }
+}
+
+}
+
+#endif // __NEIGHBOUR_COUNT_KERNEL_HPP_INCLUDED__
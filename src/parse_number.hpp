@@ -0,0 +1,43 @@
+/// parsing of numeric command line arguments
+/** \file
+ * Contains the number parsing shared by the argp parsers of tmines and tmines-sim.
+ */
+#ifndef __PARSE_NUMBER_HPP_INCLUDED__
+#define __PARSE_NUMBER_HPP_INCLUDED__
+
+#include <argp.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Returns true if the given string contains nothing but the digits 0-9 (also true if empty).
+ * @param s string to check
+ * @return true if there is no other character
+ */
+inline bool has_only_digits(const std::string& s) {
+    return s.find_first_not_of("0123456789") == std::string::npos;
+}
+
+/**
+ * Parses a non-negative number, fails if the argument is no number or larger than the given maximum.
+ * @param arg the argument to parse
+ * @param max largest allowed value
+ * @param state argp state, for error reporting
+ * @return the parsed number
+ */
+inline std::int64_t parse_number(const char* arg, std::int64_t max, struct argp_state* state) {
+    if ('\0' == arg[0] || ! has_only_digits(arg)) {
+        argp_failure(state, 1, 0, "Argument must be number");
+    }
+
+    errno = 0;
+    long long value = std::strtoll(arg, nullptr, 10);
+    if (ERANGE == errno || value > max) {
+        argp_failure(state, 1, 0, "Argument must not be larger than %lld", static_cast<long long>(max));
+    }
+    return value;
+}
+
+#endif // __PARSE_NUMBER_HPP_INCLUDED__
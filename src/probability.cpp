@@ -0,0 +1,564 @@
+/// probability engine method bodies
+/** \file
+ * Contains the method bodies for the exact mine probability engine.
+ */
+#include "probability.hpp"
+
+#include "frontier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/// amounts of solutions per amount of mines: values[i] belongs to offset + i mines
+struct MineCounts {
+    /// amount of mines of values[0]
+    int offset;
+    /// relative amounts, only their ratios are meaningful
+    std::vector<double> values;
+};
+
+/// part of the frontier, and the results of its enumeration
+struct Component : public FrontierComponent {
+    /// levels[i][state]: mines among the fields before field i, per partial assignment
+    std::vector<std::vector<MineCounts>> levels;
+    /// next[i][state][mine]: state on level i + 1 after assigning field i, -1 if impossible
+    std::vector<std::vector<std::array<int, 2>>> next;
+    /// solutions of the entire component, per amount of mines
+    MineCounts solutions;
+    /// weight of the rest of the board, per amount of mines of this component
+    std::vector<double> rest;
+    /// mine probability per field
+    std::vector<double> probabilities;
+
+    /// amount of states on all levels
+    std::size_t state_count = 0;
+    /// time spent enumerating
+    double ms = 0;
+};
+
+/**
+ * Divides all values by their maximum, so repeated products neither overflow nor underflow.
+ * @param values values to scale, unchanged if all are 0
+ */
+static void normalize(std::vector<double>& values) {
+    double max = 0;
+    for (double value : values) {
+        max = std::max(max, value);
+    }
+    if (0 < max) {
+        for (double& value : values) {
+            value /= max;
+        }
+    }
+}
+
+/**
+ * Adds counts, shifted by the given amount of mines and multiplied by a factor, to the target.
+ * @param target counts to add to, extended as needed
+ * @param source counts to add
+ * @param shift amount of mines added to the source
+ * @param factor multiplier for the source
+ */
+static void addCounts(MineCounts& target, const MineCounts& source, int shift, double factor) {
+    int first = source.offset + shift;
+    int end = first + static_cast<int>(source.values.size());
+    if (target.values.empty()) {
+        target.offset = first;
+    }
+    if (first < target.offset) {
+        target.values.insert(target.values.begin(), target.offset - first, 0.0);
+        target.offset = first;
+    }
+    if (target.offset + static_cast<int>(target.values.size()) < end) {
+        target.values.resize(end - target.offset, 0.0);
+    }
+    for (std::size_t i = 0; i < source.values.size(); i++) {
+        target.values[first - target.offset + i] += factor * source.values[i];
+    }
+}
+
+/**
+ * Returns counts[mines], 0 if out of range.
+ * @param counts counts to read
+ * @param mines amount of mines
+ * @return value for the given amount of mines
+ */
+static double getCount(const MineCounts& counts, int mines) {
+    int index = mines - counts.offset;
+    if (index < 0 || static_cast<int>(counts.values.size()) <= index) {
+        return 0;
+    }
+    return counts.values[index];
+}
+
+/**
+ * Counts the solutions of a component, keeping every level for calculateProbabilities().
+ *
+ * The state before field i holds the remaining mines of the open fields w/ assigned and unassigned fields,
+ * everything else about the assignment of the previous fields doesn't matter for the rest.
+ * Every amount is multiplied by tilt^mines, which keeps the counts of large components w/in range of a double.
+ * @param component component w/ fields and constraints, receives levels, next and solutions
+ * @param tilt weight of a single mine
+ * @param state_limit maximum amount of states per level, 0 for none
+ * @param cancelled checked before every level, stops counting once it returns true
+ * @return false if the state limit has been exceeded or counting has been cancelled, the results are incomplete then
+ */
+static bool countSolutions(Component& component, double tilt, std::size_t state_limit, const std::function<bool()>& cancelled) {
+    int field_count = static_cast<int>(component.fields.size());
+    int constraint_count = static_cast<int>(component.constraint_fields.size());
+
+    // first and last field of every open field, open fields per field
+    std::vector<int> first(constraint_count, field_count), last(constraint_count, -1);
+    std::vector<std::vector<int>> touching(field_count);
+    for (int c = 0; c < constraint_count; c++) {
+        for (int field : component.constraint_fields[c]) {
+            first[c] = std::min(first[c], field);
+            last[c] = std::max(last[c], field);
+            touching[field].push_back(c);
+        }
+    }
+
+    // amount of fields of the open field after the given one
+    auto fieldsAfter = [&](int c, int field) {
+        int after = 0;
+        for (int other : component.constraint_fields[c]) {
+            if (field < other) {
+                after++;
+            }
+        }
+        return after;
+    };
+
+    component.levels.assign(field_count + 1, std::vector<MineCounts>());
+    component.next.assign(field_count, std::vector<std::array<int, 2>>());
+    component.levels[0].push_back({0, {1.0}});
+    component.state_count = 1;
+
+    // remaining mines of the open fields in active, per state of the current level
+    std::vector<std::string> states(1);
+    std::vector<int> active;
+    std::vector<int> position(constraint_count, -1);
+    std::vector<int> touched_at(constraint_count, -1);
+    std::vector<int> remaining(constraint_count);
+    for (int i = 0; i < field_count; i++) {
+        if (cancelled()) {
+            return false;
+        }
+
+        std::vector<int> next_active;
+        for (int c : active) {
+            if (i < last[c]) {
+                next_active.push_back(c);
+            }
+        }
+        for (int c : touching[i]) {
+            touched_at[c] = i;
+            if (first[c] == i && i < last[c]) {
+                next_active.push_back(c);
+            }
+        }
+        for (std::size_t p = 0; p < active.size(); p++) {
+            position[active[p]] = static_cast<int>(p);
+        }
+
+        std::vector<int> after(touching[i].size());
+        for (std::size_t t = 0; t < touching[i].size(); t++) {
+            after[t] = fieldsAfter(touching[i][t], i);
+        }
+
+        std::unordered_map<std::string, int> next_indices;
+        std::vector<std::string> next_states;
+        const std::vector<MineCounts>& current = component.levels[i];
+        std::vector<MineCounts>& following = component.levels[i + 1];
+        for (std::size_t s = 0; s < current.size(); s++) {
+            std::array<int, 2> targets = {{-1, -1}};
+            for (int mine = 0; mine < 2; mine++) {
+                // the open fields of this field must still be satisfiable by the fields after it
+                bool valid = true;
+                for (std::size_t t = 0; t < touching[i].size() && valid; t++) {
+                    int c = touching[i][t];
+                    remaining[c] = ((first[c] == i) ? component.constraint_mines[c] : states[s][position[c]]) - mine;
+                    valid = 0 <= remaining[c] && remaining[c] <= after[t];
+                }
+                if (! valid) {
+                    continue;
+                }
+
+                std::string next_state(next_active.size(), 0);
+                for (std::size_t q = 0; q < next_active.size(); q++) {
+                    int c = next_active[q];
+                    next_state[q] = static_cast<char>((touched_at[c] == i) ? remaining[c] : states[s][position[c]]);
+                }
+
+                auto inserted = next_indices.emplace(next_state, static_cast<int>(next_states.size()));
+                if (inserted.second) {
+                    next_states.push_back(next_state);
+                    following.push_back({0, {}});
+                }
+                targets[mine] = inserted.first->second;
+                addCounts(following[targets[mine]], current[s], mine, (0 == mine) ? 1.0 : tilt);
+            }
+            component.next[i].push_back(targets);
+        }
+
+        // a common factor per level doesn't change any ratio
+        double max = 0;
+        for (auto& counts : following) {
+            for (double value : counts.values) {
+                max = std::max(max, value);
+            }
+        }
+        for (auto& counts : following) {
+            for (double& value : counts.values) {
+                value /= max;
+            }
+        }
+
+        component.state_count += following.size();
+        if (0 != state_limit && state_limit < following.size()) {
+            return false;
+        }
+        states.swap(next_states);
+        active.swap(next_active);
+        if (following.empty()) {
+            break;
+        }
+    }
+
+    component.solutions = {0, {}};
+    if (! component.levels[field_count].empty()) {
+        component.solutions = component.levels[field_count][0];
+    }
+    return true;
+}
+
+/**
+ * Calculates the mine probability of every field of a component, given the weight of the rest of the board.
+ * Walks the levels of countSolutions() backwards, collecting the weight of all completions of every state.
+ * @param component component w/ counted solutions and rest, receives probabilities
+ * @param tilt weight of a single mine, the same as for countSolutions()
+ * @param cancelled checked before every level, stops once it returns true
+ * @return false if cancelled, the probabilities are incomplete then
+ */
+static bool calculateProbabilities(Component& component, double tilt, const std::function<bool()>& cancelled) {
+    int field_count = static_cast<int>(component.fields.size());
+    component.probabilities.assign(field_count, 0.0);
+
+    // completions[state]: weight of all completions, per amount of mines before the level
+    std::vector<MineCounts> completions(1, {component.solutions.offset, component.rest});
+    for (int i = field_count - 1; 0 <= i; i--) {
+        if (cancelled()) {
+            return false;
+        }
+
+        const std::vector<MineCounts>& current = component.levels[i];
+        std::vector<MineCounts> previous(current.size());
+        double weights[2] = {0, 0};
+        double max = 0;
+        for (std::size_t s = 0; s < current.size(); s++) {
+            previous[s].offset = current[s].offset;
+            previous[s].values.assign(current[s].values.size(), 0.0);
+            for (int mine = 0; mine < 2; mine++) {
+                int target = component.next[i][s][mine];
+                if (target < 0) {
+                    continue;
+                }
+                double factor = (0 == mine) ? 1.0 : tilt;
+                for (std::size_t j = 0; j < current[s].values.size(); j++) {
+                    double completion = factor * getCount(completions[target], current[s].offset + static_cast<int>(j) + mine);
+                    previous[s].values[j] += completion;
+                    weights[mine] += current[s].values[j] * completion;
+                }
+            }
+            for (double value : previous[s].values) {
+                max = std::max(max, value);
+            }
+        }
+
+        if (0 < weights[0] + weights[1]) {
+            component.probabilities[i] = weights[1] / (weights[0] + weights[1]);
+        }
+        if (0 < max) {
+            for (auto& counts : previous) {
+                for (double& value : counts.values) {
+                    value /= max;
+                }
+            }
+        }
+        completions.swap(previous);
+    }
+    return true;
+}
+
+/**
+ * Combines the solutions of all components w/ the interior, setting the rest of every component.
+ *
+ * rest(k) of a component is the weight of everything else when the component holds k mines:
+ * the sum over the amounts of mines of the other components of their solutions, times binomial(interior_count, mine_count - frontier mines).
+ * It is collected w/ prefix sums over the components before and suffix sums over the components after the component.
+ * @param components components w/ counted solutions
+ * @param interior_count amount of closed fields w/o open neighbours
+ * @param mine_count amount of mines on the board
+ * @param tilt weight of a single mine, the same as for countSolutions()
+ * @return expected amount of mines in the interior
+ */
+static double combine(std::vector<Component>& components, std::int64_t interior_count, std::int64_t mine_count, double tilt) {
+    // only the amounts of frontier mines between the sum of the minimums and the sum of the maximums are possible,
+    // reach[c] is the spread of the components before c
+    std::int64_t base = 0;
+    std::vector<int> reach(components.size() + 1, 0);
+    for (std::size_t c = 0; c < components.size(); c++) {
+        base += components[c].solutions.offset;
+        reach[c + 1] = reach[c] + static_cast<int>(components[c].solutions.values.size()) - 1;
+    }
+    int spread = reach[components.size()];
+
+    // weight of the interior per amount of frontier mines (above base), in log space, w/o the tilt of the frontier mines
+    std::vector<double> logs(spread + 1);
+    double max_log = -std::numeric_limits<double>::infinity();
+    for (int mines = 0; mines <= spread; mines++) {
+        logs[mines] = logBinomial(interior_count, mine_count - base - mines) - mines * std::log(tilt);
+        max_log = std::max(max_log, logs[mines]);
+    }
+    if (std::isinf(max_log)) {
+        throw std::runtime_error("The open fields require more or less mines than there are.");
+    }
+    std::vector<double> interior(spread + 1);
+    for (int mines = 0; mines <= spread; mines++) {
+        interior[mines] = std::exp(logs[mines] - max_log);
+    }
+
+    // suffixes[c][mines]: weight of the components after c and the interior, given the mines before them
+    std::vector<std::vector<double>> suffixes(components.size());
+    std::vector<double> suffix = interior;
+    for (std::size_t c = components.size(); 0 < c; c--) {
+        const std::vector<double>& values = components[c - 1].solutions.values;
+        std::vector<double> extended(reach[c - 1] + 1, 0.0);
+        for (int mines = 0; mines <= reach[c - 1]; mines++) {
+            for (std::size_t k = 0; k < values.size(); k++) {
+                extended[mines] += values[k] * suffix[mines + k];
+            }
+        }
+        normalize(extended);
+        suffixes[c - 1].swap(suffix);
+        suffix.swap(extended);
+    }
+
+    // prefix[mines]: weight of the components before c
+    std::vector<double> prefix(1, 1.0);
+    for (std::size_t c = 0; c < components.size(); c++) {
+        Component& component = components[c];
+        const std::vector<double>& values = component.solutions.values;
+        component.rest.assign(values.size(), 0.0);
+        for (std::size_t k = 0; k < values.size(); k++) {
+            for (int mines = 0; mines <= reach[c]; mines++) {
+                component.rest[k] += prefix[mines] * suffixes[c][mines + k];
+            }
+        }
+        normalize(component.rest);
+        suffixes[c].clear();
+        suffixes[c].shrink_to_fit();
+
+        std::vector<double> extended(reach[c + 1] + 1, 0.0);
+        for (int mines = 0; mines <= reach[c]; mines++) {
+            for (std::size_t k = 0; k < values.size(); k++) {
+                extended[mines + k] += prefix[mines] * values[k];
+            }
+        }
+        normalize(extended);
+        prefix.swap(extended);
+    }
+
+    // prefix now covers the entire frontier
+    double total = 0, interior_mines = 0;
+    for (int mines = 0; mines <= spread; mines++) {
+        double weight = prefix[mines] * interior[mines];
+        total += weight;
+        interior_mines += weight * static_cast<double>(mine_count - base - mines);
+    }
+    if (0 == total) {
+        throw std::runtime_error("The open fields require more or less mines than there are.");
+    }
+    return interior_mines / total;
+}
+
+/**
+ * Runs fn(index) for every index in [0, count) on the given amount of threads, the calling thread is one of them.
+ * Indices are handed out one by one, so a slow index doesn't hold back the others.
+ * @param count amount of indices
+ * @param thread_count amount of threads, 0 for one per core
+ * @param fn function to run
+ */
+static void runParallel(std::size_t count, int thread_count, const std::function<void(std::size_t)>& fn) {
+    if (thread_count <= 0) {
+        thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    thread_count = static_cast<int>(std::min(static_cast<std::size_t>(thread_count), count));
+
+    std::atomic<std::size_t> next_index(0);
+    auto work = [&]() {
+        for (std::size_t index = next_index++; index < count; index = next_index++) {
+            fn(index);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < thread_count; thread++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+ProbabilityEngine::ProbabilityEngine() {
+    thread_count = 0;
+    state_limit = 0;
+    cancel_check = nullptr;
+    interior_probability = 0;
+    interior_count = 0;
+    width = 0;
+}
+
+void ProbabilityEngine::setThreadCount(int given_thread_count) {
+    thread_count = given_thread_count;
+}
+
+void ProbabilityEngine::setStateLimit(std::size_t given_state_limit) {
+    state_limit = given_state_limit;
+}
+
+void ProbabilityEngine::setCancelCheck(std::function<bool()> cancelled) {
+    cancel_check = cancelled;
+}
+
+bool ProbabilityEngine::calculate(const Minefield& mfield) {
+    if (mfield.isUnbounded()) {
+        throw std::runtime_error("Probabilities can only be calculated for bounded minefields.");
+    }
+
+    frontier.clear();
+    component_stats.clear();
+    interior_probability = 0;
+    interior_count = 0;
+    width = mfield.getXDimension();
+    open.assign(static_cast<std::size_t>(width) * mfield.getYDimension(), false);
+    if (! mfield.isGameRunning()) {
+        return true;
+    }
+
+    Frontier visible = readFrontier(mfield);
+    std::vector<Component> components(visible.components.size());
+    for (std::size_t c = 0; c < components.size(); c++) {
+        static_cast<FrontierComponent&>(components[c]) = visible.components[c];
+    }
+    std::int64_t closed_count = visible.closed_count;
+    interior_count = visible.interior_count;
+    open.swap(visible.open);
+
+    // every mine is weighted by the odds of a closed field being one, so the counts stay balanced
+    double density = static_cast<double>(mfield.getMineCount()) / static_cast<double>(closed_count);
+    density = std::min(std::max(density, 1e-6), 1 - 1e-6);
+    double tilt = density / (1 - density);
+
+    // once a component exceeded the limit (or the calculation has been cancelled), the remaining ones are skipped
+    std::atomic<bool> exceeded(false);
+    std::function<bool()> cancelled = [this, &exceeded]() {
+        return exceeded || (cancel_check && cancel_check());
+    };
+    runParallel(components.size(), thread_count, [&](std::size_t c) {
+        if (cancelled()) {
+            exceeded = true;
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (! countSolutions(components[c], tilt, state_limit, cancelled)) {
+            exceeded = true;
+        }
+        components[c].ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    });
+    auto stop = [&]() {
+        // keep the measurements, they tell which component was too large
+        for (auto& component : components) {
+            component_stats.push_back({static_cast<int>(component.fields.size()), static_cast<int>(component.constraint_fields.size()), component.state_count, component.ms});
+        }
+        interior_probability = 0;
+        interior_count = 0;
+        open.assign(open.size(), false);
+        return false;
+    };
+    if (exceeded) {
+        return stop();
+    }
+    for (auto& component : components) {
+        if (component.solutions.values.empty()) {
+            throw std::runtime_error("The open fields contradict each other.");
+        }
+    }
+
+    double interior_mines = combine(components, interior_count, mfield.getMineCount(), tilt);
+    if (0 < interior_count) {
+        interior_probability = interior_mines / static_cast<double>(interior_count);
+    }
+
+    runParallel(components.size(), thread_count, [&](std::size_t c) {
+        auto start = std::chrono::steady_clock::now();
+        if (cancelled() || ! calculateProbabilities(components[c], tilt, cancelled)) {
+            exceeded = true;
+        }
+        // the levels are only needed for the probabilities
+        components[c].levels.clear();
+        components[c].next.clear();
+        components[c].ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    });
+    if (exceeded) {
+        return stop();
+    }
+
+    for (auto& component : components) {
+        for (std::size_t i = 0; i < component.fields.size(); i++) {
+            frontier[component.fields[i]] = component.probabilities[i];
+        }
+        component_stats.push_back({static_cast<int>(component.fields.size()), static_cast<int>(component.constraint_fields.size()), component.state_count, component.ms});
+    }
+    return true;
+}
+
+double ProbabilityEngine::getProbability(int x, int y) const {
+    auto found = frontier.find(frontierKey(x, y));
+    if (frontier.end() != found) {
+        return found->second;
+    }
+    if (open.empty() || open[static_cast<std::size_t>(y) * width + x]) {
+        return 0;
+    }
+    return interior_probability;
+}
+
+double ProbabilityEngine::getInteriorProbability() const {
+    return interior_probability;
+}
+
+std::int64_t ProbabilityEngine::getInteriorCount() const {
+    return interior_count;
+}
+
+void ProbabilityEngine::getFrontier(std::vector<std::tuple<int, int>>& into) const {
+    into.clear();
+    for (auto& field : frontier) {
+        into.push_back(frontierCoordinates(field.first));
+    }
+}
+
+const std::vector<ProbabilityEngine::ComponentStats>& ProbabilityEngine::getComponentStats() const {
+    return component_stats;
+}
@@ -0,0 +1,145 @@
+/// probability engine class definition
+/** \file
+ * Contains the class definition for the exact mine probability engine.
+ */
+#ifndef __PROBABILITY_HPP_INCLUDED__
+#define __PROBABILITY_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+/// Calculates the exact mine probability of every closed field
+/**
+ * Like the solver, only what the player sees is used: open fields and their amount of sorrounding mines (flags are ignored).
+ *
+ * Closed fields next to open fields form the frontier, all other closed fields are the interior.
+ * The frontier is split into components: fields are in the same component if an open field sees both of them (transitively).
+ * Components don't influence each other, except through the total amount of mines.
+ *
+ * Every component is enumerated on its own: its fields are assigned one after another (in breadth first order),
+ * and partial assignments that leave the same remaining mines for the open fields still being filled are merged (memoized),
+ * counting the solutions per amount of mines.
+ * The components are then combined w/ the interior: a solution w/ K frontier mines leaves binomial(interior, mines - K) interior layouts.
+ * These weights are calculated in log space, as they overflow any floating point type on larger boards.
+ *
+ * Components are independent, so they are enumerated in parallel. The time spent on each component is kept for inspection.
+ *
+ * The amount of partial assignments grows exponentially w/ the width of a component, see setStateLimit() to bound the time spent.
+ * The MonteCarloEstimator can estimate the probabilities of components that exceed it.
+ * Calculations whose result isn't needed anymore can be stopped early, see setCancelCheck().
+ */
+class ProbabilityEngine {
+    public:
+        /// measurements of a single component
+        struct ComponentStats {
+            /// amount of closed fields in the component
+            int field_count;
+            /// amount of open fields constraining the component
+            int constraint_count;
+            /// amount of memoized partial assignments, summed over all fields
+            std::size_t state_count;
+            /// time spent enumerating the component, in ms
+            double ms;
+        };
+
+        /**
+         * Creates a new engine using one thread per core, w/o any results.
+         */
+        ProbabilityEngine();
+
+        /**
+         * Sets the amount of threads used to enumerate the components.
+         * @param thread_count amount of threads, 0 for one per core
+         */
+        void setThreadCount(int thread_count);
+
+        /**
+         * Limits the amount of partial assignments kept per field of a component.
+         * @param state_limit maximum amount of states, 0 for none
+         */
+        void setStateLimit(std::size_t state_limit);
+
+        /**
+         * Sets the check telling whether the calculation is still needed.
+         * It is called from all threads, once per field of a component, and the calculation stops as soon as it returns true.
+         * @param cancelled returns true to stop, must be thread-safe; empty for no check
+         */
+        void setCancelCheck(std::function<bool()> cancelled);
+
+        /**
+         * Calculates the probabilities for the given minefield, replacing the previous results.
+         * If the game isn't running, every probability is 0.
+         * @param mfield minefield to examine, must be bounded
+         * @return false if a component exceeded the state limit or the calculation has been cancelled: there are no probabilities then, only the component stats
+         * @throws std::runtime_error if the minefield is unbounded, or if the open fields contradict each other
+         */
+        bool calculate(const Minefield& mfield);
+
+        /**
+         * Returns the probability of the given field being a mine.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return probability in [0, 1], 0 for open fields
+         */
+        double getProbability(int x, int y) const;
+
+        /**
+         * Returns the mine probability shared by all closed fields w/o open neighbours.
+         * @return probability in [0, 1]
+         */
+        double getInteriorProbability() const;
+
+        /**
+         * Returns the amount of closed fields w/o open neighbours.
+         * @return amount of interior fields
+         */
+        std::int64_t getInteriorCount() const;
+
+        /**
+         * Retrieves the closed fields w/ open neighbours.
+         * @param into receives the (x, y) coordinates of the fields, in no particular order
+         */
+        void getFrontier(std::vector<std::tuple<int, int>>& into) const;
+
+        /**
+         * Returns the measurements of the components of the last calculation, largest component first.
+         * @return one entry per component
+         */
+        const std::vector<ComponentStats>& getComponentStats() const;
+
+    private:
+        /// amount of threads, 0 for one per core
+        int thread_count;
+
+        /// maximum amount of states per field, 0 for none
+        std::size_t state_limit;
+
+        /// returns true if the calculation should stop, may be empty
+        std::function<bool()> cancel_check;
+
+        /// probabilities of the frontier fields, by packed coordinates
+        std::unordered_map<std::uint64_t, double> frontier;
+
+        /// probability of each interior field
+        double interior_probability;
+
+        /// amount of interior fields
+        std::int64_t interior_count;
+
+        /// open fields, used to tell them apart from interior fields
+        std::vector<bool> open;
+
+        /// width of the examined minefield
+        int width;
+
+        /// measurements of the last calculation
+        std::vector<ComponentStats> component_stats;
+};
+
+#endif // __PROBABILITY_HPP_INCLUDED__
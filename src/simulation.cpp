@@ -0,0 +1,248 @@
+/// simulation method bodies
+/** \file
+ * Contains the method bodies for playing many games w/ a bot, and the work stealing scheduler spreading them over the threads.
+ */
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+const std::int64_t Simulation::BATCH_SIZE = 16;
+
+/// games [first, first + count) of one configuration
+struct Batch {
+    /// index of the configuration
+    std::size_t config;
+    /// number of the first game
+    std::int64_t first;
+    /// amount of games
+    std::int64_t count;
+};
+
+/// batches of one thread
+struct BatchQueue {
+    /// guards batches, taken by the owner and by thieves
+    std::mutex mutex;
+    /// the owner takes from the back, thieves from the front
+    std::deque<Batch> batches;
+};
+
+/**
+ * Takes the next batch for the given thread: its own newest one, otherwise the oldest one of another thread.
+ * No batches are added while running, so once all queues are empty, everything is done.
+ * @param queues one queue per thread
+ * @param own index of the queue of the calling thread
+ * @param into receives the batch
+ * @return false if there is nothing left to do
+ */
+static bool takeBatch(std::vector<BatchQueue>& queues, std::size_t own, Batch& into) {
+    {
+        std::lock_guard<std::mutex> lock(queues[own].mutex);
+        if (! queues[own].batches.empty()) {
+            into = queues[own].batches.back();
+            queues[own].batches.pop_back();
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < queues.size(); i++) {
+        BatchQueue& victim = queues[(own + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (! victim.batches.empty()) {
+            into = victim.batches.front();
+            victim.batches.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Keeps the first (smallest) game numbers of the given list.
+ * @param losses numbers of lost games, in any order
+ * @param loss_limit amount of numbers to keep
+ */
+static void keepFirstLosses(std::vector<std::int64_t>& losses, std::size_t loss_limit) {
+    std::sort(losses.begin(), losses.end());
+    if (loss_limit < losses.size()) {
+        losses.resize(loss_limit);
+    }
+}
+
+Simulation::Simulation() : bot_name("solver"), thread_count(0), seed(0), game_count(1000), loss_limit(0), elapsed_ms(0) {
+}
+
+void Simulation::setBot(const std::string& name) {
+    // fails for unknown names
+    Bot::create(name);
+    bot_name = name;
+}
+
+void Simulation::setThreadCount(int thread_count) {
+    this->thread_count = thread_count;
+}
+
+void Simulation::setSeed(std::int64_t seed) {
+    this->seed = seed;
+}
+
+void Simulation::setGameCount(std::int64_t game_count) {
+    this->game_count = game_count;
+}
+
+void Simulation::setLossLimit(std::size_t loss_limit) {
+    this->loss_limit = loss_limit;
+}
+
+const std::vector<Simulation::Stats>& Simulation::getStats() const {
+    return stats;
+}
+
+double Simulation::getElapsedMs() const {
+    return elapsed_ms;
+}
+
+std::int64_t Simulation::getSeed(std::int64_t game) const {
+    return seed + game;
+}
+
+Simulation::GameResult Simulation::playGame(Bot& bot, const Config& config, std::int64_t seed) {
+    Minefield mfield(config.width, config.height, config.mine_count, seed);
+    mfield.setChangeTrackingEnabled(true);
+    GameResult result{false, 0, 0};
+    bot.startGame(mfield, seed);
+
+    // the first move of a player in tmines, as the cursor starts in the center
+    mfield.open((config.width - 1) / 2, (config.height - 1) / 2);
+    result.moves++;
+
+    std::vector<std::tuple<int, int>> changed;
+    std::vector<Bot::Move> moves;
+    while (mfield.isGameRunning()) {
+        mfield.drainChangedCells(changed);
+        moves.clear();
+        bot.nextMoves(mfield, changed, moves);
+        if (moves.empty()) {
+            throw std::runtime_error("The bot has no move left.");
+        }
+
+        for (auto& move : moves) {
+            if (! mfield.isGameRunning()) {
+                break;
+            }
+            if (mfield.isOpen(move.x, move.y)) {
+                // opened recursively by a previous move
+                continue;
+            }
+            mfield.open(move.x, move.y);
+            result.moves++;
+            result.guesses += move.guess ? 1 : 0;
+        }
+    }
+
+    result.won = mfield.isGameWon();
+    return result;
+}
+
+void Simulation::run(const std::vector<Config>& configs) {
+    for (auto& config : configs) {
+        if (config.width <= 0 || config.height <= 0 || config.mine_count < 0 || static_cast<std::int64_t>(config.width) * config.height <= config.mine_count) {
+            throw std::runtime_error("Invalid configuration: " + std::to_string(config.width) + "x" + std::to_string(config.height) + " w/ " + std::to_string(config.mine_count) + " mines.");
+        }
+    }
+
+    if (0 < game_count && std::numeric_limits<std::int64_t>::max() - (game_count - 1) < seed) {
+        throw std::runtime_error("The seeds of the games exceed the range of the seed.");
+    }
+
+    int threads = thread_count;
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // batches are dealt in turns, so every thread starts w/ a share of every configuration
+    std::vector<BatchQueue> queues(threads);
+    std::size_t next_queue = 0;
+    for (std::size_t config = 0; config < configs.size(); config++) {
+        for (std::int64_t first = 0; first < game_count; first += BATCH_SIZE) {
+            queues[next_queue].batches.push_back(Batch{config, first, std::min(BATCH_SIZE, game_count - first)});
+            next_queue = (next_queue + 1) % queues.size();
+        }
+    }
+
+    // every thread collects its own statistics, summed up afterwards (so the result doesn't depend on who played which game)
+    std::vector<std::vector<Stats>> thread_stats(threads, std::vector<Stats>(configs.size(), Stats{0, 0, 0, 0, 0, 0, {}}));
+    std::atomic<bool> failed(false);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto work = [&](int index) {
+        try {
+            std::unique_ptr<Bot> bot = Bot::create(bot_name);
+            Batch batch;
+            while (! failed && takeBatch(queues, index, batch)) {
+                auto start = std::chrono::steady_clock::now();
+                Stats& own = thread_stats[index][batch.config];
+                for (std::int64_t game = batch.first; game < batch.first + batch.count; game++) {
+                    GameResult result = playGame(*bot, configs[batch.config], getSeed(game));
+                    own.games++;
+                    own.wins += result.won ? 1 : 0;
+                    own.moves += result.moves;
+                    own.guesses += result.guesses;
+                    own.wins_without_guess += (result.won && 0 == result.guesses) ? 1 : 0;
+                    if (! result.won && 0 < loss_limit) {
+                        own.losses.push_back(game);
+                        if (2 * loss_limit <= own.losses.size()) {
+                            keepFirstLosses(own.losses, loss_limit);
+                        }
+                    }
+                }
+                own.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+        } catch (std::exception&) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (! error) {
+                error = std::current_exception();
+            }
+            failed = true;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(work, i));
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    stats.assign(configs.size(), Stats{0, 0, 0, 0, 0, 0, {}});
+    for (auto& own : thread_stats) {
+        for (std::size_t config = 0; config < configs.size(); config++) {
+            stats[config].games += own[config].games;
+            stats[config].wins += own[config].wins;
+            stats[config].moves += own[config].moves;
+            stats[config].guesses += own[config].guesses;
+            stats[config].wins_without_guess += own[config].wins_without_guess;
+            stats[config].ms += own[config].ms;
+            stats[config].losses.insert(stats[config].losses.end(), own[config].losses.begin(), own[config].losses.end());
+        }
+    }
+    for (auto& config_stats : stats) {
+        keepFirstLosses(config_stats.losses, loss_limit);
+    }
+}
@@ -0,0 +1,162 @@
+/// simulation class definition
+/** \file
+ * Contains the class definition for playing many games w/ a bot, spread over all cores.
+ */
+#ifndef __SIMULATION_HPP_INCLUDED__
+#define __SIMULATION_HPP_INCLUDED__
+
+#include "bot.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Plays many games w/ a bot and collects statistics per board configuration
+/**
+ * Games are numbered per configuration, game i is played on Minefield(width, height, mine_count, seed + i):
+ * the same board tmines creates w/ `tmines -w width -h height -c mine_count -s seed+i`, where the cursor starts on the field the bot opens first.
+ * As the bots are deterministic, every game can be replayed that way, and the statistics don't depend on the amount of threads.
+ *
+ * The games are split into batches, and the batches are dealt to the threads in turns.
+ * Games vary a lot in length (especially across configurations), so a thread running out of batches steals from the others (work stealing):
+ * owners take their newest batch, thieves the oldest one.
+ */
+class Simulation {
+    public:
+        /// board the games are played on
+        struct Config {
+            /// width of the minefield
+            int width;
+            /// height of the minefield
+            int height;
+            /// amount of mines
+            std::int64_t mine_count;
+        };
+
+        /// outcome of a single game
+        struct GameResult {
+            /// true if the game has been won
+            bool won;
+            /// amount of fields opened (by the bot, not the ones opened recursively)
+            std::int64_t moves;
+            /// amount of moves the bot didn't know to be safe
+            std::int64_t guesses;
+        };
+
+        /// statistics of all games of one configuration
+        struct Stats {
+            /// amount of games played
+            std::int64_t games;
+            /// amount of games won
+            std::int64_t wins;
+            /// amount of moves, summed over all games
+            std::int64_t moves;
+            /// amount of guesses, summed over all games
+            std::int64_t guesses;
+            /// amount of games won w/o a single guess
+            std::int64_t wins_without_guess;
+            /// time spent playing, summed over all threads, in ms
+            double ms;
+            /// numbers of the first lost games (see setLossLimit()), ascending
+            std::vector<std::int64_t> losses;
+        };
+
+        /// amount of games per batch, the unit of work stealing
+        static const std::int64_t BATCH_SIZE;
+
+        /**
+         * Creates a new simulation w/ the solver bot, seed 0, 1000 games per configuration and one thread per core.
+         */
+        Simulation();
+
+        /**
+         * Sets the bot playing the games.
+         * @param name name of the bot, see Bot::getNames()
+         * @throws std::runtime_error if there is no bot w/ the given name
+         */
+        void setBot(const std::string& name);
+
+        /**
+         * Sets the amount of threads playing the games.
+         * @param thread_count amount of threads, 0 for one per core
+         */
+        void setThreadCount(int thread_count);
+
+        /**
+         * Sets the seed of the first game of every configuration.
+         * @param seed seed of game 0, game i uses seed + i
+         */
+        void setSeed(std::int64_t seed);
+
+        /**
+         * Sets the amount of games per configuration.
+         * @param game_count amount of games
+         */
+        void setGameCount(std::int64_t game_count);
+
+        /**
+         * Sets how many lost games are remembered per configuration (the first ones), to be replayed.
+         * @param loss_limit amount of lost games, 0 for none
+         */
+        void setLossLimit(std::size_t loss_limit);
+
+        /**
+         * Plays all games, replacing the previous statistics.
+         * @param configs boards to play on
+         * @throws std::runtime_error if a configuration is invalid (no field left for the first move), or if the seeds overflow
+         */
+        void run(const std::vector<Config>& configs);
+
+        /**
+         * Returns the statistics of the last run.
+         * @return statistics, in the order of the configurations
+         */
+        const std::vector<Stats>& getStats() const;
+
+        /**
+         * Returns the wall clock time of the last run.
+         * @return time in ms
+         */
+        double getElapsedMs() const;
+
+        /**
+         * Returns the seed of a game.
+         * @param game number of the game in its configuration
+         * @return seed to create the minefield w/
+         */
+        std::int64_t getSeed(std::int64_t game) const;
+
+        /**
+         * Plays a single game: opens the center field (where the cursor of tmines starts), then makes the moves of the bot until the game ends.
+         * @param bot the bot choosing the moves
+         * @param config board to play on
+         * @param seed seed of the minefield
+         * @return the outcome
+         * @throws std::runtime_error if the bot returns no move
+         */
+        static GameResult playGame(Bot& bot, const Config& config, std::int64_t seed);
+
+    private:
+        /// name of the bot
+        std::string bot_name;
+
+        /// amount of threads, 0 for one per core
+        int thread_count;
+
+        /// seed of game 0
+        std::int64_t seed;
+
+        /// amount of games per configuration
+        std::int64_t game_count;
+
+        /// amount of lost games remembered per configuration
+        std::size_t loss_limit;
+
+        /// statistics of the last run
+        std::vector<Stats> stats;
+
+        /// wall clock time of the last run in ms
+        double elapsed_ms;
+};
+
+#endif // __SIMULATION_HPP_INCLUDED__
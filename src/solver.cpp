@@ -0,0 +1,218 @@
+/// solver method bodies
+/** \file
+ * Contains the method bodies for the deterministic solver.
+ */
+#include "solver.hpp"
+
+/**
+ * Returns true if the given key is one of the given keys.
+ * @param fields keys to search
+ * @param count amount of keys
+ * @param field key to search for
+ * @return true if found
+ */
+static bool contains(const std::uint64_t* fields, int count, std::uint64_t field) {
+    for (int i = 0; i < count; i++) {
+        if (fields[i] == field) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Solver::Solver() {
+}
+
+std::uint64_t Solver::key(int x, int y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+}
+
+std::tuple<int, int> Solver::coordinates(std::uint64_t field) {
+    return std::make_tuple(static_cast<int>(static_cast<std::uint32_t>(field >> 32)), static_cast<int>(static_cast<std::uint32_t>(field)));
+}
+
+void Solver::reset(const Minefield& mfield) {
+    safe_fields.clear();
+    mines.clear();
+    pending.clear();
+    queued.clear();
+
+    for (int x = 0; x < mfield.getXDimension(); x++) {
+        for (int y = 0; y < mfield.getYDimension(); y++) {
+            if (mfield.isOpen(x, y)) {
+                queued.insert(key(x, y));
+                pending.push_back(key(x, y));
+            }
+        }
+    }
+    process(mfield);
+}
+
+void Solver::update(const Minefield& mfield, const std::vector<std::tuple<int, int>>& changed) {
+    // everything undone: the first move may move a mine again, so nothing is known
+    if (0 == mfield.getOpenCount()) {
+        safe_fields.clear();
+        mines.clear();
+        return;
+    }
+
+    for (auto& field : changed) {
+        int x, y;
+        std::tie(x, y) = field;
+        if (mfield.isOpen(x, y)) {
+            safe_fields.erase(key(x, y));
+        }
+        // (changed flags don't change any constraint, but are cheap to look at)
+        queueAround(mfield, x, y);
+    }
+    process(mfield);
+}
+
+void Solver::getSafeFields(std::vector<std::tuple<int, int>>& into) const {
+    into.clear();
+    for (auto field : safe_fields) {
+        into.push_back(coordinates(field));
+    }
+}
+
+void Solver::getMines(std::vector<std::tuple<int, int>>& into) const {
+    into.clear();
+    for (auto field : mines) {
+        into.push_back(coordinates(field));
+    }
+}
+
+bool Solver::isSafe(int x, int y) const {
+    return safe_fields.end() != safe_fields.find(key(x, y));
+}
+
+bool Solver::isMine(int x, int y) const {
+    return mines.end() != mines.find(key(x, y));
+}
+
+void Solver::queueAround(const Minefield& mfield, int x, int y) {
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            int current_x = x + dx;
+            int current_y = y + dy;
+            if (mfield.isPosValid(current_x, current_y) && mfield.isOpen(current_x, current_y) && queued.insert(key(current_x, current_y)).second) {
+                pending.push_back(key(current_x, current_y));
+            }
+        }
+    }
+}
+
+Solver::Constraint Solver::getConstraint(const Minefield& mfield, int x, int y) const {
+    Constraint constraint;
+    constraint.unknown_count = 0;
+    constraint.remaining = mfield.getSorroundingMineCount(x, y);
+
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            int current_x = x + dx;
+            int current_y = y + dy;
+            if ((0 == dx && 0 == dy) || ! mfield.isPosValid(current_x, current_y) || mfield.isOpen(current_x, current_y)) {
+                continue;
+            }
+
+            std::uint64_t field = key(current_x, current_y);
+            if (isMine(current_x, current_y)) {
+                constraint.remaining--;
+            } else if (! isSafe(current_x, current_y)) {
+                constraint.unknown[constraint.unknown_count++] = field;
+            }
+        }
+    }
+    return constraint;
+}
+
+void Solver::examine(const Minefield& mfield, int x, int y) {
+    Constraint constraint = getConstraint(mfield, x, y);
+    if (0 == constraint.unknown_count) {
+        return;
+    }
+
+    // single field
+    std::vector<std::uint64_t> unknown(constraint.unknown, constraint.unknown + constraint.unknown_count);
+    if (0 == constraint.remaining) {
+        deduce(mfield, unknown, false);
+        return;
+    }
+    if (constraint.unknown_count == constraint.remaining) {
+        deduce(mfield, unknown, true);
+        return;
+    }
+
+    // subset: only fields w/in distance 2 can share closed neighbours
+    for (int dx = -2; dx <= 2; dx++) {
+        for (int dy = -2; dy <= 2; dy++) {
+            int other_x = x + dx;
+            int other_y = y + dy;
+            if ((0 == dx && 0 == dy) || ! mfield.isPosValid(other_x, other_y) || ! mfield.isOpen(other_x, other_y)) {
+                continue;
+            }
+
+            Constraint other = getConstraint(mfield, other_x, other_y);
+            if (0 == other.unknown_count) {
+                continue;
+            }
+
+            // check both directions: this field inside the other one, and the other one inside this field
+            for (int direction = 0; direction < 2; direction++) {
+                const Constraint& inner = (0 == direction) ? constraint : other;
+                const Constraint& outer = (0 == direction) ? other : constraint;
+
+                bool subset = inner.unknown_count < outer.unknown_count;
+                for (int i = 0; i < inner.unknown_count && subset; i++) {
+                    subset = contains(outer.unknown, outer.unknown_count, inner.unknown[i]);
+                }
+                if (! subset) {
+                    continue;
+                }
+
+                std::vector<std::uint64_t> difference;
+                for (int i = 0; i < outer.unknown_count; i++) {
+                    if (! contains(inner.unknown, inner.unknown_count, outer.unknown[i])) {
+                        difference.push_back(outer.unknown[i]);
+                    }
+                }
+
+                // the difference may not touch this field: examine it again later for the other pairs
+                int difference_mines = outer.remaining - inner.remaining;
+                if (0 == difference_mines || static_cast<int>(difference.size()) == difference_mines) {
+                    deduce(mfield, difference, 0 != difference_mines);
+                    if (queued.insert(key(x, y)).second) {
+                        pending.push_back(key(x, y));
+                    }
+                    return;
+                }
+            }
+        }
+    }
+}
+
+void Solver::deduce(const Minefield& mfield, const std::vector<std::uint64_t>& fields, bool mine) {
+    for (auto field : fields) {
+        if (mine) {
+            mines.insert(field);
+        } else {
+            safe_fields.insert(field);
+        }
+
+        int x, y;
+        std::tie(x, y) = coordinates(field);
+        queueAround(mfield, x, y);
+    }
+}
+
+void Solver::process(const Minefield& mfield) {
+    while (! pending.empty()) {
+        std::uint64_t field = pending.back();
+        pending.pop_back();
+        queued.erase(field);
+
+        int x, y;
+        std::tie(x, y) = coordinates(field);
+        examine(mfield, x, y);
+    }
+}
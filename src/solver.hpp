@@ -0,0 +1,159 @@
+/// solver class definition
+/** \file
+ * Contains the class definition for the deterministic solver.
+ */
+#ifndef __SOLVER_HPP_INCLUDED__
+#define __SOLVER_HPP_INCLUDED__
+
+#include "minefield.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+/// Finds the fields that are provably safe or provably mines
+/**
+ * Only uses what the player sees: open fields and their amount of sorrounding mines.
+ * Flags are ignored, as they may be wrong; the mines found by the solver are used instead.
+ *
+ * Every open field w/ closed neighbours is a constraint: its closed neighbours contain exactly its remaining mines.
+ * Two rules are applied:
+ *  - single field: no remaining mines -> all closed neighbours are safe; as many remaining mines as closed neighbours -> all are mines
+ *  - subset: if the closed neighbours of a field are a subset of the ones of a nearby field, the difference holds the difference of the remaining mines
+ *
+ * Deductions are facts about the mine layout, so they stay valid for the rest of the game (also after undo).
+ * The solver works incrementally: only the open fields around changed fields (and around new deductions) are examined again,
+ * so a move costs time proportional to the fields it changed, not to the size of the board.
+ */
+class Solver {
+    public:
+        /**
+         * Creates a new solver that knows nothing.
+         */
+        Solver();
+
+        /**
+         * Forgets everything and examines all open fields of the given minefield.
+         * Looks at the whole board, prefer update() during a game.
+         * @param mfield minefield to examine, must be bounded
+         */
+        void reset(const Minefield& mfield);
+
+        /**
+         * Examines the open fields around the given changed fields, and everything affected by new deductions.
+         * Pass every field changed since the last update (e.g. the fields from Minefield::drainChangedCells()).
+         * If no field is open (anymore), everything is forgotten.
+         * @param mfield minefield to examine, the same as on the previous calls
+         * @param changed fields changed since the last call
+         */
+        void update(const Minefield& mfield, const std::vector<std::tuple<int, int>>& changed);
+
+        /**
+         * Retrieves the fields that are provably safe, but not open yet.
+         * @param into receives the (x, y) coordinates of the fields, in no particular order
+         */
+        void getSafeFields(std::vector<std::tuple<int, int>>& into) const;
+
+        /**
+         * Retrieves the fields that are provably mines.
+         * @param into receives the (x, y) coordinates of the fields, in no particular order
+         */
+        void getMines(std::vector<std::tuple<int, int>>& into) const;
+
+        /**
+         * Returns true if the given field is known to be safe and not open yet.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return true if provably safe
+         */
+        bool isSafe(int x, int y) const;
+
+        /**
+         * Returns true if the given field is known to be a mine.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return true if provably a mine
+         */
+        bool isMine(int x, int y) const;
+
+    private:
+        /// closed neighbours of an open field, and how many mines are among them
+        struct Constraint {
+            /// closed fields w/ unknown content, as keys
+            std::uint64_t unknown[8];
+            /// amount of fields in unknown
+            int unknown_count;
+            /// amount of mines among unknown
+            int remaining;
+        };
+
+        /// closed fields known to be safe
+        std::unordered_set<std::uint64_t> safe_fields;
+
+        /// fields known to be mines
+        std::unordered_set<std::uint64_t> mines;
+
+        /// open fields to examine
+        std::vector<std::uint64_t> pending;
+
+        /// fields in pending (so every field is queued once)
+        std::unordered_set<std::uint64_t> queued;
+
+        /**
+         * Packs coordinates into a single key.
+         * @param x x coordinate
+         * @param y y coordinate
+         * @return key of the field
+         */
+        static std::uint64_t key(int x, int y);
+
+        /**
+         * Unpacks a key.
+         * @param field key of the field
+         * @return (x, y) coordinates of the field
+         */
+        static std::tuple<int, int> coordinates(std::uint64_t field);
+
+        /**
+         * Queues the open fields around a field (and the field itself) for examination, as their constraints changed.
+         * The fields sharing closed neighbours w/ them are looked at while examining them (subset rule), so they don't have to be queued.
+         * @param mfield examined minefield
+         * @param x x coordinate
+         * @param y y coordinate
+         */
+        void queueAround(const Minefield& mfield, int x, int y);
+
+        /**
+         * Calculates the constraint of an open field.
+         * @param mfield examined minefield
+         * @param x x coordinate of an open field
+         * @param y y coordinate of an open field
+         * @return closed neighbours w/ unknown content and the amount of mines among them
+         */
+        Constraint getConstraint(const Minefield& mfield, int x, int y) const;
+
+        /**
+         * Applies the rules to an open field, stores the deductions and queues the fields affected by them.
+         * @param mfield examined minefield
+         * @param x x coordinate of an open field
+         * @param y y coordinate of an open field
+         */
+        void examine(const Minefield& mfield, int x, int y);
+
+        /**
+         * Stores that the given fields are safe or mines, and queues the fields around them.
+         * @param mfield examined minefield
+         * @param fields keys of the fields
+         * @param mine true for mines, false for safe fields
+         */
+        void deduce(const Minefield& mfield, const std::vector<std::uint64_t>& fields, bool mine);
+
+        /**
+         * Examines queued fields until there is nothing left to deduce.
+         * @param mfield examined minefield
+         */
+        void process(const Minefield& mfield);
+};
+
+#endif // __SOLVER_HPP_INCLUDED__
@@ -2,6 +2,7 @@
 #include "config.h"
 #include "iodevice.hpp"
 #include "iodevice_curses.cpp"
+#include "parse_number.hpp"
 
 #define INCBIN_PREFIX
 #include "incbin/incbin.h"
@@ -18,26 +19,28 @@ INCBIN(authors, PROJECT_SOURCE_DIR "/AUTHORS.md");
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
+#include <cstdint>
+#include <limits>
 
 const char* argp_program_bug_address = TerminateMines_BUG_ADDRESS;
+/// amount of chunks kept in memory on unbounded minefields, everything farther away is moved to disk (about 20MB)
+const std::size_t UNBOUNDED_CHUNK_LIMIT = 4096;
+
 const char* argp_program_version = "version " TerminateMines_VERSION_MAJOR "." TerminateMines_VERSION_MINOR " (commit " TerminateMines_GIT_COMMIT_HASH ")";
 
 struct {
     int width = -1;
     int height = -1;
-    int mine_count = -1;
-    int seed = -1;
+    std::int64_t mine_count = -1;
+    std::int64_t seed = -1;
     int mine_density = -1;
     bool autodiscover_only = false;
     bool fullscreen = false;
+    bool unbounded = false;
     bool display_license = false;
     bool display_authors = false;
 } opts;
 
-bool has_only_digits(const std::string s){
-  return s.find_first_not_of( "0123456789" ) == std::string::npos;
-}
-
 static int parse_opt(int key, char* arg, struct argp_state* state) {
     // check for incompatibilities
     if ((-1 != opts.height || -1 != opts.width) && opts.fullscreen) {
@@ -48,31 +51,23 @@ static int parse_opt(int key, char* arg, struct argp_state* state) {
         argp_error(state, "can't specify mine count explicitly and set mine density at the same time");
     }
 
+    if ((-1 != opts.height || -1 != opts.width || opts.fullscreen || -1 != opts.mine_count) && opts.unbounded) {
+        argp_error(state, "unbounded minefields have no size and mine count, use mine density instead");
+    }
+
     switch (key) {
         case 'x':
         case 'w':
-            if (has_only_digits(arg)) {
-                opts.width = std::atoi(arg);
-            } else {
-                argp_failure(state, 1, 0, "Argument must be number");
-            }
+            opts.width = parse_number(arg, std::numeric_limits<int>::max(), state);
             break;
         
         case 'y':
         case 'h':
-            if (has_only_digits(arg)) {
-                opts.height = std::atoi(arg);
-            } else {
-                argp_failure(state, 1, 0, "Argument must be number");
-            }
+            opts.height = parse_number(arg, std::numeric_limits<int>::max(), state);
             break;
 
         case 'c':
-            if (has_only_digits(arg)) {
-                opts.mine_count = std::atoi(arg);
-            } else {
-                argp_failure(state, 1, 0, "Argument must be number");
-            }
+            opts.mine_count = parse_number(arg, std::numeric_limits<std::int64_t>::max(), state);
             break;
 
         case 'd':
@@ -87,17 +82,17 @@ static int parse_opt(int key, char* arg, struct argp_state* state) {
             break;
 
         case 's':
-            if (has_only_digits(arg)) {
-                opts.seed = std::atoi(arg);
-            } else {
-                argp_failure(state, 1, 0, "Argument must be number");
-            }
+            opts.seed = parse_number(arg, std::numeric_limits<std::int64_t>::max(), state);
             break;
 
         case 'f':
             opts.fullscreen = true;
             break;
 
+        case 'u':
+            opts.unbounded = true;
+            break;
+
         case 'a':
             opts.autodiscover_only = true;
             break;
@@ -109,12 +104,19 @@ static int parse_opt(int key, char* arg, struct argp_state* state) {
         case 1338:
             opts.display_authors = true;
             break;
+
+        case ARGP_KEY_END:
+            // (the options may come in any order, so this is checked once all are known)
+            if (opts.unbounded && -1 != opts.mine_density && (Minefield::MIN_UNBOUNDED_DENSITY > opts.mine_density || opts.mine_density > 99)) {
+                argp_error(state, "mine density of unbounded minefields must be between %d and 99 (percent)", Minefield::MIN_UNBOUNDED_DENSITY);
+            }
+            break;
     }
 
     return 0;
 }
 
-int get_minecount_for_size(int width = -1, int height = -1) {
+std::int64_t get_minecount_for_size(int width = -1, int height = -1) {
     if (-1 == width) {
         width = opts.width;
     }
@@ -129,21 +131,24 @@ int get_minecount_for_size(int width = -1, int height = -1) {
     if (-1 != opts.mine_count) {
         return opts.mine_count;
     } else {
-        return (width * height * opts.mine_density) / 100;
+        return (static_cast<std::int64_t>(width) * height * opts.mine_density) / 100;
     }
 }
 
 void run() {
-    // seed not initialized? get one from hardware
+    // seed not initialized? get one from hardware (63 bits, so it stays positive)
     if (-1 == opts.seed) {
-        opts.seed = std::abs((int) std::random_device()());
+        std::random_device random_device;
+        std::uint64_t bits = (static_cast<std::uint64_t>(random_device()) << 32) | random_device();
+        opts.seed = static_cast<std::int64_t>(bits >> 1);
     }
 
-    if (-1 == opts.height) {
+    // unbounded minefields have neither size nor mine count
+    if (-1 == opts.height && ! opts.unbounded) {
         opts.height = 10;
     }
 
-    if (-1 == opts.width) {
+    if (-1 == opts.width && ! opts.unbounded) {
         opts.width = 10;
     }
 
@@ -160,7 +165,7 @@ void run() {
         }
     }
 
-    if (-1 == opts.mine_count) {
+    if (-1 == opts.mine_count && ! opts.unbounded) {
         opts.mine_count = get_minecount_for_size(opts.width, opts.height);
     }
 
@@ -174,8 +179,18 @@ void run() {
             std::string authors_string(authorsData, authorsData + authorsSize);
             std::cout << authors_string << std::endl;
         }
+    } else if (opts.unbounded) {
+        if (-1 == opts.mine_density) {
+            opts.mine_density = 16;
+        }
+
+        Minefield mfield = Minefield::createUnbounded(opts.mine_density, opts.seed);
+        mfield.setChunkLimit(UNBOUNDED_CHUNK_LIMIT);
+
+        std::shared_ptr<IODevice> iodevice_ptr = std::make_shared<IODeviceCurses>();
+        Display(iodevice_ptr, Controller(mfield, opts.autodiscover_only));
     } else {
-        std::shared_ptr<IODevice> iodevice_ptr = std::make_shared<IODeviceCurses>(IODeviceCurses());
+        std::shared_ptr<IODevice> iodevice_ptr = std::make_shared<IODeviceCurses>();
         Display(iodevice_ptr, opts.width, opts.height, opts.mine_count, opts.seed, opts.autodiscover_only);
     }
 }
@@ -188,7 +203,8 @@ int main(int argc, char** argv) {
         {"height", 'h', "HEIGHT", 0, "height of the minefield, default: 10", 10},
         {0, 'y', 0, OPTION_ALIAS, 0, 10},
         {"fullscreen", 'f', 0, 0, "use full screen size", 10},
-        {0, 0, 0, OPTION_DOC, "note: use either fullscreen or specify size explicitly (not both)", 10},
+        {"unbounded", 'u', 0, 0, "play on a minefield w/o borders, generated while exploring it", 10},
+        {0, 0, 0, OPTION_DOC, "note: use either fullscreen, unbounded or specify size explicitly (only one)", 10},
 
         {0, 0, 0, 0, "Mines", 20},
         {"mine-count", 'c', "NUM", 0, "number of mines to be placed", 20},
@@ -206,7 +222,7 @@ int main(int argc, char** argv) {
 
         {0, 0, 0, 0, 0, 0}
     };
-    struct argp argp = {options, parse_opt, 0, "Play Minesweeper on the terminal.\vControls:\nMovement    WASD, Arrow Keys, vimlike (HJKL)\nFlag Mine   F\nOpen Field  Space\nQuit        Q", 0, 0, 0};
+    struct argp argp = {options, parse_opt, 0, "Play Minesweeper on the terminal.\vControls:\nMovement    WASD, Arrow Keys, vimlike (HJKL)\nFlag Mine   F\nOpen Field  Space\nUndo        U\nRedo        Y\nHint        ?\nQuit        Q", 0, 0, 0};
 
     int argp_state = argp_parse(&argp, argc, argv, 0, 0, 0);
 
@@ -224,6 +240,7 @@ int main(int argc, char** argv) {
         err_report += "Settings:\n";
         err_report += "  Width, Height:     " + std::to_string(opts.width) + ", " + std::to_string(opts.height) + "\n";
         err_report += "  Mine Count:        " + std::to_string(opts.mine_count) + "\n";
+        err_report += "  Mine Density:      " + std::to_string(opts.mine_density) + "\n";
         err_report += "  Seed:              " + std::to_string(opts.seed) + "\n";
         err_report += "  Autodiscover only: ";
         if (opts.autodiscover_only) {
@@ -237,6 +254,12 @@ int main(int argc, char** argv) {
         } else {
             err_report += "disabled\n";
         }
+        err_report += "  Unbounded:         ";
+        if (opts.unbounded) {
+            err_report += "enabled\n";
+        } else {
+            err_report += "disabled\n";
+        }
         err_report += "  Args:             ";
         for (int i = 1; i < argc; i++) {
             err_report += " " + std::string(argv[i]);
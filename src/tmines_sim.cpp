@@ -0,0 +1,189 @@
+/// headless simulation runner
+/** \file
+ * Plays many games w/ a bot on every core and prints win rate, moves per second and guesses per board configuration.
+ * Every game can be replayed in tmines, see the printed commands.
+ */
+#include "config.h"
+#include "parse_number.hpp"
+#include "simulation.hpp"
+
+#include <argp.h>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+const char* argp_program_bug_address = TerminateMines_BUG_ADDRESS;
+
+const char* argp_program_version = "version " TerminateMines_VERSION_MAJOR "." TerminateMines_VERSION_MINOR " (commit " TerminateMines_GIT_COMMIT_HASH ")";
+
+struct {
+    std::vector<std::tuple<int, int>> sizes;
+    std::vector<int> mine_densities;
+    std::int64_t game_count = 1000;
+    std::int64_t seed = 0;
+    int thread_count = 0;
+    std::string bot = "solver";
+    std::int64_t loss_limit = 0;
+} opts;
+
+static int parse_opt(int key, char* arg, struct argp_state* state) {
+    switch (key) {
+        case 'z': {
+            std::string size = arg;
+            std::size_t separator = size.find('x');
+            if (std::string::npos == separator) {
+                argp_failure(state, 1, 0, "size must be given as WIDTHxHEIGHT, e.g. 30x16");
+            }
+            int width = parse_number(size.substr(0, separator).c_str(), std::numeric_limits<int>::max(), state);
+            int height = parse_number(size.substr(separator + 1).c_str(), std::numeric_limits<int>::max(), state);
+            opts.sizes.push_back(std::make_tuple(width, height));
+            break;
+        }
+
+        case 'd':
+            opts.mine_densities.push_back(parse_number(arg, 100, state));
+            break;
+
+        case 'n':
+            opts.game_count = parse_number(arg, std::numeric_limits<std::int64_t>::max(), state);
+            if (0 == opts.game_count) {
+                argp_failure(state, 1, 0, "at least one game must be played");
+            }
+            break;
+
+        case 's':
+            opts.seed = parse_number(arg, std::numeric_limits<std::int64_t>::max(), state);
+            break;
+
+        case 't':
+            opts.thread_count = parse_number(arg, std::numeric_limits<int>::max(), state);
+            break;
+
+        case 'b':
+            opts.bot = arg;
+            break;
+
+        case 'l':
+            opts.loss_limit = parse_number(arg, std::numeric_limits<int>::max(), state);
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * Formats a ratio as percentage.
+ * @param part numerator
+ * @param total denominator
+ * @return percentage w/ one decimal
+ */
+std::string percent(double part, double total) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << (0 < total ? 100 * part / total : 0) << "%";
+    return out.str();
+}
+
+void run() {
+    if (opts.sizes.empty()) {
+        opts.sizes = {std::make_tuple(9, 9), std::make_tuple(16, 16), std::make_tuple(30, 16)};
+    }
+    if (opts.mine_densities.empty()) {
+        opts.mine_densities = {12, 16, 20};
+    }
+
+    // mine counts like tmines calculates them from the density
+    std::vector<Simulation::Config> configs;
+    for (auto& size : opts.sizes) {
+        for (int density : opts.mine_densities) {
+            int width, height;
+            std::tie(width, height) = size;
+            configs.push_back(Simulation::Config{width, height, (static_cast<std::int64_t>(width) * height * density) / 100});
+        }
+    }
+
+    Simulation simulation;
+    simulation.setBot(opts.bot);
+    simulation.setThreadCount(opts.thread_count);
+    simulation.setSeed(opts.seed);
+    simulation.setGameCount(opts.game_count);
+    simulation.setLossLimit(opts.loss_limit);
+    simulation.run(configs);
+
+    std::cout << "bot: " << opts.bot << ", " << opts.game_count << " games per configuration, seeds " << opts.seed << " to " << simulation.getSeed(opts.game_count - 1) << std::endl << std::endl;
+    std::cout << std::left << std::setw(10) << "size" << std::right
+              << std::setw(8) << "mines"
+              << std::setw(10) << "density"
+              << std::setw(10) << "win rate"
+              << std::setw(14) << "w/o guess"
+              << std::setw(15) << "guesses/game"
+              << std::setw(16) << "moves/s/core" << std::endl;
+
+    std::int64_t total_games = 0, total_moves = 0;
+    for (std::size_t i = 0; i < configs.size(); i++) {
+        const Simulation::Config& config = configs[i];
+        const Simulation::Stats& stats = simulation.getStats()[i];
+        total_games += stats.games;
+        total_moves += stats.moves;
+        std::cout << std::left << std::setw(10) << (std::to_string(config.width) + "x" + std::to_string(config.height)) << std::right
+                  << std::setw(8) << config.mine_count
+                  << std::setw(10) << percent(config.mine_count, static_cast<double>(config.width) * config.height)
+                  << std::setw(10) << percent(stats.wins, stats.games)
+                  << std::setw(14) << percent(stats.wins_without_guess, stats.games)
+                  << std::setw(15) << std::fixed << std::setprecision(2) << (0 < stats.games ? static_cast<double>(stats.guesses) / stats.games : 0)
+                  << std::setw(16) << std::setprecision(0) << (0 < stats.ms ? stats.moves * 1000.0 / stats.ms : 0) << std::endl;
+    }
+
+    double seconds = simulation.getElapsedMs() / 1000;
+    std::cout << std::endl << total_games << " games, " << total_moves << " moves in " << std::setprecision(2) << seconds << " s: "
+              << std::setprecision(0) << (0 < seconds ? total_moves / seconds : 0) << " moves/s" << std::endl;
+
+    if (0 < opts.loss_limit) {
+        std::cout << std::endl << "lost games (open the center field first, where the cursor starts):" << std::endl;
+        for (std::size_t i = 0; i < configs.size(); i++) {
+            for (std::int64_t game : simulation.getStats()[i].losses) {
+                std::cout << "  tmines -w " << configs[i].width << " -h " << configs[i].height << " -c " << configs[i].mine_count << " -s " << simulation.getSeed(game) << std::endl;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string bot_doc = "bot playing the games, one of:";
+    for (auto& name : Bot::getNames()) {
+        bot_doc += " " + name;
+    }
+    bot_doc += ", default: solver";
+
+    struct argp_option options[] = {
+        {0, 0, 0, 0, "Configurations", 10},
+        {"size", 'z', "WIDTHxHEIGHT", 0, "size of the minefields, can be repeated, default: 9x9, 16x16 and 30x16", 10},
+        {"mine-density", 'd', "PERCENTAGE", 0, "density of the mines, can be repeated, default: 12, 16 and 20", 10},
+        {0, 0, 0, OPTION_DOC, "note: every size is played w/ every density", 10},
+
+        {0, 0, 0, 0, "Games", 20},
+        {"games", 'n', "NUM", 0, "games per configuration, default: 1000", 20},
+        {"seed", 's', "SEED", 0, "seed of the first game, game i uses SEED + i, default: 0", 20},
+        {"bot", 'b', "NAME", 0, bot_doc.c_str(), 20},
+        {"threads", 't', "NUM", 0, "threads playing the games, default: one per core", 20},
+        {"losses", 'l', "NUM", 0, "print the tmines commands replaying the first NUM lost games per configuration", 20},
+
+        {0, 0, 0, 0, 0, 0}
+    };
+    struct argp argp = {options, parse_opt, 0, "Play many games of Minesweeper w/ a bot, w/o a terminal.", 0, 0, 0};
+
+    argp_parse(&argp, argc, argv, 0, 0, 0);
+
+    try {
+        run();
+    } catch (std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
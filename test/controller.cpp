@@ -285,6 +285,31 @@ TEST_CASE("Toggle Flag") {
     CHECK(! mfield.isFlagged(6, 6));
 }
 
+TEST_CASE("Changed Cells") {
+    auto con = Controller(8, 8, 10, 0);
+    std::vector<std::tuple<int, int>> changed;
+
+    con.tooggleFlag(0, 5);
+    con.drainChangedCells(changed);
+    CHECK(1 == changed.size());
+    CHECK(std::make_tuple(0, 5) == changed[0]);
+
+    // autodiscover reports the fields opened around the clicked one
+    con.click(0, 4);
+    con.drainChangedCells(changed);
+    CHECK(1 == changed.size());
+    con.click(0, 4);
+    con.drainChangedCells(changed);
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(1, 4)));
+    CHECK(changed.end() == std::find(changed.begin(), changed.end(), std::make_tuple(0, 5)));
+
+    // nothing happens on invalid clicks
+    con.click(-1, 3);
+    con.tooggleFlag(100, 3);
+    con.drainChangedCells(changed);
+    CHECK(changed.empty());
+}
+
 TEST_CASE("First Hit No Mine") {
     auto con = Controller(8, 8, 10, 0);
     CHECK_NOTHROW(con.click(0, 5));
@@ -335,3 +360,131 @@ TEST_CASE("Don't open on direct click") {
     CHECK(! mfield.isOpen(5, 0));
     CHECK(mfield.isFlagged(5, 0));
 }
+
+TEST_CASE("Batched Moves") {
+    typedef Minefield::MoveType MoveType;
+    typedef Minefield::MoveResult MoveResult;
+    std::vector<Minefield::MoveResult> results;
+    std::vector<std::tuple<int, int>> changed;
+
+    // same as the autodiscover test, in one batch
+    auto con = Controller(8, 8, 10, 0);
+    con.applyMoves({{MoveType::open, 0, 4}, {MoveType::flag, 0, 5}, {MoveType::chord, 0, 4}}, results, changed);
+    REQUIRE(3 == results.size());
+    CHECK(MoveResult::opened == results[0]);
+    CHECK(MoveResult::flag_placed == results[1]);
+    CHECK(MoveResult::opened == results[2]);
+    CHECK(con.getMinefield().isOpen(1, 5));
+    CHECK(con.getMinefield().isFlagged(0, 5));
+    CHECK(con.getMinefield().getOpenCount() + 1 == (int) changed.size());
+
+    // autodiscover only: the first open is allowed, later ones are not
+    con = Controller(8, 8, 10, 0, true);
+    con.applyMoves({{MoveType::open, 4, 0}, {MoveType::open, 5, 0}, {MoveType::flag, 5, 0}, {MoveType::chord, 4, 0}}, results, changed);
+    CHECK(MoveResult::opened == results[0]);
+    CHECK(MoveResult::not_allowed == results[1]);
+    CHECK(MoveResult::flag_placed == results[2]);
+    CHECK(MoveResult::opened == results[3]);
+    CHECK(con.getMinefield().isOpen(3, 1));
+    CHECK(! con.getMinefield().isOpen(5, 0));
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(4, 0)));
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(3, 1)));
+
+    // a field changed before and after a rejected open is reported once
+    con.applyMoves({{MoveType::unflag, 5, 0}, {MoveType::open, 6, 6}, {MoveType::flag, 5, 0}, {MoveType::open, 7, 7}, {MoveType::unflag, 5, 0}}, results, changed);
+    CHECK(MoveResult::flag_removed == results[0]);
+    CHECK(MoveResult::not_allowed == results[1]);
+    CHECK(MoveResult::flag_placed == results[2]);
+    CHECK(MoveResult::not_allowed == results[3]);
+    CHECK(MoveResult::flag_removed == results[4]);
+    CHECK(1 == std::count(changed.begin(), changed.end(), std::make_tuple(5, 0)));
+    CHECK(1 == changed.size());
+}
+
+TEST_CASE("Undo Redo") {
+    auto con = Controller(8, 8, 10, 0);
+    CHECK(! con.undo());
+
+    // click w/ autodiscover and flag are one move each
+    con.click(0, 4);
+    int open_count = con.getMinefield().getOpenCount();
+    con.tooggleFlag(0, 5);
+    con.click(0, 4);
+    CHECK(con.getMinefield().isOpen(1, 5));
+    CHECK(con.undo());
+    CHECK(! con.getMinefield().isOpen(1, 5));
+    CHECK(con.getMinefield().isFlagged(0, 5));
+    CHECK(con.undo());
+    CHECK(! con.getMinefield().isFlagged(0, 5));
+    CHECK(open_count == con.getMinefield().getOpenCount());
+    CHECK(con.redo());
+    CHECK(con.getMinefield().isFlagged(0, 5));
+
+    // lost games continue after undo
+    con.tooggleFlag(0, 5);
+    con.click(0, 5, false);
+    CHECK(con.getMinefield().isGameLost());
+    CHECK(con.undo());
+    CHECK(con.getMinefield().isGameRunning());
+    CHECK(! con.getMinefield().isOpen(0, 5));
+    CHECK(con.redo());
+    CHECK(con.getMinefield().isGameLost());
+
+    // a new move discards the undone moves
+    CHECK(con.undo());
+    con.tooggleFlag(7, 7);
+    CHECK(! con.redo());
+    CHECK(con.getMinefield().isFlagged(7, 7));
+}
+
+TEST_CASE("Huge Board") {
+    // uses the chunked storage of the minefield
+    auto con = Controller(100000, 100000, 2000000000, 0);
+    CHECK(100000 == con.getWidth());
+    CHECK(100000 == con.getHeight());
+
+    con.putCursor(99999, 12345);
+    CHECK(99999 == con.getX());
+    con.click();
+    con.moveLeft();
+    con.tooggleFlag();
+
+    const Minefield& mfield = con.getMinefield();
+    CHECK(mfield.isChunked());
+    CHECK(mfield.isOpen(99999, 12345));
+    CHECK(mfield.isGameRunning());
+}
+
+TEST_CASE("Unbounded Board") {
+    auto con = Controller(Minefield::createUnbounded(16, 3));
+    CHECK(0 == con.getX());
+    CHECK(0 == con.getY());
+
+    // cursor is not clamped to any dimensions
+    con.moveLeft();
+    con.moveUp();
+    CHECK(-1 == con.getX());
+    CHECK(-1 == con.getY());
+    con.putCursor(123456, -654321);
+    CHECK(123456 == con.getX());
+    CHECK(-654321 == con.getY());
+
+    con.click();
+    con.tooggleFlag(0, 0);
+    const Minefield& mfield = con.getMinefield();
+    CHECK(mfield.isUnbounded());
+    CHECK(mfield.isOpen(123456, -654321));
+    CHECK(mfield.isFlagged(0, 0));
+    CHECK(mfield.isGameRunning());
+}
+
+TEST_CASE("More than 2^31 fields") {
+    auto con = Controller(100000, 100000, 3000000000LL, std::int64_t(1) << 40);
+    const Minefield& mfield = con.getMinefield();
+    CHECK(3000000000LL == mfield.getMineCount());
+    CHECK((std::int64_t(1) << 40) == mfield.getSeed());
+
+    con.putCursor(99999, 99999);
+    con.click();
+    CHECK(mfield.isOpen(99999, 99999));
+}
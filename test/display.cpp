@@ -4,10 +4,14 @@
 #include "display.hpp"
 
 #include "iodevice_simulation.hpp"
+#include "probability.hpp"
+#include "solver.hpp"
 
 #include <memory>
 #include <curses.h>
 #include <string>
+#include <tuple>
+#include <vector>
 
 TEST_CASE("Finish on Q") {
     // prep iodevice
@@ -213,6 +217,82 @@ TEST_CASE("Other Mappings (Flag, redraw, open, window resize)") {
     CHECK(! mfield.isFlagged(1, 1));
 }
 
+TEST_CASE("Undo Redo Mappings") {
+    IODeviceSimulation io;
+    io.setDim(100, 100);
+
+    // flag 3,3 4,3; undo twice, redo once; open 3,4; undo
+    io.addChars("fdfuUysa uq");
+    std::shared_ptr<IODevice> io_ptr = std::make_shared<IODeviceSimulation>(io);
+    Display display(io_ptr, 8, 8, 10, 0, false);
+
+    auto mfield = display.getController().getMinefield();
+    CHECK(mfield.isFlagged(3, 3));
+    CHECK(! mfield.isFlagged(4, 3));
+    CHECK(0 == mfield.getOpenCount());
+    CHECK(mfield.canRedo());
+}
+
+TEST_CASE("Hint Mapping") {
+    IODeviceSimulation io;
+    io.setDim(100, 100);
+
+    // open the center, then ask for a hint
+    io.addChars(" ?q");
+    std::shared_ptr<IODevice> io_ptr = std::make_shared<IODeviceSimulation>(io);
+    Display display(io_ptr, 30, 16, 40, 3, false);
+
+    auto controller = display.getController();
+    Solver solver;
+    solver.reset(controller.getMinefield());
+    std::vector<std::tuple<int, int>> safe_fields;
+    solver.getSafeFields(safe_fields);
+    REQUIRE(! safe_fields.empty());
+    CHECK(solver.isSafe(controller.getX(), controller.getY()));
+}
+
+TEST_CASE("Hint in the Background") {
+    IODeviceSimulation io;
+    io.setDim(100, 100);
+
+    // the first click only reveals a number: nothing to deduce, so the hint is a guess found in the background
+    io.addChars(" ?");
+    io.addChar(IODeviceSimulation::WAIT_FOR_WAKE);
+    io.addChars("q");
+    std::shared_ptr<IODevice> io_ptr = std::make_shared<IODeviceSimulation>(io);
+    Display display(io_ptr, 30, 16, 99, 0, false);
+
+    auto controller = display.getController();
+    auto mfield = controller.getMinefield();
+    Solver solver;
+    solver.reset(mfield);
+    std::vector<std::tuple<int, int>> deduced;
+    solver.getSafeFields(deduced);
+    solver.getMines(deduced);
+    REQUIRE(deduced.empty());
+
+    // cursor on the field least likely to be a mine
+    ProbabilityEngine engine;
+    engine.calculate(mfield);
+    CHECK(! mfield.isOpen(controller.getX(), controller.getY()));
+    for (int x = 0; x < 30; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (! mfield.isOpen(x, y)) {
+                CHECK(engine.getProbability(controller.getX(), controller.getY()) <= engine.getProbability(x, y));
+            }
+        }
+    }
+
+    // moving on cancels the guess: w/o waiting for it, the cursor stays where it has been moved to
+    IODeviceSimulation io_cancel;
+    io_cancel.setDim(100, 100);
+    io_cancel.addChars(" ?lq");
+    io_ptr = std::make_shared<IODeviceSimulation>(io_cancel);
+    Display display_cancel(io_ptr, 30, 16, 99, 0, false);
+    CHECK(15 == display_cancel.getController().getX());
+    CHECK(7 == display_cancel.getController().getY());
+}
+
 TEST_CASE("API calls") {
     // checks that the correct calls to the IODevice have been made
     auto io = std::make_shared<IODeviceSimulation>(IODeviceSimulation());
@@ -657,3 +737,41 @@ TEST_CASE("Check passing") {
     CHECK_THROWS(Display(io, 1, -1, 0));
     CHECK_THROWS(Display(io, 1, 1, -1));
 }
+
+TEST_CASE("Unbounded Viewport") {
+    msgs_struct msgs;
+    auto io = std::make_shared<IODeviceSimulation>(IODeviceSimulation());
+    // fits a viewport of 15x10 fields, centered around the cursor at (0, 0)
+    io->setDim(30, 13);
+
+    // flag (0, 0), then move left until the viewport has to follow
+    io->addChars("fhhhhhhhhq");
+    Display display(io, Controller(Minefield::createUnbounded(16, 0)));
+
+    auto con = display.getController();
+    CHECK(-8 == con.getX());
+    CHECK(0 == con.getY());
+    CHECK(con.getMinefield().isFlagged(0, 0));
+
+    // again, but keep the output
+    io->addChars("fhhhhhhhh");
+    io->addChar(KEY_RESIZE);
+    io->mockResize();
+    CHECK_THROWS(Display(io, Controller(Minefield::createUnbounded(16, 0))));
+    io->mockResize(-1);
+
+    // (0, 0) has been rendered at the center before, now (-8, 0) is there
+    int console_x, console_y;
+    std::tie(console_x, console_y) = Display::getConsolePosition(7, 5);
+    CHECK('*' == io->getPrintedChars()[console_x][console_y]);
+
+    auto printed_chars = io->getPrintedChars();
+    std::string everything = "";
+    for (int y = 0; y < io->getHeight(); y++) {
+        for (int x = 0; x < io->getWidth(); x++) {
+            everything += printed_chars[x][y];
+        }
+    }
+    CHECK(everything.find("1 flags placed") != std::string::npos);
+    CHECK(everything.find(msgs.running) != std::string::npos);
+}
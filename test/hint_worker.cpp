@@ -0,0 +1,116 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "hint_worker.hpp"
+#include "probability.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+/**
+ * Opens the center of a board where nothing can be deduced afterwards.
+ * @return minefield w/ a running game
+ */
+static Minefield openedBoard() {
+    auto mfield = Minefield(30, 16, 99, 0);
+    mfield.open(15, 8);
+    return mfield;
+}
+
+TEST_CASE("Least Likely Mine") {
+    auto mfield = openedBoard();
+    REQUIRE(mfield.isGameRunning());
+
+    std::atomic<int> finished(0);
+    HintWorker worker([&finished] {
+        finished++;
+    });
+    HintWorker::Hint hint;
+    CHECK(! worker.takeHint(hint));
+
+    worker.request(mfield, 0, 0);
+    worker.wait();
+    REQUIRE(worker.takeHint(hint));
+    CHECK(1 == finished);
+    // taken only once
+    CHECK(! worker.takeHint(hint));
+
+    ProbabilityEngine engine;
+    engine.calculate(mfield);
+    CHECK(! mfield.isOpen(hint.x, hint.y));
+    CHECK(engine.getProbability(hint.x, hint.y) == doctest::Approx(hint.probability));
+    for (int x = 0; x < 30; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (! mfield.isOpen(x, y)) {
+                CHECK(hint.probability <= engine.getProbability(x, y) + 1e-9);
+            }
+        }
+    }
+}
+
+TEST_CASE("Later Requests Supersede") {
+    auto mfield = openedBoard();
+    std::atomic<int> finished(0);
+    HintWorker worker([&finished] {
+        finished++;
+    });
+
+    // of the equally likely fields, the closest one to the last cursor wins
+    worker.request(mfield, 0, 0);
+    worker.request(mfield, 29, 15);
+    worker.wait();
+    HintWorker::Hint hint;
+    REQUIRE(worker.takeHint(hint));
+    CHECK(1 <= finished);
+    ProbabilityEngine engine;
+    engine.calculate(mfield);
+    for (int x = 0; x < 30; x++) {
+        for (int y = 0; y < 16; y++) {
+            if (! mfield.isOpen(x, y) && std::abs(engine.getProbability(x, y) - hint.probability) < 1e-12) {
+                CHECK(std::abs(hint.x - 29) + std::abs(hint.y - 15) <= std::abs(x - 29) + std::abs(y - 15));
+            }
+        }
+    }
+
+    // flagged fields are skipped
+    mfield.flag(hint.x, hint.y);
+    worker.request(mfield, 29, 15);
+    worker.wait();
+    HintWorker::Hint flagged_hint;
+    REQUIRE(worker.takeHint(flagged_hint));
+    CHECK((flagged_hint.x != hint.x || flagged_hint.y != hint.y));
+}
+
+TEST_CASE("Cancel") {
+    auto mfield = openedBoard();
+    HintWorker worker([] {});
+    worker.request(mfield, 0, 0);
+    worker.cancel();
+    worker.wait();
+    HintWorker::Hint hint;
+    CHECK(! worker.takeHint(hint));
+
+    // the snapshot is independent of the original
+    worker.request(mfield, 0, 0);
+    mfield.open(0, 0);
+    worker.wait();
+    CHECK(worker.takeHint(hint));
+
+    // the destructor stops a pending request
+    HintWorker pending([] {});
+    pending.request(mfield, 0, 0);
+}
+
+TEST_CASE("Unbounded and Ended Games") {
+    HintWorker worker([] {});
+    CHECK_THROWS_AS(worker.request(Minefield::createUnbounded(20), 0, 0), std::runtime_error);
+
+    auto mfield = Minefield(3, 3, 8, 0);
+    mfield.open(1, 1);
+    worker.request(mfield, 0, 0);
+    worker.wait();
+    HintWorker::Hint hint;
+    CHECK(! worker.takeHint(hint));
+}
@@ -595,3 +595,26 @@ TEST_CASE("mock resize") {
     CHECK(13 == io.getWidth());
     CHECK(37 == io.getHeight());
 }
+
+TEST_CASE("wake") {
+    IODeviceSimulation io;
+    io.addChar('a');
+    io.addChar(IODeviceSimulation::WAIT_FOR_WAKE);
+    io.addChar('b');
+    io.addChar(IODeviceSimulation::WAIT_FOR_WAKE);
+
+    // wakes are only delivered where the input waits for them, also if woken through a copy
+    IODeviceSimulation copy = io;
+    copy.wake();
+    CHECK('a' == io.getChar());
+    CHECK(IODevice::WAKE_KEY == io.getChar());
+    CHECK('b' == io.getChar());
+
+    // woken from another thread while waiting
+    std::thread waker([&io] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        io.wake();
+    });
+    CHECK(IODevice::WAKE_KEY == io.getChar());
+    waker.join();
+}
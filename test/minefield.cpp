@@ -2,10 +2,14 @@
 #include "doctest/doctest.h"
 
 #include "minefield.hpp"
+#include "fixed_board.hpp"
+#include "mine_placement.hpp"
+#include "neighbour_count.hpp"
 
 #include <vector>
 #include <tuple>
 #include <algorithm>
+#include <thread>
 
 TEST_CASE("Dimension test") {
     auto mfield = Minefield(10, 10);
@@ -112,6 +116,29 @@ TEST_CASE("Game State") {
 }
 
 
+TEST_CASE("Game State on full and empty boards") {
+    // nothing to open -> won right away
+    auto mfield = Minefield(8, 8, 64, 0);
+    CHECK(mfield.isGameEnded());
+    CHECK(mfield.isGameWon());
+    CHECK(! mfield.isGameLost());
+
+    // everything opened w/ a single click
+    mfield = Minefield(8, 8, 0, 0);
+    CHECK(mfield.isGameRunning());
+    mfield.open(3, 3);
+    CHECK(mfield.isGameWon());
+    CHECK(! mfield.isGameLost());
+
+    // lost stays lost
+    mfield = Minefield(8, 8, 10, 0);
+    mfield.open(0, 0, false);
+    mfield.open(0, 5, false);
+    CHECK(mfield.isGameLost());
+    CHECK(! mfield.isGameWon());
+    CHECK(mfield.isGameEnded());
+}
+
 TEST_CASE("Open Test") {
     auto mfield = Minefield(8, 8, 10, 0);
 
@@ -251,6 +278,31 @@ TEST_CASE("Sourrounding Mines") {
     CHECK_NOTHROW(mfield.getSorroundingMineCount(6, 6));
 }
 
+TEST_CASE("Sourrounding Mines after moving first mine") {
+    // (0, 5) is a mine, opening it first moves the mine somewhere else
+    auto mfield = Minefield(8, 8, 10, 0);
+    mfield.open(0, 5, false);
+    CHECK(! mfield.isGameLost());
+
+    // end game to be able to query all fields
+    mfield.open(6, 6, false);
+    CHECK(mfield.isGameLost());
+
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            int expected = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((dx != 0 || dy != 0) && mfield.isPosValid(x + dx, y + dy) && mfield.isMine(x + dx, y + dy)) {
+                        expected++;
+                    }
+                }
+            }
+            CHECK(expected == mfield.getSorroundingMineCount(x, y));
+        }
+    }
+}
+
 TEST_CASE("Is Mine") {
     auto mfield = Minefield(8, 8, 10, 0);
 
@@ -319,6 +371,125 @@ TEST_CASE("Open Recursively") {
     CHECK_NOTHROW(mfield.open(0, 0));
 }
 
+TEST_CASE("Open Recursively matches reference") {
+    for (int seed = 0; seed < 20; seed++) {
+        auto mfield = Minefield(30, 20, 60, seed);
+        mfield.flag(0, 0);
+        mfield.flag(29, 19);
+        mfield.open(15, 10);
+
+        // lose a copy of the game, so every field can be queried
+        auto revealed = mfield;
+        for (int i = 0; revealed.isGameRunning(); i++) {
+            if (! revealed.isFlagged(i % 30, i / 30)) {
+                revealed.open(i % 30, i / 30, false);
+            }
+        }
+
+        // reference: breadth first search over fields w/o sorrounding mines
+        std::vector<std::vector<bool>> expected(30, std::vector<bool>(20, false));
+        std::vector<std::tuple<int, int>> todo = {std::make_tuple(15, 10)};
+        expected[15][10] = true;
+        while (! todo.empty()) {
+            int x, y;
+            std::tie(x, y) = todo.back();
+            todo.pop_back();
+            if (0 != revealed.getSorroundingMineCount(x, y)) {
+                continue;
+            }
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if (revealed.isPosValid(x + dx, y + dy) && ! expected[x + dx][y + dy]) {
+                        expected[x + dx][y + dy] = true;
+                        todo.push_back(std::make_tuple(x + dx, y + dy));
+                    }
+                }
+            }
+        }
+
+        for (int x = 0; x < 30; x++) {
+            for (int y = 0; y < 20; y++) {
+                CHECK(expected[x][y] == mfield.isOpen(x, y));
+                if (expected[x][y]) {
+                    CHECK(! mfield.isFlagged(x, y));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Open Recursively on huge empty field") {
+    // would overflow the stack w/ a recursive implementation
+    auto mfield = Minefield(2000, 2000, 0, 0);
+    mfield.flag(1000, 1000);
+    mfield.open(0, 0);
+
+    CHECK(mfield.isGameWon());
+    CHECK(2000 * 2000 == mfield.getOpenCount());
+    CHECK(0 == mfield.getFlagCount());
+}
+
+TEST_CASE("Changed Cells") {
+    auto mfield = Minefield(8, 8, 10, 0);
+    std::vector<std::tuple<int, int>> changed;
+
+    // not recorded by default
+    CHECK(! mfield.isChangeTrackingEnabled());
+    mfield.flag(3, 3);
+    mfield.unflag(3, 3);
+    mfield.drainChangedCells(changed);
+    CHECK(changed.empty());
+
+    // disabling discards the pending changes
+    mfield.setChangeTrackingEnabled(true);
+    CHECK(mfield.isChangeTrackingEnabled());
+    mfield.flag(3, 3);
+    mfield.setChangeTrackingEnabled(false);
+    mfield.setChangeTrackingEnabled(true);
+    mfield.unflag(3, 3);
+    mfield.drainChangedCells(changed);
+    CHECK(1 == changed.size());
+
+    // flag + unflag: reported once
+    mfield.flag(3, 3);
+    mfield.unflag(3, 3);
+    mfield.flag(4, 4);
+    mfield.drainChangedCells(changed);
+    CHECK(2 == changed.size());
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(3, 3)));
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(4, 4)));
+
+    // drained -> nothing left
+    mfield.drainChangedCells(changed);
+    CHECK(changed.empty());
+
+    // recursive open reports every opened field
+    mfield.unflag(4, 4);
+    mfield.open(0, 0);
+    mfield.drainChangedCells(changed);
+    CHECK(mfield.getOpenCount() + 1 == (int) changed.size());
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            if (mfield.isOpen(x, y)) {
+                CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(x, y)));
+            }
+        }
+    }
+
+    // losing reveals all mines and wrong flags
+    mfield.flag(7, 7);
+    mfield.flag(6, 6);
+    mfield.drainChangedCells(changed);
+    mfield.open(0, 5, false);
+    mfield.drainChangedCells(changed);
+
+    // 10 mines, one of them flagged (6, 6) -> 9 revealed (including the opened one) + wrong flag on (7, 7)
+    CHECK(10 == changed.size());
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(0, 5)));
+    CHECK(changed.end() != std::find(changed.begin(), changed.end(), std::make_tuple(7, 7)));
+    CHECK(changed.end() == std::find(changed.begin(), changed.end(), std::make_tuple(6, 6)));
+}
+
 TEST_CASE("Copy Constructor") {
     auto mfield = Minefield(8, 8, 10, 0);
 
@@ -343,6 +514,503 @@ TEST_CASE("Copy Constructor") {
     }
 }
 
+TEST_CASE("Copy On Write") {
+    auto mfield = Minefield(100, 100, 1000, 3);
+    CHECK(! mfield.isSharingCells());
+    mfield.open(50, 50);
+
+    // copies share the cells until one of them changes
+    auto branch = mfield;
+    auto other = mfield;
+    CHECK(mfield.isSharingCells());
+    CHECK(branch.isSharingCells());
+
+    // reads don't detach
+    CHECK(branch.isOpen(50, 50));
+    CHECK(branch.isSharingCells());
+
+    // the changed copy detaches, the others still share
+    branch.flag(0, 0);
+    CHECK(! branch.isSharingCells());
+    CHECK(mfield.isSharingCells());
+    CHECK(branch.isFlagged(0, 0));
+    CHECK(! mfield.isFlagged(0, 0));
+    CHECK(! other.isFlagged(0, 0));
+
+    // the original can change as well, the copy keeps the old state
+    other = Minefield(mfield);
+    mfield.flag(99, 99);
+    CHECK(! mfield.isSharingCells());
+    CHECK(! other.isFlagged(99, 99));
+    CHECK(mfield.isFlagged(99, 99));
+
+    // opening a region detaches once
+    int x = 0;
+    while (other.isOpen(x, 0) || other.isFlagged(x, 0)) {
+        x++;
+    }
+    auto before = other;
+    other.open(x, 0, false);
+    CHECK(other.isOpen(x, 0));
+    CHECK(! before.isOpen(x, 0));
+    CHECK(before.getOpenCount() + 1 == other.getOpenCount());
+
+    // a copy on another thread keeps reading the old cells while the original changes
+    auto snapshot = other;
+    std::int64_t open_count = 0;
+    std::thread reader([&snapshot, &open_count]() {
+        for (int y = 0; y < 100; y++) {
+            for (int x = 0; x < 100; x++) {
+                open_count += snapshot.isOpen(x, y);
+            }
+        }
+        snapshot = Minefield();
+    });
+    other.flag(99, 0);
+    reader.join();
+    CHECK(open_count == before.getOpenCount() + 1);
+    CHECK(other.isFlagged(99, 0));
+    other.unflag(99, 0);
+    CHECK(! other.isSharingCells());
+
+    // chunked boards are copied right away
+    auto chunked = Minefield(100, 100, 1000, 3, Minefield::StorageMode::chunked);
+    auto chunked_copy = chunked;
+    CHECK(! chunked.isSharingCells());
+}
+
+TEST_CASE("Non-throwing Moves") {
+    typedef Minefield::MoveResult MoveResult;
+    auto mfield = Minefield(8, 8, 10, 0);
+
+    CHECK(MoveResult::invalid == mfield.tryOpen(-1, 0));
+    CHECK(MoveResult::invalid == mfield.tryFlag(8, 0));
+    CHECK(MoveResult::invalid == mfield.tryUnflag(0, 8));
+
+    CHECK(MoveResult::flag_placed == mfield.tryFlag(7, 7));
+    CHECK(MoveResult::flagged == mfield.tryFlag(7, 7));
+    CHECK(MoveResult::flagged == mfield.tryOpen(7, 7));
+    CHECK(MoveResult::flag_removed == mfield.tryUnflag(7, 7));
+    CHECK(MoveResult::not_flagged == mfield.tryUnflag(7, 7));
+    CHECK(0 == mfield.getFlagCount());
+
+    // non-recursive first, then expanded by the recursive call
+    CHECK(MoveResult::opened == mfield.tryOpen(0, 0, false));
+    CHECK(1 == mfield.getOpenCount());
+    CHECK(MoveResult::opened == mfield.tryOpen(0, 0));
+    CHECK(mfield.isOpen(1, 0));
+    CHECK(MoveResult::already_open == mfield.tryOpen(0, 0));
+    CHECK(MoveResult::already_open == mfield.tryFlag(0, 0));
+    CHECK(MoveResult::already_open == mfield.tryUnflag(0, 0));
+
+    // same state as w/ the throwing calls
+    auto reference = Minefield(8, 8, 10, 0);
+    reference.open(0, 0);
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            CHECK(reference.isOpen(x, y) == mfield.isOpen(x, y));
+        }
+    }
+
+    // lose: every move reports the ended game
+    CHECK(MoveResult::opened == mfield.tryOpen(0, 5));
+    CHECK(mfield.isGameLost());
+    CHECK(MoveResult::game_over == mfield.tryOpen(7, 7));
+    CHECK(MoveResult::game_over == mfield.tryFlag(7, 7));
+    CHECK(MoveResult::game_over == mfield.tryUnflag(7, 7));
+    CHECK(MoveResult::invalid == mfield.tryOpen(100, 100));
+}
+
+TEST_CASE("Batched Moves") {
+    typedef Minefield::MoveResult MoveResult;
+    typedef Minefield::MoveType MoveType;
+
+    // same moves one by one and as batch
+    auto single = Minefield(8, 8, 10, 0);
+    auto batched = single;
+    std::vector<Minefield::Move> moves = {
+        {MoveType::open, 0, 4},
+        {MoveType::chord, 0, 4},
+        {MoveType::flag, 0, 5},
+        {MoveType::flag, 0, 5},
+        {MoveType::open, 0, 5},
+        {MoveType::chord, 0, 4},
+        {MoveType::chord, 6, 6},
+        {MoveType::unflag, 7, 7},
+        {MoveType::open, 9, 9},
+        {MoveType::open, 0, 4},
+    };
+    std::vector<MoveResult> expected = {
+        MoveResult::opened,
+        MoveResult::already_open,
+        MoveResult::flag_placed,
+        MoveResult::flagged,
+        MoveResult::flagged,
+        MoveResult::opened,
+        MoveResult::not_open,
+        MoveResult::not_flagged,
+        MoveResult::invalid,
+        MoveResult::already_open,
+    };
+
+    std::vector<MoveResult> single_results;
+    for (auto& move : moves) {
+        switch (move.type) {
+            case MoveType::open: single_results.push_back(single.tryOpen(move.x, move.y)); break;
+            case MoveType::flag: single_results.push_back(single.tryFlag(move.x, move.y)); break;
+            case MoveType::unflag: single_results.push_back(single.tryUnflag(move.x, move.y)); break;
+            case MoveType::chord: single_results.push_back(single.tryChord(move.x, move.y)); break;
+        }
+    }
+    CHECK(expected == single_results);
+
+    std::vector<MoveResult> results(moves.size());
+    std::vector<std::tuple<int, int>> changed;
+    batched.applyMoves(moves.data(), moves.size(), results.data(), changed);
+    CHECK(expected == results);
+
+    // one change set for the whole batch, every field once
+    CHECK(batched.getOpenCount() + batched.getFlagCount() == (int) changed.size());
+    std::sort(changed.begin(), changed.end());
+    CHECK(changed.end() == std::adjacent_find(changed.begin(), changed.end()));
+    CHECK(batched.isOpen(1, 3));
+    CHECK(batched.isFlagged(0, 5));
+    for (int x = 0; x < 8; x++) {
+        for (int y = 0; y < 8; y++) {
+            CHECK(single.isOpen(x, y) == batched.isOpen(x, y));
+            CHECK(single.isFlagged(x, y) == batched.isFlagged(x, y));
+        }
+    }
+
+    // moves after losing are rejected
+    std::vector<Minefield::Move> losing = {{MoveType::unflag, 0, 5}, {MoveType::open, 0, 5}, {MoveType::flag, 7, 7}};
+    batched.applyMoves(losing.data(), losing.size(), results.data(), changed);
+    CHECK(MoveResult::flag_removed == results[0]);
+    CHECK(MoveResult::opened == results[1]);
+    CHECK(MoveResult::game_over == results[2]);
+    CHECK(batched.isGameLost());
+}
+
+TEST_CASE("Sorrounding Flag Counts") {
+    // cached flag counts match counting the flags one by one
+    auto check_flag_counts = [](const Minefield& mfield) {
+        for (int x = 0; x < mfield.getXDimension(); x++) {
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                int flag_count = 0;
+                for (int dx = -1; dx <= 1; dx++) {
+                    for (int dy = -1; dy <= 1; dy++) {
+                        if ((0 != dx || 0 != dy) && mfield.isPosValid(x + dx, y + dy)) {
+                            flag_count += mfield.isFlagged(x + dx, y + dy);
+                        }
+                    }
+                }
+                CHECK(flag_count == mfield.getSorroundingFlagCount(x, y));
+            }
+        }
+    };
+
+    auto mfield = Minefield(3, 3, 0, 0);
+    CHECK(0 == mfield.getSorroundingFlagCount(1, 1));
+    mfield.flag(0, 0);
+    mfield.flag(2, 2);
+    CHECK(2 == mfield.getSorroundingFlagCount(1, 1));
+    CHECK(0 == mfield.getSorroundingFlagCount(0, 0));
+    CHECK(1 == mfield.getSorroundingFlagCount(0, 1));
+    mfield.unflag(0, 0);
+    CHECK(1 == mfield.getSorroundingFlagCount(1, 1));
+    CHECK_THROWS(mfield.getSorroundingFlagCount(3, 0));
+
+    // flags removed by opening regions, w/ both engines, and on chunked boards w/ eviction
+    for (auto storage_mode : {Minefield::StorageMode::dense, Minefield::StorageMode::chunked}) {
+        for (auto engine : {Minefield::ExpansionEngine::scanline, Minefield::ExpansionEngine::bitwise}) {
+            for (int seed = 0; seed < 4; seed++) {
+                auto mfield = Minefield(150, 90, 600, seed, storage_mode);
+                mfield.setExpansionEngine(engine);
+                mfield.open(75, 45);
+
+                // lose a copy of the game, so every field can be queried
+                auto revealed = mfield;
+                for (int i = 0; revealed.isGameRunning(); i++) {
+                    revealed.open(i % 150, i / 150, false);
+                }
+
+                for (int i = 0; i < 300 && mfield.isGameRunning(); i++) {
+                    int x = (i * 7919 + seed) % 150;
+                    int y = (i * 104729) % 90;
+                    if (mfield.isOpen(x, y)) {
+                        mfield.tryChord(x, y);
+                    } else if (0 != i % 3) {
+                        mfield.tryFlag(x, y);
+                    } else if (0 == i % 4) {
+                        mfield.tryUnflag(x, y);
+                    } else if (! revealed.isMine(x, y)) {
+                        mfield.tryOpen(x, y);
+                    }
+                }
+                check_flag_counts(mfield);
+            }
+        }
+    }
+}
+
+TEST_CASE("Chord") {
+    typedef Minefield::MoveResult MoveResult;
+
+    auto mined = Minefield(8, 8, 10, 0);
+    mined.open(0, 4);
+    CHECK(MoveResult::already_open == mined.tryChord(0, 4));
+
+    auto revealed = mined;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % 8, i / 8, false);
+    }
+
+    // chord opens all sorrounding fields w/o flag, once the flags match the count
+    int chord_x = -1, chord_y = -1;
+    for (int x = 0; x < 8 && -1 == chord_x; x++) {
+        for (int y = 0; y < 8 && -1 == chord_x; y++) {
+            if (mined.isOpen(x, y) && 0 < mined.getSorroundingMineCount(x, y)) {
+                chord_x = x;
+                chord_y = y;
+            }
+        }
+    }
+    REQUIRE(-1 != chord_x);
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            if (mined.isPosValid(chord_x + dx, chord_y + dy) && revealed.isMine(chord_x + dx, chord_y + dy)) {
+                mined.flag(chord_x + dx, chord_y + dy);
+            }
+        }
+    }
+    CHECK(mined.getSorroundingMineCount(chord_x, chord_y) == mined.getSorroundingFlagCount(chord_x, chord_y));
+    mined.tryChord(chord_x, chord_y);
+    CHECK(mined.isGameRunning());
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            if (mined.isPosValid(chord_x + dx, chord_y + dy)) {
+                CHECK(mined.isOpen(chord_x + dx, chord_y + dy) != mined.isFlagged(chord_x + dx, chord_y + dy));
+            }
+        }
+    }
+
+    CHECK(MoveResult::invalid == mined.tryChord(8, 0));
+}
+
+TEST_CASE("Undo Redo") {
+    // everything visible (and the cached flag counts) in one list
+    auto snapshot = [](const Minefield& mfield) {
+        std::vector<std::int64_t> state = {mfield.getOpenCount(), mfield.getFlagCount(), mfield.isGameLost()};
+        for (int x = 0; x < mfield.getXDimension(); x++) {
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                state.push_back(mfield.isOpen(x, y) + 2 * mfield.isFlagged(x, y) + 4 * mfield.getSorroundingFlagCount(x, y));
+            }
+        }
+        return state;
+    };
+
+    auto mfield = Minefield(8, 8, 10, 0);
+    CHECK(! mfield.isUndoEnabled());
+    mfield.open(0, 4);
+    CHECK(! mfield.canUndo());
+    CHECK(! mfield.undo());
+
+    // every storage and engine, w/ flags removed by regions, chords and losing
+    for (auto storage_mode : {Minefield::StorageMode::dense, Minefield::StorageMode::chunked}) {
+        for (auto engine : {Minefield::ExpansionEngine::scanline, Minefield::ExpansionEngine::bitwise}) {
+            for (int seed = 0; seed < 4; seed++) {
+                auto mfield = Minefield(150, 90, 1500, seed, storage_mode);
+                mfield.setExpansionEngine(engine);
+                mfield.setUndoEnabled(true);
+                mfield.setChangeTrackingEnabled(true);
+                if (Minefield::StorageMode::chunked == storage_mode) {
+                    mfield.setChunkLimit(2);
+                }
+
+                std::vector<std::vector<std::int64_t>> states = {snapshot(mfield)};
+                for (int i = 0; i < 200 && mfield.isGameRunning(); i++) {
+                    int x = (i * 7919 + seed) % 150;
+                    int y = (i * 104729) % 90;
+                    bool changed = false;
+                    if (mfield.isOpen(x, y)) {
+                        changed = Minefield::MoveResult::opened == mfield.tryChord(x, y);
+                    } else if (0 != i % 3) {
+                        changed = Minefield::MoveResult::flag_placed == mfield.tryFlag(x, y);
+                    } else {
+                        changed = Minefield::MoveResult::opened == mfield.tryOpen(x, y);
+                    }
+                    if (changed) {
+                        states.push_back(snapshot(mfield));
+                    }
+                }
+
+                // back to the start, and forward again
+                std::vector<std::tuple<int, int>> changed_cells;
+                for (std::size_t i = states.size() - 1; i > 0; i--) {
+                    CHECK(mfield.canUndo());
+                    CHECK(mfield.undo());
+                    CHECK(states[i - 1] == snapshot(mfield));
+                }
+                CHECK(! mfield.canUndo());
+                CHECK(mfield.isGameRunning());
+                mfield.drainChangedCells(changed_cells);
+                for (std::size_t i = 1; i < states.size(); i++) {
+                    CHECK(mfield.canRedo());
+                    CHECK(mfield.redo());
+                    CHECK(states[i] == snapshot(mfield));
+                }
+                CHECK(! mfield.canRedo());
+
+                // undone regions open again
+                while (1 < mfield.getOpenCount() && mfield.undo()) {
+                }
+                mfield.open(75, 45);
+                CHECK(! mfield.canRedo());
+                CHECK(mfield.isOpen(75, 45));
+            }
+        }
+    }
+
+    // first move w/ mine: undo moves the mine back, redo moves it away again
+    auto original = Minefield(4, 4, 14, 1);
+    mfield = original;
+    mfield.setUndoEnabled(true);
+    mfield.open(1, 1);
+    auto opened = snapshot(mfield);
+    CHECK(mfield.undo());
+    CHECK(mfield.redo());
+    CHECK(opened == snapshot(mfield));
+    CHECK(mfield.undo());
+    for (auto& board : {&original, &mfield}) {
+        for (int i = 0; board->isGameRunning(); i++) {
+            board->open(i % 4, i / 4, false);
+        }
+    }
+    CHECK(snapshot(original) == snapshot(mfield));
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            CHECK(original.isMine(x, y) == mfield.isMine(x, y));
+        }
+    }
+
+    // moves that change nothing keep the undone moves
+    mfield = Minefield(8, 8, 10, 0);
+    mfield.setUndoEnabled(true);
+    mfield.setChangeTrackingEnabled(true);
+    mfield.tryOpen(0, 4);
+    mfield.tryFlag(0, 5);
+    CHECK(mfield.undo());
+    CHECK(Minefield::MoveResult::already_open == mfield.tryOpen(0, 4));
+    CHECK(mfield.canRedo());
+    CHECK(mfield.redo());
+    CHECK(mfield.isFlagged(0, 5));
+
+    // undoing and redoing a lost game reports the same fields as losing it
+    std::vector<std::tuple<int, int>> lost_changed, undo_changed, redo_changed;
+    mfield.tryUnflag(0, 5);
+    mfield.drainChangedCells(lost_changed);
+    CHECK(Minefield::MoveResult::opened == mfield.tryOpen(0, 5));
+    CHECK(mfield.isGameLost());
+    mfield.drainChangedCells(lost_changed);
+    CHECK(mfield.undo());
+    CHECK(mfield.isGameRunning());
+    mfield.drainChangedCells(undo_changed);
+    CHECK(mfield.redo());
+    CHECK(mfield.isGameLost());
+    mfield.drainChangedCells(redo_changed);
+    std::sort(lost_changed.begin(), lost_changed.end());
+    std::sort(undo_changed.begin(), undo_changed.end());
+    std::sort(redo_changed.begin(), redo_changed.end());
+    CHECK(10 == lost_changed.size());
+    CHECK(lost_changed == undo_changed);
+    CHECK(lost_changed == redo_changed);
+
+    // opening an entire board is stored as one run per row
+    mfield = Minefield(1000, 1000, 0, 0);
+    mfield.setUndoEnabled(true);
+    mfield.open(500, 500);
+    CHECK(mfield.isGameWon());
+    CHECK(mfield.getUndoMemory() < 1000 * sizeof(JournalRun) + 1024);
+    CHECK(mfield.undo());
+    CHECK(0 == mfield.getOpenCount());
+    mfield.open(0, 0);
+    CHECK(1000 * 1000 == mfield.getOpenCount());
+
+    // copies share a long history until one of them changes it
+    mfield = Minefield(100, 100, 0, 0);
+    mfield.setUndoEnabled(true);
+    for (int i = 0; i < 5000; i++) {
+        mfield.tryFlag(i % 100, i / 100);
+    }
+    std::size_t history_memory = mfield.getUndoMemory();
+    Minefield branch = mfield;
+    CHECK(mfield.isSharingJournal());
+    CHECK(branch.isSharingJournal());
+    CHECK(history_memory == branch.getUndoMemory());
+    CHECK(branch.undo());
+    CHECK(! branch.isSharingJournal());
+    CHECK(! mfield.isSharingJournal());
+    CHECK(branch.canRedo());
+    CHECK(! mfield.canRedo());
+    CHECK(mfield.isFlagged(99, 49));
+    CHECK(! branch.isFlagged(99, 49));
+
+    // disabling forgets the moves
+    mfield.setUndoEnabled(false);
+    CHECK(! mfield.canUndo());
+    CHECK(branch.canUndo());
+}
+
+TEST_CASE("State Hash") {
+    auto mfield = Minefield(8, 8, 10, 0);
+    CHECK(0 == mfield.getStateHash());
+    mfield.flag(1, 1);
+    auto flagged = mfield.getStateHash();
+    CHECK(0 != flagged);
+    mfield.flag(2, 1);
+    CHECK(flagged != mfield.getStateHash());
+    mfield.unflag(2, 1);
+    CHECK(flagged == mfield.getStateHash());
+    mfield.unflag(1, 1);
+    CHECK(0 == mfield.getStateHash());
+
+    // same visible state -> same hash, regardless of the order of the moves
+    auto other = Minefield(8, 8, 10, 0);
+    mfield.open(0, 4);
+    mfield.flag(0, 5);
+    other.flag(0, 5);
+    other.open(0, 4);
+    CHECK(mfield.getStateHash() == other.getStateHash());
+    other.open(7, 0);
+    CHECK(mfield.getStateHash() != other.getStateHash());
+
+    // chunked and tiled boards w/ the same seed have the same mines
+    auto chunked = Minefield(300, 200, 6000, 5, Minefield::StorageMode::chunked);
+    auto tiled = Minefield::createTiled(300, 200, 6000, 5, 2);
+    chunked.setUndoEnabled(true);
+    std::vector<std::uint64_t> hashes = {chunked.getStateHash()};
+    for (int i = 0; i < 100 && chunked.isGameRunning(); i++) {
+        int x = (i * 7919) % 300;
+        int y = (i * 104729) % 200;
+        if (0 == i % 4) {
+            chunked.tryFlag(x, y);
+            tiled.tryFlag(x, y);
+        } else {
+            chunked.tryOpen(x, y);
+            tiled.tryOpen(x, y);
+        }
+        CHECK(chunked.getStateHash() == tiled.getStateHash());
+        hashes.push_back(chunked.getStateHash());
+    }
+
+    // undo restores the hash of every earlier state
+    std::sort(hashes.begin(), hashes.end());
+    while (chunked.undo()) {
+        CHECK(std::binary_search(hashes.begin(), hashes.end(), chunked.getStateHash()));
+    }
+    CHECK(0 == chunked.getStateHash());
+}
+
 TEST_CASE("Get Mine Count") {
     auto mfield = Minefield(8, 8, 10);
     CHECK(10 == mfield.getMineCount());
@@ -445,3 +1113,539 @@ TEST_CASE("save seed test") {
     mfield = Minefield(10, 100, 10, 1234567890);
     CHECK(1234567890 == mfield.getSeed());
 }
+
+TEST_CASE("Chunked Storage") {
+    // spans several chunks, incl. partial ones at the right and bottom border
+    auto mfield = Minefield(150, 100, 1500, 7, Minefield::StorageMode::chunked);
+    CHECK(mfield.isChunked());
+    CHECK(! Minefield(150, 100, 1500, 7).isChunked());
+    CHECK(150 == mfield.getXDimension());
+    CHECK(100 == mfield.getYDimension());
+    CHECK(1500 == mfield.getMineCount());
+
+    // nothing allocated before the first access
+    CHECK(0 == mfield.getCellMemory());
+
+    // lose a copy of the game, so every field can be queried
+    auto revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % 150, i / 150, false);
+    }
+
+    int mine_count = 0;
+    for (int x = 0; x < 150; x++) {
+        for (int y = 0; y < 100; y++) {
+            if (revealed.isMine(x, y)) {
+                mine_count++;
+            }
+
+            int expected_count = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((0 != dx || 0 != dy) && revealed.isPosValid(x + dx, y + dy) && revealed.isMine(x + dx, y + dy)) {
+                        expected_count++;
+                    }
+                }
+            }
+            CHECK(expected_count == revealed.getSorroundingMineCount(x, y));
+        }
+    }
+    CHECK(1500 == mine_count);
+
+    // same seed -> same board, regardless of the access order
+    auto other = Minefield(150, 100, 1500, 7, Minefield::StorageMode::chunked);
+    other.open(149, 99, false);
+    other.open(0, 0, false);
+    CHECK(revealed.isMine(149, 99) == other.isMine(149, 99));
+    CHECK(revealed.isMine(0, 0) == other.isMine(0, 0));
+}
+
+TEST_CASE("Chunked Storage First Hit No Mine") {
+    auto mfield = Minefield(100, 100, 5000, 3, Minefield::StorageMode::chunked);
+
+    // find a mine at a chunk border
+    auto revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % 100, i / 100, false);
+    }
+    int mine_y = -1;
+    for (int y = 0; y < 100 && -1 == mine_y; y++) {
+        if (revealed.isMine(63, y)) {
+            mine_y = y;
+        }
+    }
+    REQUIRE(-1 != mine_y);
+
+    mfield.open(63, mine_y, false);
+    CHECK(! mfield.isGameLost());
+    CHECK(5000 == mfield.getMineCount());
+
+    // counts are still consistent after moving the mine
+    for (int i = 0; mfield.isGameRunning(); i++) {
+        if (! mfield.isOpen(i % 100, i / 100)) {
+            mfield.open(i % 100, i / 100, false);
+        }
+    }
+
+    int mine_count = 0;
+    for (int x = 0; x < 100; x++) {
+        for (int y = 0; y < 100; y++) {
+            if (mfield.isMine(x, y)) {
+                mine_count++;
+            }
+
+            int expected_count = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((0 != dx || 0 != dy) && mfield.isPosValid(x + dx, y + dy) && mfield.isMine(x + dx, y + dy)) {
+                        expected_count++;
+                    }
+                }
+            }
+            CHECK(expected_count == mfield.getSorroundingMineCount(x, y));
+        }
+    }
+    CHECK(5000 == mine_count);
+}
+
+TEST_CASE("Chunked Storage Open Recursively") {
+    // the opened region crosses chunk borders
+    auto mfield = Minefield(200, 200, 0, 0, Minefield::StorageMode::chunked);
+    mfield.flag(100, 100);
+    mfield.open(10, 10);
+
+    CHECK(mfield.isGameWon());
+    CHECK(200 * 200 == mfield.getOpenCount());
+    CHECK(0 == mfield.getFlagCount());
+}
+
+TEST_CASE("Chunked Storage on huge board") {
+    // 10^12 fields, picked automatically
+    auto mfield = Minefield(1000000, 1000000, 2000000000, 42);
+    CHECK(mfield.isChunked());
+
+    // at this density the region w/o sorrounding mines would span the board, so don't open recursively
+    mfield.open(500000, 500000, false);
+    mfield.flag(999999, 999999);
+    CHECK(mfield.isGameRunning());
+    CHECK(mfield.isOpen(500000, 500000));
+    CHECK(mfield.isFlagged(999999, 999999));
+    CHECK(! mfield.isOpen(0, 0));
+    CHECK(1 == mfield.getOpenCount());
+
+    // 20% mines -> opened regions stay small
+    mfield = Minefield(100000, 100000, 2000000000, 42);
+    CHECK(mfield.isChunked());
+    for (int i = 0; i < 100 && mfield.isGameRunning(); i++) {
+        mfield.open(i * 997, i * 991);
+    }
+
+    // memory is proportional to the accessed area
+    CHECK(mfield.getCellMemory() < 100 * 1024 * 1024);
+}
+
+TEST_CASE("Unbounded Minefield") {
+    CHECK_THROWS(Minefield::createUnbounded(Minefield::MIN_UNBOUNDED_DENSITY - 1));
+    CHECK_THROWS(Minefield::createUnbounded(100));
+
+    auto mfield = Minefield::createUnbounded(20, 5);
+    CHECK(mfield.isUnbounded());
+    CHECK(mfield.isChunked());
+    CHECK(-1 == mfield.getMineCount());
+    CHECK(0 == mfield.getXDimension());
+    CHECK(0 == mfield.getYDimension());
+
+    // negative and far away coordinates are valid
+    CHECK(mfield.isPosValid(-1, -1));
+    CHECK(mfield.isPosValid(-1000000, 1000000));
+    CHECK(! mfield.isPosValid(Minefield::UNBOUNDED_LIMIT, 0));
+    CHECK(! mfield.isPosValid(0, -Minefield::UNBOUNDED_LIMIT));
+
+    // first click is never a mine
+    mfield.open(-1, -1);
+    CHECK(mfield.isGameRunning());
+    CHECK(mfield.isOpen(-1, -1));
+
+    mfield.flag(-1000000, 1000000);
+    CHECK(mfield.isFlagged(-1000000, 1000000));
+    CHECK(1 == mfield.getFlagCount());
+
+    // lose a copy: the game can't be won, it runs until a mine is opened
+    auto revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        CHECK(! revealed.isGameWon());
+        if (! revealed.isOpen(-100 + i, -70)) {
+            revealed.open(-100 + i, -70, false);
+        }
+    }
+    CHECK(revealed.isGameLost());
+
+    // counts are consistent across chunk borders (incl. the ones at 0)
+    for (int x = -70; x < 70; x++) {
+        for (int y = -70; y < 70; y++) {
+            int expected_count = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((0 != dx || 0 != dy) && revealed.isMine(x + dx, y + dy)) {
+                        expected_count++;
+                    }
+                }
+            }
+            CHECK(expected_count == revealed.getSorroundingMineCount(x, y));
+        }
+    }
+}
+
+TEST_CASE("Chunk Eviction") {
+    auto mfield = Minefield::createUnbounded(20, 11);
+    mfield.setChunkLimit(8);
+    auto reference = Minefield::createUnbounded(20, 11);
+
+    // lost game w/ the same first click: tells where the mines are
+    auto oracle = Minefield::createUnbounded(20, 11);
+    oracle.open(2, 1, false);
+    for (int i = 0; oracle.isGameRunning(); i++) {
+        oracle.open(i, -1000, false);
+    }
+
+    // explore a line of chunks, far longer than the limit
+    std::vector<int> opened_x;
+    for (int i = 0; i < 40; i++) {
+        int x = i * ChunkedStorage::CHUNK_SIZE;
+        int safe_x = x + 2;
+        while (oracle.isMine(safe_x, 1)) {
+            safe_x++;
+        }
+        opened_x.push_back(safe_x);
+        mfield.flag(x, 1);
+        mfield.open(safe_x, 1, false);
+        reference.flag(x, 1);
+        reference.open(safe_x, 1, false);
+    }
+    REQUIRE(mfield.isGameRunning());
+    CHECK(0 < mfield.getEvictedChunkCount());
+    CHECK(0 == reference.getEvictedChunkCount());
+    CHECK(mfield.getCellMemory() < reference.getCellMemory());
+
+    // evicted chunks are loaded back w/ the same state
+    for (int i = 0; i < 40; i++) {
+        int x = i * ChunkedStorage::CHUNK_SIZE;
+        CHECK(mfield.isFlagged(x, 1));
+        CHECK(mfield.isOpen(opened_x[i], 1));
+        CHECK(reference.isOpen(opened_x[i] + 1, 1) == mfield.isOpen(opened_x[i] + 1, 1));
+        CHECK(reference.getSorroundingMineCount(opened_x[i], 1) == mfield.getSorroundingMineCount(opened_x[i], 1));
+    }
+
+    // copies load everything back into memory
+    auto copy = mfield;
+    CHECK(0 == copy.getEvictedChunkCount());
+    CHECK(copy.isFlagged(0, 1));
+    CHECK(copy.isOpen(2, 1));
+    CHECK(copy.isFlagged(39 * ChunkedStorage::CHUNK_SIZE, 1));
+}
+
+TEST_CASE("Fixed Boards") {
+    CHECK_THROWS(Minefield(10, 10, 10, 0, Minefield::StorageMode::fixed));
+    CHECK_NOTHROW(Minefield(9, 9, 10, 0, Minefield::StorageMode::fixed));
+
+    // fixed and generic path generate the same boards
+    std::vector<std::tuple<int, int, int>> sizes = {std::make_tuple(9, 9, 10), std::make_tuple(16, 16, 40), std::make_tuple(30, 16, 99), std::make_tuple(30, 16, 400)};
+    for (auto& size : sizes) {
+        int width, height, mine_count;
+        std::tie(width, height, mine_count) = size;
+
+        for (int seed = 0; seed < 20; seed++) {
+            auto fixed = Minefield(width, height, mine_count, seed, Minefield::StorageMode::fixed);
+            auto dense = Minefield(width, height, mine_count, seed, Minefield::StorageMode::dense);
+
+            // lose both games w/ the same clicks
+            for (int i = 0; fixed.isGameRunning(); i++) {
+                fixed.open(i % width, i / width, false);
+                dense.open(i % width, i / width, false);
+            }
+            REQUIRE(dense.isGameEnded());
+
+            for (int x = 0; x < width; x++) {
+                for (int y = 0; y < height; y++) {
+                    CHECK(dense.isMine(x, y) == fixed.isMine(x, y));
+                    CHECK(dense.getSorroundingMineCount(x, y) == fixed.getSorroundingMineCount(x, y));
+                }
+            }
+        }
+    }
+
+    // word parallel counts match counting the neighbours one by one
+    FixedBoard<30, 16> board;
+    std::mt19937 rdm_num_machine(3);
+    board.generate(200, rdm_num_machine);
+    for (int x = 0; x < 30; x++) {
+        for (int y = 0; y < 16; y++) {
+            CHECK(board.countNeighbours(x, y) == getGroupCount(&board.words[y * PLANE_COUNT], x));
+        }
+    }
+    CHECK(0 == (board.words[COUNT_PLANE_0] & ~FixedBoard<30, 16>::ROW_MASK));
+}
+
+TEST_CASE("64 bit counts and seeds") {
+    // 10^10 fields, 3*10^9 mines: both above 2^31
+    const std::int64_t mine_count = 3000000000LL;
+    const std::int64_t seed = std::int64_t(1) << 40;
+    auto mfield = Minefield(100000, 100000, mine_count, seed);
+    CHECK(mfield.isChunked());
+    CHECK(mine_count == mfield.getMineCount());
+    CHECK(seed == mfield.getSeed());
+
+    mfield.open(99999, 99999, false);
+    mfield.flag(0, 0);
+    CHECK(1 == mfield.getOpenCount());
+    CHECK(1 == mfield.getFlagCount());
+    CHECK(mfield.isGameRunning());
+
+    // the chunk shares add up to the exact mine count
+    ChunkedStorage storage(100000, 100000, mine_count, seed);
+    std::int64_t chunk_mines = 0;
+    int chunks = (100000 + ChunkedStorage::CHUNK_SIZE - 1) / ChunkedStorage::CHUNK_SIZE;
+    for (int chunk_x = 0; chunk_x < chunks; chunk_x++) {
+        for (int chunk_y = 0; chunk_y < chunks; chunk_y++) {
+            chunk_mines += storage.getChunkMineCount(chunk_x, chunk_y);
+        }
+    }
+    CHECK(mine_count == chunk_mines);
+
+    // dense storage can't hold that many fields
+    CHECK_THROWS(Minefield(100000, 100000, 10, 0, Minefield::StorageMode::dense));
+
+    // the upper bits of the seed matter, seeds in the int range still give the old boards
+    auto lost = [](Minefield mfield) {
+        for (int i = 0; mfield.isGameRunning(); i++) {
+            mfield.open(i % mfield.getXDimension(), i / mfield.getXDimension(), false);
+        }
+        std::vector<bool> mines;
+        for (int x = 0; x < mfield.getXDimension(); x++) {
+            for (int y = 0; y < mfield.getYDimension(); y++) {
+                mines.push_back(mfield.isMine(x, y));
+            }
+        }
+        return mines;
+    };
+    CHECK(lost(Minefield(20, 20, 80, seed)) == lost(Minefield(20, 20, 80, seed)));
+    CHECK(lost(Minefield(20, 20, 80, seed)) != lost(Minefield(20, 20, 80, seed + 1)));
+    CHECK(lost(Minefield(20, 20, 80, seed)) != lost(Minefield(20, 20, 80, 0)));
+    CHECK(lost(Minefield(9, 9, 10, seed, Minefield::StorageMode::fixed)) == lost(Minefield(9, 9, 10, seed, Minefield::StorageMode::dense)));
+}
+
+TEST_CASE("Placement Version") {
+    // pins the layouts of PLACEMENT_VERSION 2: if this fails, increase the version and document it in doc/placement.md
+    REQUIRE(2 == PLACEMENT_VERSION);
+
+    auto mines = [](Minefield mfield) {
+        for (int i = 0; mfield.isGameRunning(); i++) {
+            mfield.open(i % mfield.getXDimension(), i / mfield.getXDimension(), false);
+        }
+        std::string layout = "";
+        for (int y = 0; y < mfield.getYDimension(); y++) {
+            for (int x = 0; x < mfield.getXDimension(); x++) {
+                layout += mfield.isMine(x, y) ? 'X' : '.';
+            }
+        }
+        return layout;
+    };
+
+    // sparse: unchanged since version 1
+    CHECK(mines(Minefield(8, 4, 5, 42)) == "........X..X............XX....X.");
+    // dense: complement sampling
+    CHECK(mines(Minefield(8, 4, 27, 42)) == ".XXXXXXX.XX.XXXXXXXXXXXX.XXXXX.X");
+
+    // the fixed boards follow the same mapping
+    CHECK(mines(Minefield(9, 9, 70, 7, Minefield::StorageMode::fixed)) == mines(Minefield(9, 9, 70, 7, Minefield::StorageMode::dense)));
+}
+
+TEST_CASE("Mine Placement") {
+    std::mt19937 sparse_machine(3);
+    MinePlacement sparse = placeMines(1600, 50, sparse_machine);
+    CHECK(! sparse.complement);
+    REQUIRE(50 == sparse.positions.size());
+
+    // many picks -> the entire list is stored, but the picks are the same: the first 50 are equal
+    std::mt19937 list_machine(3);
+    MinePlacement list = placeMines(1600, 200, list_machine);
+    CHECK(! list.complement);
+    REQUIRE(200 == list.positions.size());
+    CHECK(std::equal(sparse.positions.begin(), sparse.positions.end(), list.positions.begin()));
+
+    std::sort(list.positions.begin(), list.positions.end());
+    CHECK(list.positions.end() == std::adjacent_find(list.positions.begin(), list.positions.end()));
+    CHECK(0 <= list.positions.front());
+    CHECK(list.positions.back() < 1600);
+
+    // more mines than free fields -> the free fields are picked
+    std::mt19937 complement_machine(3);
+    MinePlacement complement = placeMines(1600, 1550, complement_machine);
+    CHECK(complement.complement);
+    CHECK(sparse.positions == complement.positions);
+}
+
+TEST_CASE("Tiled Storage") {
+    auto mines = [](Minefield mfield) {
+        for (int i = 0; mfield.isGameRunning(); i++) {
+            mfield.open(i % mfield.getXDimension(), i / mfield.getXDimension(), false);
+        }
+        std::vector<int> cells;
+        for (int y = 0; y < mfield.getYDimension(); y++) {
+            for (int x = 0; x < mfield.getXDimension(); x++) {
+                cells.push_back(mfield.isMine(x, y) ? -1 : mfield.getSorroundingMineCount(x, y));
+            }
+        }
+        return cells;
+    };
+
+    // partial tiles at the right and bottom border
+    auto tiled = Minefield(150, 200, 6000, 11, Minefield::StorageMode::tiled);
+    CHECK(! tiled.isChunked());
+    CHECK(6000 == tiled.getMineCount());
+    auto expected = mines(tiled);
+    CHECK(6000 == std::count(expected.begin(), expected.end(), -1));
+
+    // same board as the chunked storage, regardless of the amount of threads
+    CHECK(expected == mines(Minefield(150, 200, 6000, 11, Minefield::StorageMode::chunked)));
+    for (int thread_count : {1, 2, 3, 4, 8}) {
+        CHECK(expected == mines(Minefield::createTiled(150, 200, 6000, 11, thread_count)));
+    }
+
+    // the counts match the ones of the dense storage
+    auto revealed = Minefield::createTiled(150, 200, 6000, 11, 3);
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % 150, i / 150, false);
+    }
+    for (int x = 0; x < 150; x++) {
+        for (int y = 0; y < 200; y++) {
+            int expected_count = 0;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((0 != dx || 0 != dy) && revealed.isPosValid(x + dx, y + dy) && revealed.isMine(x + dx, y + dy)) {
+                        expected_count++;
+                    }
+                }
+            }
+            CHECK(expected_count == revealed.getSorroundingMineCount(x, y));
+        }
+    }
+
+    CHECK_THROWS(Minefield::createTiled(10, 10, 101, 0, 2));
+    CHECK_THROWS(Minefield::createTiled(0, 10, 0, 0, 2));
+}
+
+TEST_CASE("Neighbour Count Kernels") {
+    CHECK(isNeighbourKernelAvailable(NeighbourKernel::scalar));
+    CHECK(isNeighbourKernelAvailable(getDefaultNeighbourKernel()));
+
+    std::mt19937 rdm_num_machine(5);
+    for (int width : {1, 3, 63, 64, 65, 200, 257, 300}) {
+        for (int height : {1, 2, 7}) {
+            int words_per_row = (width + 63) / 64;
+
+            // mask w/ a stride of 2 (like an arbitrary plane), random bits incl. the padding right of the board
+            std::vector<std::uint64_t> mask(words_per_row * height * 2);
+            for (auto& word : mask) {
+                word = (static_cast<std::uint64_t>(rdm_num_machine()) << 32) | rdm_num_machine();
+            }
+            auto isSet = [&](int x, int y) {
+                return 0 <= x && x < width && 0 <= y && y < height && ((mask[(y * words_per_row + x / 64) * 2] >> (x % 64)) & 1);
+            };
+
+            for (NeighbourKernel kernel : {NeighbourKernel::scalar, NeighbourKernel::avx2}) {
+                std::vector<std::uint64_t> counts(words_per_row * height * 5, ~std::uint64_t(0));
+                countNeighbourPlanes(mask.data(), 2, counts.data(), 5, width, height, kernel);
+
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) {
+                        int expected = 0;
+                        for (int dx = -1; dx <= 1; dx++) {
+                            for (int dy = -1; dy <= 1; dy++) {
+                                if ((0 != dx || 0 != dy) && isSet(x + dx, y + dy)) {
+                                    expected++;
+                                }
+                            }
+                        }
+
+                        const std::uint64_t* group = &counts[(y * words_per_row + x / 64) * 5];
+                        int count = 0;
+                        for (int k = 0; k < 4; k++) {
+                            count |= ((group[k] >> (x % 64)) & 1) << k;
+                        }
+                        CHECK(expected == count);
+                    }
+
+                    // padding stays empty, the word after the counts is untouched
+                    const std::uint64_t* last = &counts[(y * words_per_row + words_per_row - 1) * 5];
+                    if (0 != width % 64) {
+                        CHECK(0 == (last[0] >> (width % 64)));
+                    }
+                    CHECK(~std::uint64_t(0) == last[4]);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Bitwise Expansion") {
+    CHECK(! Minefield(8, 8, 10, 0).usesBitwiseExpansion());
+    CHECK(Minefield(100, 100, 10, 0).usesBitwiseExpansion());
+    CHECK(! Minefield(100, 100, 10, 0, Minefield::StorageMode::chunked).usesBitwiseExpansion());
+
+    // both engines open the same fields, remove the same flags and report the same changes
+    for (int width : {5, 64, 65, 130, 200}) {
+        for (int seed = 0; seed < 8; seed++) {
+            int height = 20 + seed * 7;
+            auto scanline = Minefield(width, height, (width * height) / 12, seed);
+            scanline.setChangeTrackingEnabled(true);
+            auto bitwise = scanline;
+            scanline.setExpansionEngine(Minefield::ExpansionEngine::scanline);
+            bitwise.setExpansionEngine(Minefield::ExpansionEngine::bitwise);
+            CHECK(bitwise.usesBitwiseExpansion());
+
+            for (int i = 0; i < 40; i++) {
+                int x = (i * 7919 + seed) % width;
+                int y = (i * 104729) % height;
+                if (! scanline.isGameRunning()) {
+                    break;
+                }
+                if (0 == i % 5 && ! scanline.isOpen(x, y)) {
+                    scanline.flag(x, y);
+                    bitwise.flag(x, y);
+                } else if (! scanline.isFlagged(x, y) && ! scanline.isOpen(x, y)) {
+                    scanline.open(x, y);
+                    bitwise.open(x, y);
+                }
+
+                std::vector<std::tuple<int, int>> scanline_changed, bitwise_changed;
+                scanline.drainChangedCells(scanline_changed);
+                bitwise.drainChangedCells(bitwise_changed);
+                std::sort(scanline_changed.begin(), scanline_changed.end());
+                std::sort(bitwise_changed.begin(), bitwise_changed.end());
+                CHECK(scanline_changed == bitwise_changed);
+
+                CHECK(scanline.getOpenCount() == bitwise.getOpenCount());
+                CHECK(scanline.getFlagCount() == bitwise.getFlagCount());
+                CHECK(scanline.isGameRunning() == bitwise.isGameRunning());
+                CHECK(scanline.getStateHash() == bitwise.getStateHash());
+            }
+
+            for (int x = 0; x < width; x++) {
+                for (int y = 0; y < height; y++) {
+                    CHECK(scanline.isOpen(x, y) == bitwise.isOpen(x, y));
+                    CHECK(scanline.isFlagged(x, y) == bitwise.isFlagged(x, y));
+                }
+            }
+        }
+    }
+
+    // region across the whole board, around a flag
+    auto mfield = Minefield(1000, 1000, 0, 0);
+    mfield.setExpansionEngine(Minefield::ExpansionEngine::bitwise);
+    mfield.flag(500, 500);
+    mfield.open(999, 0);
+    CHECK(mfield.isGameWon());
+    CHECK(1000 * 1000 == mfield.getOpenCount());
+    CHECK(0 == mfield.getFlagCount());
+}
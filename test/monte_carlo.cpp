@@ -0,0 +1,147 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "monte_carlo.hpp"
+#include "probability.hpp"
+#include "solver.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+TEST_CASE("Matches Exact Probabilities") {
+    for (int seed = 0; seed < 10; seed++) {
+        auto mfield = Minefield(30, 16, 99, seed);
+        mfield.open(15, 8);
+        if (! mfield.isGameRunning()) {
+            continue;
+        }
+
+        ProbabilityEngine engine;
+        engine.calculate(mfield);
+        MonteCarloEstimator estimator;
+        estimator.setThreadCount(1);
+        estimator.setTimeBudget(0);
+        estimator.setSampleLimit(20000);
+        estimator.estimate(mfield);
+        CHECK(0 < estimator.getSampleCount());
+        CHECK(20000 == estimator.getSampleCount() + estimator.getRejectedCount());
+
+        // the fields share their samples, so a 95% interval may miss together w/ its neighbours: allow a small slack
+        std::vector<std::tuple<int, int>> fields;
+        engine.getFrontier(fields);
+        double error = 0;
+        for (auto& field : fields) {
+            double exact = engine.getProbability(std::get<0>(field), std::get<1>(field));
+            auto estimate = estimator.getEstimate(std::get<0>(field), std::get<1>(field));
+            CHECK(estimate.lower <= estimate.probability);
+            CHECK(estimate.probability <= estimate.upper);
+            CHECK(estimate.lower - 0.01 <= exact);
+            CHECK(exact <= estimate.upper + 0.01);
+            error += std::abs(estimate.probability - exact);
+        }
+        CHECK(error / fields.size() < 0.01);
+        CHECK(estimator.getInteriorEstimate().probability == doctest::Approx(engine.getInteriorProbability()).epsilon(0.05));
+        CHECK(0 == estimator.getEstimate(15, 8).probability);
+    }
+}
+
+TEST_CASE("Forced Fields are Exact") {
+    auto mfield = Minefield(30, 16, 99, 3);
+    mfield.open(15, 8);
+    Solver solver;
+    solver.reset(mfield);
+    MonteCarloEstimator estimator;
+    estimator.setThreadCount(2);
+    estimator.setTimeBudget(0);
+    estimator.setSampleLimit(2000);
+    estimator.estimate(mfield);
+
+    // every consistent sample agrees on them
+    std::vector<std::tuple<int, int>> fields;
+    solver.getSafeFields(fields);
+    for (auto& field : fields) {
+        auto estimate = estimator.getEstimate(std::get<0>(field), std::get<1>(field));
+        CHECK(0 == estimate.probability);
+        CHECK(0 == estimate.upper);
+    }
+    solver.getMines(fields);
+    for (auto& field : fields) {
+        CHECK(1 == estimator.getEstimate(std::get<0>(field), std::get<1>(field)).lower);
+    }
+}
+
+TEST_CASE("Deterministic w/ Single Thread") {
+    auto mfield = Minefield(30, 16, 99, 1);
+    mfield.open(15, 8);
+    MonteCarloEstimator first, second;
+    for (auto estimator : {&first, &second}) {
+        estimator->setThreadCount(1);
+        estimator->setTimeBudget(0);
+        estimator->setSampleLimit(500);
+        estimator->setSeed(42);
+        estimator->estimate(mfield);
+    }
+    for (int x = 0; x < 30; x++) {
+        for (int y = 0; y < 16; y++) {
+            CHECK(first.getEstimate(x, y).probability == second.getEstimate(x, y).probability);
+        }
+    }
+    CHECK(first.getEffectiveSampleSize() <= first.getSampleCount());
+}
+
+TEST_CASE("Time Budget") {
+    // a giant board: the budget bounds the time, not the amount of samples
+    auto mfield = Minefield(1000, 1000, 150000, 0);
+    for (int i = 0; i < 200; i++) {
+        auto copy = mfield;
+        copy.open((i * 7919) % 1000, (i * 104729 / 1000) % 1000);
+        if (copy.isGameRunning()) {
+            mfield = copy;
+        }
+    }
+
+    MonteCarloEstimator estimator;
+    estimator.setThreadCount(2);
+    estimator.setTimeBudget(50);
+    auto start = std::chrono::steady_clock::now();
+    estimator.estimate(mfield);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // (reading the board and a sample in flight come on top of the budget)
+    CHECK(ms < 2000);
+    auto interior = estimator.getInteriorEstimate();
+    CHECK(interior.lower <= interior.probability);
+    CHECK(interior.probability <= interior.upper);
+}
+
+TEST_CASE("Cancel") {
+    auto mfield = Minefield(30, 16, 99, 2);
+    mfield.open(15, 8);
+    MonteCarloEstimator estimator;
+    estimator.setTimeBudget(60000);
+    estimator.setCancelCheck([]() {
+        return true;
+    });
+    auto start = std::chrono::steady_clock::now();
+    estimator.estimate(mfield);
+    CHECK(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < 2000);
+    CHECK(0 == estimator.getSampleCount());
+}
+
+TEST_CASE("Unbounded and Ended Games") {
+    MonteCarloEstimator estimator;
+    CHECK_THROWS_AS(estimator.estimate(Minefield::createUnbounded(20)), std::runtime_error);
+
+    estimator.setTimeBudget(0);
+    estimator.setSampleLimit(0);
+    CHECK_THROWS_AS(estimator.estimate(Minefield(8, 8, 10, 0)), std::runtime_error);
+
+    estimator.setSampleLimit(10);
+    auto mfield = Minefield(3, 3, 8, 0);
+    mfield.open(1, 1);
+    estimator.estimate(mfield);
+    CHECK(0 == estimator.getEstimate(0, 0).probability);
+    CHECK(0 == estimator.getSampleCount());
+}
@@ -0,0 +1,229 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "probability.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+/**
+ * Calculates the mine probabilities by trying every layout of the mines on the closed fields.
+ * @param mfield small minefield w/ a running game
+ * @return probability per closed field
+ */
+static std::map<std::tuple<int, int>, double> bruteForce(const Minefield& mfield) {
+    std::vector<std::tuple<int, int>> closed;
+    for (int x = 0; x < mfield.getXDimension(); x++) {
+        for (int y = 0; y < mfield.getYDimension(); y++) {
+            if (! mfield.isOpen(x, y)) {
+                closed.push_back(std::make_tuple(x, y));
+            }
+        }
+    }
+
+    // layouts are masks over closed: the first mine_count entries are set in the first permutation
+    std::vector<bool> layout(closed.size(), false);
+    std::fill(layout.begin(), layout.begin() + mfield.getMineCount(), true);
+    std::vector<double> mines(closed.size(), 0);
+    double layouts = 0;
+    do {
+        bool valid = true;
+        for (int x = 0; x < mfield.getXDimension() && valid; x++) {
+            for (int y = 0; y < mfield.getYDimension() && valid; y++) {
+                if (! mfield.isOpen(x, y)) {
+                    continue;
+                }
+                int count = 0;
+                for (std::size_t i = 0; i < closed.size(); i++) {
+                    int dx = std::get<0>(closed[i]) - x;
+                    int dy = std::get<1>(closed[i]) - y;
+                    if (layout[i] && -1 <= dx && dx <= 1 && -1 <= dy && dy <= 1) {
+                        count++;
+                    }
+                }
+                valid = count == mfield.getSorroundingMineCount(x, y);
+            }
+        }
+        if (valid) {
+            layouts++;
+            for (std::size_t i = 0; i < closed.size(); i++) {
+                mines[i] += layout[i] ? 1 : 0;
+            }
+        }
+    } while (std::prev_permutation(layout.begin(), layout.end()));
+
+    std::map<std::tuple<int, int>, double> probabilities;
+    for (std::size_t i = 0; i < closed.size(); i++) {
+        probabilities[closed[i]] = mines[i] / layouts;
+    }
+    return probabilities;
+}
+
+TEST_CASE("Matches Brute Force") {
+    // 5x5 w/ 5 mines: at most C(24, 5) layouts
+    int checked = 0;
+    for (int seed = 0; seed < 30; seed++) {
+        auto mfield = Minefield(5, 5, 5, seed);
+        mfield.open(0, 0);
+        if (! mfield.isGameRunning()) {
+            continue;
+        }
+
+        ProbabilityEngine engine;
+        engine.calculate(mfield);
+        for (auto& expected : bruteForce(mfield)) {
+            int x, y;
+            std::tie(x, y) = expected.first;
+            CHECK(engine.getProbability(x, y) == doctest::Approx(expected.second).epsilon(1e-9));
+        }
+        checked++;
+
+        // open fields are never mines
+        CHECK(0 == engine.getProbability(0, 0));
+    }
+    CHECK(0 < checked);
+}
+
+TEST_CASE("Several Components") {
+    // two opened corners on a larger board: independent frontiers, linked only by the amount of mines
+    int checked = 0;
+    for (int seed = 0; seed < 20; seed++) {
+        auto mfield = Minefield(6, 4, 4, seed);
+        mfield.open(0, 0);
+        if (! mfield.isGameRunning() || mfield.isOpen(5, 3)) {
+            continue;
+        }
+        auto copy = mfield;
+        copy.open(5, 3, false);
+        if (! copy.isGameRunning()) {
+            continue;
+        }
+        mfield = copy;
+
+        ProbabilityEngine engine;
+        engine.calculate(mfield);
+        for (auto& expected : bruteForce(mfield)) {
+            int x, y;
+            std::tie(x, y) = expected.first;
+            CHECK(engine.getProbability(x, y) == doctest::Approx(expected.second).epsilon(1e-9));
+        }
+        if (1 < engine.getComponentStats().size()) {
+            checked++;
+        }
+    }
+    CHECK(0 < checked);
+}
+
+TEST_CASE("Agrees w/ Solver") {
+    for (int seed = 0; seed < 10; seed++) {
+        auto mfield = Minefield(30, 16, 99, seed);
+        mfield.open(15, 8);
+        if (! mfield.isGameRunning()) {
+            continue;
+        }
+
+        Solver solver;
+        solver.reset(mfield);
+        ProbabilityEngine engine;
+        engine.calculate(mfield);
+
+        std::vector<std::tuple<int, int>> fields;
+        solver.getSafeFields(fields);
+        for (auto& field : fields) {
+            CHECK(engine.getProbability(std::get<0>(field), std::get<1>(field)) == doctest::Approx(0));
+        }
+        solver.getMines(fields);
+        for (auto& field : fields) {
+            CHECK(engine.getProbability(std::get<0>(field), std::get<1>(field)) == doctest::Approx(1));
+        }
+
+        // all mines are somewhere
+        double expected_mines = engine.getInteriorProbability() * static_cast<double>(engine.getInteriorCount());
+        engine.getFrontier(fields);
+        for (auto& field : fields) {
+            expected_mines += engine.getProbability(std::get<0>(field), std::get<1>(field));
+        }
+        CHECK(expected_mines == doctest::Approx(99));
+    }
+}
+
+TEST_CASE("Thread Count") {
+    auto mfield = Minefield(100, 100, 1500, 4);
+    for (int x = 0; x < 100; x += 10) {
+        for (int y = 0; y < 100; y += 10) {
+            auto copy = mfield;
+            copy.open(x, y);
+            if (copy.isGameRunning()) {
+                mfield = copy;
+            }
+        }
+    }
+
+    ProbabilityEngine single, parallel;
+    single.setThreadCount(1);
+    parallel.setThreadCount(4);
+    single.calculate(mfield);
+    parallel.calculate(mfield);
+    CHECK(1 < single.getComponentStats().size());
+    CHECK(single.getComponentStats().size() == parallel.getComponentStats().size());
+    for (int x = 0; x < 100; x++) {
+        for (int y = 0; y < 100; y++) {
+            CHECK(single.getProbability(x, y) == parallel.getProbability(x, y));
+        }
+    }
+
+    // largest component first
+    auto& stats = single.getComponentStats();
+    for (std::size_t i = 1; i < stats.size(); i++) {
+        CHECK(stats[i].field_count <= stats[i - 1].field_count);
+    }
+}
+
+TEST_CASE("State Limit") {
+    auto mfield = Minefield(30, 16, 99, 2);
+    mfield.open(15, 8);
+    ProbabilityEngine engine;
+    engine.setStateLimit(1);
+    CHECK(! engine.calculate(mfield));
+    CHECK(0 == engine.getProbability(0, 0));
+    CHECK(0 < engine.getComponentStats().size());
+
+    engine.setStateLimit(0);
+    CHECK(engine.calculate(mfield));
+}
+
+TEST_CASE("Cancel") {
+    auto mfield = Minefield(30, 16, 99, 2);
+    mfield.open(15, 8);
+    ProbabilityEngine engine;
+    std::atomic<int> checks(0);
+    engine.setCancelCheck([&checks]() {
+        return 3 <= ++checks;
+    });
+    CHECK(! engine.calculate(mfield));
+    CHECK(0 == engine.getProbability(0, 0));
+    CHECK(0 == engine.getInteriorCount());
+
+    engine.setCancelCheck([]() {
+        return false;
+    });
+    CHECK(engine.calculate(mfield));
+    engine.setCancelCheck(nullptr);
+    CHECK(engine.calculate(mfield));
+}
+
+TEST_CASE("Unbounded and Ended Games") {
+    ProbabilityEngine engine;
+    CHECK_THROWS_AS(engine.calculate(Minefield::createUnbounded(20)), std::runtime_error);
+
+    auto mfield = Minefield(3, 3, 8, 0);
+    mfield.open(1, 1);
+    engine.calculate(mfield);
+    CHECK(0 == engine.getProbability(0, 0));
+    CHECK(0 == engine.getComponentStats().size());
+}
@@ -0,0 +1,97 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "controller.hpp"
+#include "simulation.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+static const std::vector<Simulation::Config> CONFIGS = {{9, 9, 10}, {16, 16, 40}, {30, 16, 99}};
+
+TEST_CASE("Independent of Threads") {
+    for (auto& name : Bot::getNames()) {
+        Simulation single, parallel;
+        for (auto simulation : {&single, &parallel}) {
+            simulation->setBot(name);
+            simulation->setGameCount(name == "probability" ? 40 : 200);
+            simulation->setSeed(7);
+            simulation->setLossLimit(5);
+        }
+        single.setThreadCount(1);
+        parallel.setThreadCount(3);
+        single.run(CONFIGS);
+        parallel.run(CONFIGS);
+
+        for (std::size_t i = 0; i < CONFIGS.size(); i++) {
+            auto& expected = single.getStats()[i];
+            auto& actual = parallel.getStats()[i];
+            CHECK(expected.games == actual.games);
+            CHECK(expected.wins == actual.wins);
+            CHECK(expected.moves == actual.moves);
+            CHECK(expected.guesses == actual.guesses);
+            CHECK(expected.wins_without_guess == actual.wins_without_guess);
+            CHECK(expected.losses == actual.losses);
+        }
+    }
+}
+
+TEST_CASE("Games can be Replayed") {
+    Simulation simulation;
+    simulation.setSeed(100);
+    simulation.setGameCount(50);
+    simulation.setLossLimit(3);
+    simulation.run(CONFIGS);
+
+    auto bot = Bot::create("solver");
+    for (std::size_t i = 0; i < CONFIGS.size(); i++) {
+        auto& config = CONFIGS[i];
+        auto& stats = simulation.getStats()[i];
+        CHECK(50 == stats.games);
+        REQUIRE(0 < stats.losses.size());
+        CHECK(stats.losses.size() <= 3);
+        for (auto game : stats.losses) {
+            CHECK(! Simulation::playGame(*bot, config, simulation.getSeed(game)).won);
+        }
+
+        // tmines creates the same board for the seed: the same fields are revealed by opening the center
+        std::int64_t seed = simulation.getSeed(stats.losses.front());
+        Controller controller(config.width, config.height, config.mine_count, seed);
+        controller.putCursor((config.width - 1) / 2, (config.height - 1) / 2);
+        controller.click();
+        Minefield mfield(config.width, config.height, config.mine_count, seed);
+        mfield.open((config.width - 1) / 2, (config.height - 1) / 2);
+        for (int x = 0; x < config.width; x++) {
+            for (int y = 0; y < config.height; y++) {
+                REQUIRE(controller.getMinefield().isOpen(x, y) == mfield.isOpen(x, y));
+                if (mfield.isOpen(x, y)) {
+                    CHECK(controller.getMinefield().getSorroundingMineCount(x, y) == mfield.getSorroundingMineCount(x, y));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Bots") {
+    std::vector<Simulation::Stats> stats;
+    for (auto& name : {"random", "solver", "probability"}) {
+        Simulation simulation;
+        simulation.setBot(name);
+        simulation.setGameCount(100);
+        simulation.run({{9, 9, 10}});
+        stats.push_back(simulation.getStats()[0]);
+        CHECK(stats.back().wins_without_guess <= stats.back().wins);
+    }
+
+    // every move but the first is a guess for the random bot
+    CHECK(stats[0].guesses == stats[0].moves - stats[0].games);
+    CHECK(stats[0].wins < stats[1].wins);
+    CHECK(50 < stats[1].wins);
+    // guessing the least likely field wins at least as often (give or take some luck)
+    CHECK(stats[1].wins - 10 < stats[2].wins);
+
+    CHECK_THROWS_AS(Bot::create("cheater"), std::runtime_error);
+    Simulation simulation;
+    CHECK_THROWS_AS(simulation.setBot("cheater"), std::runtime_error);
+    CHECK_THROWS_AS(simulation.run({{3, 3, 9}}), std::runtime_error);
+}
@@ -0,0 +1,147 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "solver.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+/**
+ * Loses a copy of the given minefield, so every field can be queried w/ isMine().
+ * @param mfield minefield w/ at least one open field
+ * @return lost copy
+ */
+static Minefield reveal(const Minefield& mfield) {
+    auto revealed = mfield;
+    for (int i = 0; revealed.isGameRunning(); i++) {
+        revealed.open(i % revealed.getXDimension(), i / revealed.getXDimension(), false);
+    }
+    return revealed;
+}
+
+TEST_CASE("Single Field Rule") {
+    // 3x1, one mine: after opening a corner w/ count 1, the middle is the mine... or the corner w/ count 0 opens everything
+    auto mfield = Minefield(3, 3, 8, 0);
+    mfield.open(1, 1);
+    Solver solver;
+    solver.reset(mfield);
+
+    // the game is won, nothing left to find
+    std::vector<std::tuple<int, int>> fields;
+    solver.getSafeFields(fields);
+    CHECK(fields.empty());
+
+    // 4x4 w/ 14 mines: two free fields, the first one opened
+    mfield = Minefield(4, 4, 14, 3);
+    mfield.open(0, 0);
+    auto revealed = reveal(mfield);
+    solver.reset(mfield);
+    solver.getMines(fields);
+    // a corner w/ count n among its 3 closed neighbours: 3 mines are obvious, otherwise nothing follows from a single field
+    for (auto& field : fields) {
+        CHECK(revealed.isMine(std::get<0>(field), std::get<1>(field)));
+    }
+    if (3 == mfield.getSorroundingMineCount(0, 0)) {
+        CHECK(3 == fields.size());
+    }
+}
+
+TEST_CASE("Deductions are correct") {
+    for (int seed = 0; seed < 20; seed++) {
+        auto mfield = Minefield(30, 16, 99, seed);
+        mfield.setUndoEnabled(true);
+        mfield.setChangeTrackingEnabled(true);
+        mfield.open(15, 8);
+        auto revealed = reveal(mfield);
+
+        Solver solver;
+        std::vector<std::tuple<int, int>> changed, safe_fields, mines;
+        mfield.drainChangedCells(changed);
+        solver.update(mfield, changed);
+
+        // open everything the solver finds, one by one (incremental)
+        int deduced = 0;
+        solver.getSafeFields(safe_fields);
+        while (! safe_fields.empty() && mfield.isGameRunning()) {
+            int x, y;
+            std::tie(x, y) = safe_fields.front();
+            CHECK(! revealed.isMine(x, y));
+            mfield.open(x, y);
+            deduced++;
+
+            mfield.drainChangedCells(changed);
+            solver.update(mfield, changed);
+            solver.getSafeFields(safe_fields);
+        }
+        CHECK(! mfield.isGameLost());
+
+        solver.getMines(mines);
+        for (auto& mine : mines) {
+            CHECK(revealed.isMine(std::get<0>(mine), std::get<1>(mine)));
+        }
+
+        // same result as looking at the entire board
+        Solver full;
+        full.reset(mfield);
+        std::vector<std::tuple<int, int>> full_safe_fields, full_mines;
+        full.getSafeFields(full_safe_fields);
+        full.getMines(full_mines);
+        std::sort(mines.begin(), mines.end());
+        std::sort(full_mines.begin(), full_mines.end());
+        CHECK(full_safe_fields.empty());
+        CHECK(mines == full_mines);
+
+        // undoing everything forgets everything
+        while (mfield.undo()) {
+        }
+        mfield.drainChangedCells(changed);
+        solver.update(mfield, changed);
+        solver.getMines(mines);
+        CHECK(mines.empty());
+    }
+}
+
+TEST_CASE("Subset Rule") {
+    // a game solved further than w/ the single field rule alone
+    int subset_only = 0;
+    for (int seed = 0; seed < 20; seed++) {
+        auto mfield = Minefield(16, 16, 40, seed);
+        mfield.open(8, 8);
+        auto revealed = reveal(mfield);
+
+        Solver solver;
+        std::vector<std::tuple<int, int>> safe_fields;
+        solver.reset(mfield);
+        solver.getSafeFields(safe_fields);
+        for (auto& field : safe_fields) {
+            CHECK(! revealed.isMine(std::get<0>(field), std::get<1>(field)));
+        }
+
+        // a safe field whose neighbours don't decide it on their own
+        for (auto& field : safe_fields) {
+            bool single = false;
+            for (int dx = -1; dx <= 1; dx++) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    int x = std::get<0>(field) + dx;
+                    int y = std::get<1>(field) + dy;
+                    if (mfield.isPosValid(x, y) && mfield.isOpen(x, y)) {
+                        int closed = 0;
+                        int mines = 0;
+                        for (int nx = x - 1; nx <= x + 1; nx++) {
+                            for (int ny = y - 1; ny <= y + 1; ny++) {
+                                if (mfield.isPosValid(nx, ny) && ! mfield.isOpen(nx, ny)) {
+                                    closed++;
+                                    mines += solver.isMine(nx, ny);
+                                }
+                            }
+                        }
+                        single |= mines == mfield.getSorroundingMineCount(x, y) && 0 < closed;
+                    }
+                }
+            }
+            subset_only += ! single;
+        }
+    }
+    CHECK(0 < subset_only);
+}